@@ -3,13 +3,17 @@ import random
 import enum
 import socket
 
-CURRENT_REQUEST_VERSION = 1
-MAX_REQUEST_DATA_SIZE = 32
-MAX_PACKET_SIZE = 48
+CURRENT_REQUEST_VERSION = 2
+MAX_PACKET_SIZE = 65507
+MAX_REQUEST_DATA_SIZE = MAX_PACKET_SIZE - 16
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ReadMemoryBatch = 3,
+    WriteMemoryBatch = 4,
+    SubscribeMemory = 5,
+    UnsubscribeMemory = 6
 
 CITRA_PORT = 45987
 
@@ -25,6 +29,20 @@ class Citra:
         request_id = random.getrandbits(32)
         return (struct.pack("IIII", CURRENT_REQUEST_VERSION, request_id, request_type, data_size), request_id)
 
+    def _send_request(self, request_type, request_data):
+        request, request_id = self._generate_header(request_type, len(request_data))
+        self.socket.sendto(request + request_data, (self.address, CITRA_PORT))
+        return request_id
+
+    def _split_reply(self, reply_data, ranges):
+        if reply_data is None or len(reply_data) != sum(size for _, size in ranges):
+            return None
+        result = []
+        for _, size in ranges:
+            result.append(reply_data[:size])
+            reply_data = reply_data[size:]
+        return result
+
     def _read_and_validate_header(self, raw_reply, expected_id, expected_type):
         reply_version, reply_id, reply_type, reply_data_size = struct.unpack("IIII", raw_reply[:4*4])
         if (CURRENT_REQUEST_VERSION == reply_version and
@@ -90,6 +108,61 @@ class Citra:
                 return False
         return True
 
+    def read_memory_batch(self, ranges):
+        """
+        Reads several (address, size) ranges at once, all from the same emulated frame.
+
+        >>> c.read_memory_batch([(0x100000, 2), (0x100002, 2)])
+        [b'\\x07\\x00', b'\\x00\\xeb']
+        """
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        request_id = self._send_request(RequestType.ReadMemoryBatch, request_data)
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemoryBatch)
+        return self._split_reply(reply_data, ranges)
+
+    def write_memory_batch(self, writes):
+        """
+        Writes several (address, contents) pairs at once, all between the same two emulated frames.
+
+        >>> c.write_memory_batch([(0x100000, b"\\x07\\x00\\x00\\xeb")])
+        True
+        """
+        request_data = b"".join(struct.pack("II", address, len(contents)) + contents
+                                for address, contents in writes)
+        request_id = self._send_request(RequestType.WriteMemoryBatch, request_data)
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.WriteMemoryBatch)
+        return None != reply_data
+
+    def subscribe_memory(self, ranges):
+        """
+        Asks for the contents of several (address, size) ranges at every emulated frame. Returns the
+        subscription id, to pass to receive_subscription and unsubscribe_memory.
+        """
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        return self._send_request(RequestType.SubscribeMemory, request_data)
+
+    def receive_subscription(self, subscription_id, ranges):
+        """
+        Waits for the next frame of a subscription, returning the contents of its ranges.
+        """
+        while True:
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            reply_data = self._read_and_validate_header(raw_reply, subscription_id,
+                                                        RequestType.SubscribeMemory)
+            if reply_data is not None:
+                return self._split_reply(reply_data, ranges)
+
+    def unsubscribe_memory(self, subscription_id):
+        """
+        Stops a subscription. Replies to it that were already sent may still be received.
+        """
+        request_data = struct.pack("I", subscription_id)
+        self._send_request(RequestType.UnsubscribeMemory, request_data)
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
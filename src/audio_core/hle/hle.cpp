@@ -28,6 +28,7 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -429,7 +430,10 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
     return output_frame;
 }
 
+MICROPROFILE_DEFINE(Audio_DSP_HLE, "Audio", "DSP HLE", MP_RGB(255, 192, 0));
+
 bool DspHle::Impl::Tick() {
+    MICROPROFILE_SCOPE(Audio_DSP_HLE);
     StereoFrame16 current_frame = {};
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
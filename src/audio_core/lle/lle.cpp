@@ -9,6 +9,7 @@
 #include "audio_core/lle/lle.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
+#include "common/microprofile.h"
 #include "common/swap.h"
 #include "common/thread.h"
 #include "core/core.h"
@@ -16,6 +17,8 @@
 #include "core/hle/lock.h"
 #include "core/hle/service/dsp/dsp_dsp.h"
 
+MICROPROFILE_DEFINE(Audio_DSP_LLE, "Audio", "DSP LLE", MP_RGB(255, 160, 0));
+
 namespace AudioCore {
 
 enum class SegmentType : u8 {
@@ -178,6 +181,7 @@ struct DspLle::Impl final {
     }
 
     void TeakraSliceEvent(u64 late) {
+        MICROPROFILE_SCOPE(Audio_DSP_LLE);
         RunTeakraSlice();
         u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
         if (next < late)
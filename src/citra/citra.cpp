@@ -2,11 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 
 // This needs to be included before getopt.h because the latter #defines symbols used by it
 #include "common/microprofile.h"
@@ -27,10 +30,12 @@
 #include "common/logging/backend.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
+#include "common/logging/text_formatter.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/dumping/backend.h"
 #include "core/file_sys/cia_container.h"
 #include "core/frontend/applets/default_applets.h"
@@ -68,6 +73,11 @@ static void PrintHelp(const char* argv0) {
                  "-r, --movie-record=[file]  Record a movie (game inputs) to the given file\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
+                 "-b, --benchmark=FRAMES     Run FRAMES frames hidden and unthrottled, then print\n"
+                 "                           per-subsystem timings as JSON\n"
+                 "-t, --profile-trace=FILE   Write the profiled scopes of the last frames to FILE\n"
+                 "                           in the Chrome trace format on exit\n"
+                 "-l, --decode-log=FILE      Print a binary log written with log_binary as text\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
@@ -169,21 +179,142 @@ static void OnStatusMessageReceived(const Network::StatusMessageEntry& msg) {
         std::cout << std::endl << "* " << message << std::endl << std::endl;
 }
 
+/// Makes MicroProfile accumulate every timer over the whole run, even without a profiler UI
+static void EnableBenchmarkProfiling() {
+    Common::EnableMicroProfileRecording();
+#if MICROPROFILE_ENABLED
+    MicroProfileSetAggregateFrames(0);
+#endif
+}
+
+/// Formats the MicroProfile timers accumulated since EnableBenchmarkProfiling as a JSON object
+static std::string GetBenchmarkProfileJson() {
+    std::string json = "{";
+#if MICROPROFILE_ENABLED
+    std::lock_guard lock{MicroProfileGetMutex()};
+    const MicroProfile& profile = *MicroProfileGet();
+    const float ticks_to_ms = MicroProfileTickToMsMultiplier(MicroProfileTicksPerSecondCpu());
+
+    bool first_group = true;
+    for (u32 group = 0; group < profile.nGroupCount; ++group) {
+        json += fmt::format("{}\n    \"{}\": {{\"total_ms\": {:.3f}, \"timers\": {{",
+                            first_group ? "" : ",", profile.GroupInfo[group].pName,
+                            profile.AggregateGroup[group] * ticks_to_ms);
+        first_group = false;
+
+        bool first_timer = true;
+        for (u32 timer = 0; timer < profile.nTotalTimers; ++timer) {
+            if (profile.TimerToGroup[timer] != group) {
+                continue;
+            }
+            json += fmt::format("{}\"{}\": {{\"total_ms\": {:.3f}, \"calls\": {}}}",
+                                first_timer ? "" : ", ", profile.TimerInfo[timer].pName,
+                                profile.Aggregate[timer].nTicks * ticks_to_ms,
+                                profile.Aggregate[timer].nCount);
+            first_timer = false;
+        }
+        json += "}}";
+    }
+    json += "\n  ";
+#endif
+    return json + "}";
+}
+
+/// Number of HLE service commands included in the benchmark results
+constexpr std::size_t BenchmarkServiceCommands = 20;
+
+/// Formats the HLE service commands that took the most host time as a JSON array
+static std::string GetBenchmarkServicesJson(const Service::CallStats& call_stats) {
+    const std::vector<Service::CallStats::CommandResults> results = call_stats.GetResults();
+    std::string json = "[";
+    for (std::size_t i = 0; i < std::min(BenchmarkServiceCommands, results.size()); ++i) {
+        const Service::CallStats::CommandResults& result = results[i];
+        const double total_ms = result.total_time.count() / 1000000.0;
+        std::string histogram;
+        for (const u64 count : result.histogram) {
+            histogram += fmt::format("{}{}", histogram.empty() ? "" : ", ", count);
+        }
+        json += fmt::format("{}\n    {{\"service\": \"{}\", \"function\": \"{}\", "
+                            "\"header\": \"0x{:08X}\", \"calls\": {}, \"total_ms\": {:.3f}, "
+                            "\"mean_us\": {:.2f}, \"p99_us\": {}, \"max_us\": {:.2f}, "
+                            "\"histogram\": [{}]}}",
+                            i == 0 ? "" : ",", result.service_name, result.function_name,
+                            result.header_code, result.calls, total_ms,
+                            total_ms * 1000.0 / result.calls, result.GetPercentile(99).count(),
+                            result.max_time.count() / 1000.0, histogram);
+    }
+    if (!results.empty()) {
+        json += "\n  ";
+    }
+    return json + "]";
+}
+
+/**
+ * Runs the loaded title for a fixed number of emulated frames as fast as possible and prints the
+ * results to stdout as JSON.
+ */
+static void RunBenchmark(Core::System& system, EmuWindow_SDL2& emu_window, int frames) {
+    using Clock = std::chrono::steady_clock;
+
+    system.ServiceCallStats().Reset();
+    const int start_frame = system.Renderer().GetCurrentFrame();
+    const auto start_emulated_time = system.CoreTiming().GetGlobalTimeUs();
+    const auto start_time = Clock::now();
+
+    int frames_run = 0;
+    while (emu_window.IsOpen() && frames_run < frames) {
+        if (system.RunLoop() != Core::System::ResultStatus::Success) {
+            LOG_ERROR(Frontend, "Emulation stopped after {} frames", frames_run);
+            break;
+        }
+        frames_run = system.Renderer().GetCurrentFrame() - start_frame;
+    }
+
+    const double wall_time_ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - start_time).count();
+    const double emulated_time_ms =
+        std::chrono::duration<double, std::milli>(system.CoreTiming().GetGlobalTimeUs() -
+                                                  start_emulated_time)
+            .count();
+    emu_window.Close();
+
+    std::cout << fmt::format("{{\n  \"frames\": {},\n  \"wall_time_ms\": {:.3f},\n"
+                             "  \"emulated_time_ms\": {:.3f},\n  \"fps\": {:.3f},\n"
+                             "  \"emulation_speed\": {:.4f},\n  \"subsystems\": {},\n"
+                             "  \"services\": {}\n}}",
+                             frames_run, wall_time_ms, emulated_time_ms,
+                             frames_run * 1000.0 / wall_time_ms, emulated_time_ms / wall_time_ms,
+                             GetBenchmarkProfileJson(),
+                             GetBenchmarkServicesJson(system.ServiceCallStats()))
+              << std::endl;
+}
+
 static void InitializeLogging() {
     Log::Filter log_filter(Log::Level::Debug);
     log_filter.ParseFilterString(Settings::values.log_filter);
     Log::SetGlobalFilter(log_filter);
 
     Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
-
-    const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
-    FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
 }
 
+/**
+ * Adds the backends writing to the log file. This waits until the command line is parsed, as
+ * opening the log file moves the previous one aside, which --decode-log may be asked to read.
+ */
+static void AddLogFileBackend() {
+    const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
+    FileUtil::CreateFullPath(log_dir);
+    if (Settings::values.log_binary) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+        Log::SetDeferredFormatting(true);
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
+}
+
 /// Application entry point
 int main(int argc, char** argv) {
     Common::DetachedTasks detached_tasks;
@@ -194,6 +325,8 @@ int main(int argc, char** argv) {
     std::string movie_record;
     std::string movie_play;
     std::string dump_video;
+    std::string profile_trace;
+    int benchmark_frames = 0;
 
     InitializeLogging();
 
@@ -221,11 +354,13 @@ int main(int argc, char** argv) {
         {"multiplayer", required_argument, 0, 'm'}, {"movie-record", required_argument, 0, 'r'},
         {"movie-play", required_argument, 0, 'p'},  {"dump-video", required_argument, 0, 'd'},
         {"fullscreen", no_argument, 0, 'f'},        {"help", no_argument, 0, 'h'},
-        {"version", no_argument, 0, 'v'},           {0, 0, 0, 0},
+        {"version", no_argument, 0, 'v'},           {"benchmark", required_argument, 0, 'b'},
+        {"profile-trace", required_argument, 0, 't'}, {"decode-log", required_argument, 0, 'l'},
+        {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:i:m:r:p:fhv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:i:m:r:p:b:t:l:fhv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -291,6 +426,27 @@ int main(int argc, char** argv) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 'b':
+                errno = 0;
+                benchmark_frames = static_cast<int>(strtol(optarg, &endarg, 0));
+                if (endarg == optarg || benchmark_frames <= 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--benchmark");
+                    exit(1);
+                }
+                break;
+            case 't':
+                profile_trace = optarg;
+                break;
+            case 'l':
+                if (!Log::DecodeBinaryLog(optarg, [](const Log::Entry& entry) {
+                        std::cout << Log::FormatLogMessage(entry) << '\n';
+                    })) {
+                    std::cout << "Could not decode " << optarg << " completely" << std::endl;
+                    return 1;
+                }
+                return 0;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -312,6 +468,8 @@ int main(int argc, char** argv) {
         }
     }
 
+    AddLogFileBackend();
+
 #ifdef _WIN32
     LocalFree(argv_w);
 #endif
@@ -339,6 +497,18 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (benchmark_frames != 0) {
+        // Measure emulation alone: render in software without frame limiting or audio output.
+        // The null renderer keeps its own rasterizer setting, drawing nothing by default.
+        if (Settings::values.graphics_api != Settings::GraphicsAPI::Null) {
+            Settings::values.use_hw_renderer = false;
+        }
+        Settings::values.use_frame_limit_alternate = false;
+        Settings::values.frame_limit = 0;
+        Settings::values.use_vsync_new = false;
+        Settings::values.sink_id = "null";
+        Settings::values.enable_audio_stretching = false;
+    }
     Settings::Apply();
 
     // Register frontend applets
@@ -347,7 +517,8 @@ int main(int argc, char** argv) {
     // Register generic image interface
     Core::System::GetInstance().RegisterImageInterface(std::make_shared<LodePNGImageInterface>());
 
-    std::unique_ptr<EmuWindow_SDL2> emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen)};
+    std::unique_ptr<EmuWindow_SDL2> emu_window{
+        std::make_unique<EmuWindow_SDL2>(fullscreen, benchmark_frames != 0)};
     Frontend::ScopeAcquireContext scope(*emu_window);
     Core::System& system{Core::System::GetInstance()};
 
@@ -421,11 +592,27 @@ int main(int argc, char** argv) {
                       total);
         });
 
-    while (emu_window->IsOpen()) {
-        system.RunLoop();
+    if (!profile_trace.empty()) {
+        Common::EnableMicroProfileRecording();
+    }
+    if (benchmark_frames != 0) {
+        EnableBenchmarkProfiling();
+        RunBenchmark(system, *emu_window, benchmark_frames);
+    } else {
+        while (emu_window->IsOpen()) {
+            system.RunLoop();
+        }
     }
     render_thread.join();
 
+    if (!profile_trace.empty()) {
+        if (Common::WriteMicroProfileTrace(profile_trace)) {
+            LOG_INFO(Frontend, "Wrote profile trace to {}", profile_trace);
+        } else {
+            LOG_ERROR(Frontend, "Could not write profile trace to {}", profile_trace);
+        }
+    }
+
     Core::Movie::GetInstance().Shutdown();
     if (system.VideoDumper().IsDumping()) {
         system.VideoDumper().StopDumping();
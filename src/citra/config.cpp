@@ -108,6 +108,8 @@ void Config::ReadValues() {
         sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100);
 
     // Renderer
+    Settings::values.graphics_api =
+        static_cast<Settings::GraphicsAPI>(sdl2_config->GetInteger("Renderer", "graphics_api", 0));
     Settings::values.use_gles = sdl2_config->GetBoolean("Renderer", "use_gles", false);
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
     Settings::values.use_hw_shader = sdl2_config->GetBoolean("Renderer", "use_hw_shader", true);
@@ -125,6 +127,8 @@ void Config::ReadValues() {
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
+    Settings::values.async_shader_compilation =
+        sdl2_config->GetBoolean("Renderer", "async_shader_compilation", false);
     Settings::values.frame_limit =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100));
     Settings::values.use_frame_limit_alternate =
@@ -201,6 +205,7 @@ void Config::ReadValues() {
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.async_fs_io = sdl2_config->GetBoolean("Data Storage", "async_fs_io", false);
 
     // System
     Settings::values.is_new_3ds = sdl2_config->GetBoolean("System", "is_new_3ds", true);
@@ -252,10 +257,13 @@ void Config::ReadValues() {
 
     // Miscellaneous
     Settings::values.log_filter = sdl2_config->GetString("Miscellaneous", "log_filter", "*:Info");
+    Settings::values.log_binary = sdl2_config->GetBoolean("Miscellaneous", "log_binary", false);
 
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    Settings::values.log_service_stats =
+        sdl2_config->GetBoolean("Debugging", "log_service_stats", false);
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
@@ -292,6 +300,14 @@ void Config::ReadValues() {
         sdl2_config->GetString("Video Dumping", "video_encoder_options", default_video_options);
     Settings::values.video_bitrate =
         sdl2_config->GetInteger("Video Dumping", "video_bitrate", 2500000);
+    Settings::values.video_encoder_threads = static_cast<u32>(
+        sdl2_config->GetInteger("Video Dumping", "video_encoder_threads", 0));
+    Settings::values.video_conversion_threads = static_cast<u32>(
+        sdl2_config->GetInteger("Video Dumping", "video_conversion_threads", 2));
+    Settings::values.video_frame_queue_size = static_cast<u32>(
+        sdl2_config->GetInteger("Video Dumping", "video_frame_queue_size", 8));
+    Settings::values.drop_video_frames =
+        sdl2_config->GetBoolean("Video Dumping", "drop_video_frames", false);
 
     Settings::values.audio_encoder =
         sdl2_config->GetString("Video Dumping", "audio_encoder", "libvorbis");
@@ -98,6 +98,11 @@ use_cpu_jit =
 cpu_clock_percentage =
 
 [Renderer]
+# Which renderer to use. The null renderer keeps guest-visible GPU state correct but draws and
+# presents nothing, for headless runs. With use_hw_renderer = 0 it still rasterizes into memory.
+# 0 (default): OpenGL, 1: Null
+graphics_api =
+
 # Whether to render using GLES or OpenGL
 # 0 (default): OpenGL, 1: GLES
 use_gles =
@@ -131,6 +136,11 @@ use_vsync_new =
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
 
+# Compiles new shaders on background threads, skipping the draws that use them until they are ready.
+# Requires separable shaders.
+# 0 (default): Off, 1: On
+async_shader_compilation =
+
 # Resolution scale factor
 # 0: Auto (scales resolution to window size), 1: Native 3DS screen resolution, Otherwise a scale
 # factor for the 3DS resolution
@@ -250,6 +260,11 @@ volume =
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Whether to perform file reads and writes on a background thread.
+# Timing then depends on the host, so this is ignored while a movie is recorded or played back.
+# 0 (default): No, 1: Yes
+async_fs_io =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS, 1: New 3DS (default)
@@ -295,9 +310,17 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Writes the log in a compact binary format to citra_log.bin instead of citra_log.txt, and formats
+# log messages on the logging thread instead of the thread that logs them.
+# Decode the log with `citra --decode-log=citra_log.bin`.
+# 0 (default): Off, 1: On
+log_binary =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
+# Periodically log the HLE service commands that took the most host time. Boolean value
+log_service_stats =
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
@@ -331,6 +354,19 @@ video_encoder_options =
 # Video bitrate, default: 2500000
 video_bitrate =
 
+# Number of threads used by the video encoder. 0 (default): Chosen by the encoder
+video_encoder_threads =
+
+# Number of threads converting frames to the pixel format of the video encoder, default: 2
+video_conversion_threads =
+
+# Number of frames that can wait to be converted or encoded, default: 8
+video_frame_queue_size =
+
+# What to do when the frame queue is full
+# 0 (default): Wait for a frame to be encoded, 1: Drop the new frame
+drop_video_frames =
+
 # Audio encoder used, default: libvorbis
 audio_encoder =
 
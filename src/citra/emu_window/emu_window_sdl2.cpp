@@ -105,6 +105,10 @@ bool EmuWindow_SDL2::IsOpen() const {
     return is_open;
 }
 
+void EmuWindow_SDL2::Close() {
+    is_open = false;
+}
+
 void EmuWindow_SDL2::OnResize() {
     int width, height;
     SDL_GetWindowSize(render_window, &width, &height);
@@ -132,9 +136,12 @@ void EmuWindow_SDL2::Fullscreen() {
     SDL_MaximizeWindow(render_window);
 }
 
-EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
+EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool hidden) : hidden(hidden) {
+    // The null renderer presents nothing, so it needs neither a window nor a GL context
+    const bool use_window = Settings::values.graphics_api != Settings::GraphicsAPI::Null;
+
     // Initialize the window
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK) < 0) {
+    if (SDL_Init((use_window ? SDL_INIT_VIDEO : SDL_INIT_EVENTS) | SDL_INIT_JOYSTICK) < 0) {
         LOG_CRITICAL(Frontend, "Failed to initialize SDL2! Exiting...");
         exit(1);
     }
@@ -144,6 +151,15 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
 
     SDL_SetMainReady();
 
+    if (!use_window) {
+        UpdateCurrentFramebufferLayout(Core::kScreenTopWidth,
+                                       Core::kScreenTopHeight + Core::kScreenBottomHeight);
+        LOG_INFO(Frontend, "Citra Version: {} | {}-{}", Common::g_build_fullname,
+                 Common::g_scm_branch, Common::g_scm_desc);
+        Settings::LogSettings();
+        return;
+    }
+
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
     if (Settings::values.use_gles) {
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 2);
@@ -164,12 +180,16 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
 
     std::string window_title = fmt::format("Citra {} | {}-{}", Common::g_build_fullname,
                                            Common::g_scm_branch, Common::g_scm_desc);
+    u32 window_flags = SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI;
+    if (hidden) {
+        window_flags |= SDL_WINDOW_HIDDEN;
+    }
     render_window =
         SDL_CreateWindow(window_title.c_str(),
                          SDL_WINDOWPOS_UNDEFINED, // x position
                          SDL_WINDOWPOS_UNDEFINED, // y position
                          Core::kScreenTopWidth, Core::kScreenTopHeight + Core::kScreenBottomHeight,
-                         SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+                         window_flags);
 
     if (render_window == nullptr) {
         LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
@@ -179,7 +199,7 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
     dummy_window = SDL_CreateWindow(NULL, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 0, 0,
                                     SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
 
-    if (fullscreen) {
+    if (fullscreen && !hidden) {
         Fullscreen();
     }
 
@@ -214,7 +234,9 @@ EmuWindow_SDL2::~EmuWindow_SDL2() {
     core_context.reset();
     Network::Shutdown();
     InputCommon::Shutdown();
-    SDL_GL_DeleteContext(window_context);
+    if (window_context) {
+        SDL_GL_DeleteContext(window_context);
+    }
     SDL_Quit();
 }
 
@@ -223,8 +245,11 @@ std::unique_ptr<Frontend::GraphicsContext> EmuWindow_SDL2::CreateSharedContext()
 }
 
 void EmuWindow_SDL2::Present() {
+    if (!render_window) {
+        return;
+    }
     SDL_GL_MakeCurrent(render_window, window_context);
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(hidden ? 0 : 1);
     while (IsOpen()) {
         VideoCore::g_renderer->TryPresent(100);
         SDL_GL_SwapWindow(render_window);
@@ -287,7 +312,7 @@ void EmuWindow_SDL2::PollEvents() {
     }
 
     const u32 current_time = SDL_GetTicks();
-    if (current_time > last_time + 2000) {
+    if (render_window && current_time > last_time + 2000) {
         const auto results = Core::System::GetInstance().GetAndResetPerfStats();
         const auto title =
             fmt::format("Citra {} | {}-{} | FPS: {:.0f} ({:.0f}%)", Common::g_build_fullname,
@@ -299,13 +324,20 @@ void EmuWindow_SDL2::PollEvents() {
 }
 
 void EmuWindow_SDL2::MakeCurrent() {
-    core_context->MakeCurrent();
+    if (core_context) {
+        core_context->MakeCurrent();
+    }
 }
 
 void EmuWindow_SDL2::DoneCurrent() {
-    core_context->DoneCurrent();
+    if (core_context) {
+        core_context->DoneCurrent();
+    }
 }
 
 void EmuWindow_SDL2::OnMinimalClientAreaChangeRequest(std::pair<u32, u32> minimal_size) {
+    if (!render_window) {
+        return;
+    }
     SDL_SetWindowMinimumSize(render_window, minimal_size.first, minimal_size.second);
 }
@@ -29,7 +29,11 @@ private:
 
 class EmuWindow_SDL2 : public Frontend::EmuWindow {
 public:
-    explicit EmuWindow_SDL2(bool fullscreen);
+    /**
+     * @param fullscreen Whether to start in fullscreen mode
+     * @param hidden Whether to keep the window hidden, e.g. when running benchmarks unattended
+     */
+    explicit EmuWindow_SDL2(bool fullscreen, bool hidden = false);
     ~EmuWindow_SDL2();
 
     void Present();
@@ -46,6 +50,9 @@ public:
     /// Whether the window is still open, and a close request hasn't yet been sent
     bool IsOpen() const;
 
+    /// Closes the window, ending the presentation loop
+    void Close();
+
     /// Creates a new context that is shared with the current context
     std::unique_ptr<GraphicsContext> CreateSharedContext() const override;
 
@@ -83,16 +90,19 @@ private:
     /// Is the window still open?
     bool is_open = true;
 
-    /// Internal SDL2 render window
-    SDL_Window* render_window;
+    /// Whether the window is hidden, in which case presentation is not synchronized to v-sync
+    bool hidden = false;
+
+    /// Internal SDL2 render window, null when the null renderer is used
+    SDL_Window* render_window = nullptr;
 
     /// Fake hidden window for the core context
-    SDL_Window* dummy_window;
+    SDL_Window* dummy_window = nullptr;
 
     using SDL_GLContext = void*;
 
     /// The OpenGL context associated with the window
-    SDL_GLContext window_context;
+    SDL_GLContext window_context = nullptr;
 
     /// The OpenGL context associated with the core
     std::unique_ptr<Frontend::GraphicsContext> core_context;
@@ -21,6 +21,7 @@
 #include "core/3ds.h"
 #include "core/core.h"
 #include "core/frontend/scope_acquire_context.h"
+#include "core/rpc/rpc_server.h"
 #include "core/settings.h"
 #include "input_common/keyboard.h"
 #include "input_common/main.h"
@@ -64,6 +65,7 @@ void EmuThread::run() {
             if (!was_active)
                 emit DebugModeLeft();
 
+            Core::System::GetInstance().RPCServer().SetEmulationRunning(true);
             Core::System::ResultStatus result = Core::System::GetInstance().RunLoop();
             if (result == Core::System::ResultStatus::ShutdownRequested) {
                 // Notify frontend we shutdown
@@ -90,6 +92,9 @@ void EmuThread::run() {
 
             was_active = false;
         } else {
+            // No frame is coming, so RPC requests waiting for one are answered right away
+            Core::System::GetInstance().RPCServer().SetEmulationRunning(false);
+
             std::unique_lock lock{running_mutex};
             running_cv.wait(lock, [this] { return IsRunning() || exec_step || stop_run; });
         }
@@ -302,6 +302,7 @@ void Config::ReadDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     Settings::values.use_virtual_sd = ReadSetting(QStringLiteral("use_virtual_sd"), true).toBool();
+    Settings::values.async_fs_io = ReadSetting(QStringLiteral("async_fs_io"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -312,6 +313,8 @@ void Config::ReadDebuggingValues() {
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     Settings::values.record_frame_times =
         qt_config->value(QStringLiteral("record_frame_times"), false).toBool();
+    Settings::values.log_service_stats =
+        ReadSetting(QStringLiteral("log_service_stats"), false).toBool();
     Settings::values.use_gdbstub = ReadSetting(QStringLiteral("use_gdbstub"), false).toBool();
     Settings::values.gdbstub_port = ReadSetting(QStringLiteral("gdbstub_port"), 24689).toInt();
 
@@ -369,6 +372,7 @@ void Config::ReadMiscellaneousValues() {
         ReadSetting(QStringLiteral("log_filter"), QStringLiteral("*:Info"))
             .toString()
             .toStdString();
+    Settings::values.log_binary = ReadSetting(QStringLiteral("log_binary"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -480,6 +484,8 @@ void Config::ReadRendererValues() {
     Settings::values.use_shader_jit = ReadSetting(QStringLiteral("use_shader_jit"), true).toBool();
     Settings::values.use_disk_shader_cache =
         ReadSetting(QStringLiteral("use_disk_shader_cache"), true).toBool();
+    Settings::values.async_shader_compilation =
+        ReadSetting(QStringLiteral("async_shader_compilation"), false).toBool();
     Settings::values.use_vsync_new = ReadSetting(QStringLiteral("use_vsync_new"), true).toBool();
     Settings::values.resolution_factor =
         static_cast<u16>(ReadSetting(QStringLiteral("resolution_factor"), 1).toInt());
@@ -563,6 +569,14 @@ void Config::ReadVideoDumpingValues() {
 
     Settings::values.video_bitrate =
         ReadSetting(QStringLiteral("video_bitrate"), 2500000).toULongLong();
+    Settings::values.video_encoder_threads =
+        ReadSetting(QStringLiteral("video_encoder_threads"), 0).toUInt();
+    Settings::values.video_conversion_threads =
+        ReadSetting(QStringLiteral("video_conversion_threads"), 2).toUInt();
+    Settings::values.video_frame_queue_size =
+        ReadSetting(QStringLiteral("video_frame_queue_size"), 8).toUInt();
+    Settings::values.drop_video_frames =
+        ReadSetting(QStringLiteral("drop_video_frames"), false).toBool();
 
     Settings::values.audio_encoder =
         ReadSetting(QStringLiteral("audio_encoder"), QStringLiteral("libvorbis"))
@@ -852,6 +866,7 @@ void Config::SaveDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     WriteSetting(QStringLiteral("use_virtual_sd"), Settings::values.use_virtual_sd, true);
+    WriteSetting(QStringLiteral("async_fs_io"), Settings::values.async_fs_io, false);
 
     qt_config->endGroup();
 }
@@ -861,6 +876,7 @@ void Config::SaveDebuggingValues() {
 
     // Intentionally not using the QT default setting as this is intended to be changed in the ini
     qt_config->setValue(QStringLiteral("record_frame_times"), Settings::values.record_frame_times);
+    WriteSetting(QStringLiteral("log_service_stats"), Settings::values.log_service_stats, false);
     WriteSetting(QStringLiteral("use_gdbstub"), Settings::values.use_gdbstub, false);
     WriteSetting(QStringLiteral("gdbstub_port"), Settings::values.gdbstub_port, 24689);
 
@@ -906,6 +922,7 @@ void Config::SaveMiscellaneousValues() {
 
     WriteSetting(QStringLiteral("log_filter"), QString::fromStdString(Settings::values.log_filter),
                  QStringLiteral("*:Info"));
+    WriteSetting(QStringLiteral("log_binary"), Settings::values.log_binary, false);
 
     qt_config->endGroup();
 }
@@ -983,6 +1000,8 @@ void Config::SaveRendererValues() {
     WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit, true);
     WriteSetting(QStringLiteral("use_disk_shader_cache"), Settings::values.use_disk_shader_cache,
                  true);
+    WriteSetting(QStringLiteral("async_shader_compilation"),
+                 Settings::values.async_shader_compilation, false);
     WriteSetting(QStringLiteral("use_vsync_new"), Settings::values.use_vsync_new, true);
     WriteSetting(QStringLiteral("resolution_factor"), Settings::values.resolution_factor, 1);
     WriteSetting(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
@@ -1051,6 +1070,13 @@ void Config::SaveVideoDumpingValues() {
                  DEFAULT_VIDEO_ENCODER_OPTIONS);
     WriteSetting(QStringLiteral("video_bitrate"),
                  static_cast<unsigned long long>(Settings::values.video_bitrate), 2500000);
+    WriteSetting(QStringLiteral("video_encoder_threads"), Settings::values.video_encoder_threads,
+                 0);
+    WriteSetting(QStringLiteral("video_conversion_threads"),
+                 Settings::values.video_conversion_threads, 2);
+    WriteSetting(QStringLiteral("video_frame_queue_size"), Settings::values.video_frame_queue_size,
+                 8);
+    WriteSetting(QStringLiteral("drop_video_frames"), Settings::values.drop_video_frames, false);
     WriteSetting(QStringLiteral("audio_encoder"),
                  QString::fromStdString(Settings::values.audio_encoder),
                  QStringLiteral("libvorbis"));
@@ -74,6 +74,7 @@ void ConfigureGraphics::SetConfiguration() {
     ui->toggle_accurate_mul->setChecked(Settings::values.shaders_accurate_mul);
     ui->toggle_shader_jit->setChecked(Settings::values.use_shader_jit);
     ui->toggle_disk_shader_cache->setChecked(Settings::values.use_disk_shader_cache);
+    ui->toggle_async_shader_compilation->setChecked(Settings::values.async_shader_compilation);
     ui->toggle_vsync_new->setChecked(Settings::values.use_vsync_new);
 }
 
@@ -84,6 +85,7 @@ void ConfigureGraphics::ApplyConfiguration() {
     Settings::values.shaders_accurate_mul = ui->toggle_accurate_mul->isChecked();
     Settings::values.use_shader_jit = ui->toggle_shader_jit->isChecked();
     Settings::values.use_disk_shader_cache = ui->toggle_disk_shader_cache->isChecked();
+    Settings::values.async_shader_compilation = ui->toggle_async_shader_compilation->isChecked();
     Settings::values.use_vsync_new = ui->toggle_vsync_new->isChecked();
 }
 
@@ -15,9 +15,9 @@
 #include "citra_qt/uisettings.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
-#include "core/hle/service/am/am.h"
-#include "core/hle/service/fs/archive.h"
+#include "core/loader/game_scanner.h"
 #include "core/loader/loader.h"
+#include "core/loader/smdh.h"
 
 namespace {
 bool HasSupportedFileExtension(const std::string& file_name) {
@@ -28,15 +28,16 @@ bool HasSupportedFileExtension(const std::string& file_name) {
 
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
                                const CompatibilityList& compatibility_list)
-    : game_dirs(game_dirs), compatibility_list(compatibility_list) {}
+    : game_dirs(game_dirs), compatibility_list(compatibility_list),
+      scanner(FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list.bin") {}
 
 GameListWorker::~GameListWorker() = default;
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir) {
-    const auto callback = [this, recursion, parent_dir](u64* num_entries_out,
-                                                        const std::string& directory,
-                                                        const std::string& virtual_name) -> bool {
+void GameListWorker::CollectGamePaths(const std::string& dir_path, unsigned int recursion,
+                                      std::vector<std::string>& paths) {
+    const auto callback = [this, recursion, &paths](u64* num_entries_out,
+                                                    const std::string& directory,
+                                                    const std::string& virtual_name) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
@@ -45,69 +46,10 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
-
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
-
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
-
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
-
-            if (!Loader::IsValidSMDH(smdh) && UISettings::values.game_list_hide_no_icon) {
-                // Skip this invalid entry
-                return true;
-            }
-
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
+            paths.push_back(physical_name);
         } else if (is_dir && recursion > 0) {
             watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
+            CollectGamePaths(physical_name, recursion - 1, paths);
         }
 
         return true;
@@ -116,6 +58,38 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
     FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
 }
 
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir) {
+    std::vector<std::string> paths;
+    CollectGamePaths(dir_path, recursion, paths);
+
+    scanner.Scan(paths, [this, parent_dir](const Loader::GameEntry& entry) {
+        if (!Loader::IsValidSMDH(entry.smdh) && UISettings::values.game_list_hide_no_icon) {
+            // Skip this invalid entry
+            return;
+        }
+
+        auto it = FindMatchingCompatibilityEntry(compatibility_list, entry.program_id);
+
+        // The game list uses this as compatibility number for untested games
+        QString compatibility(QStringLiteral("99"));
+        if (it != compatibility_list.end())
+            compatibility = it->second.first;
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(entry.path), entry.smdh,
+                                     entry.program_id, entry.extdata_id),
+                new GameListItemCompat(compatibility),
+                new GameListItemRegion(entry.smdh),
+                new GameListItem(
+                    QString::fromStdString(Loader::GetFileTypeString(entry.file_type))),
+                new GameListItemSize(entry.size),
+            },
+            parent_dir);
+    });
+}
+
 void GameListWorker::run() {
     stop_processing = false;
     for (UISettings::GameDir& game_dir : game_dirs) {
@@ -154,10 +128,15 @@ void GameListWorker::run() {
         }
     }
 
+    if (!stop_processing) {
+        scanner.SaveCache();
+    }
+
     emit Finished(watch_list);
 }
 
 void GameListWorker::Cancel() {
     this->disconnect();
     stop_processing = true;
+    scanner.Cancel();
 }
@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -16,6 +17,7 @@
 #include <QVector>
 #include "citra_qt/compatibility_list.h"
 #include "common/common_types.h"
+#include "core/loader/game_scanner.h"
 
 class QStandardItem;
 
@@ -53,6 +55,9 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// Collects the paths of the files with supported extensions, adding directories to watch_list
+    void CollectGamePaths(const std::string& dir_path, unsigned int recursion,
+                          std::vector<std::string>& paths);
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
 
@@ -61,4 +66,6 @@ private:
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
+
+    Loader::GameScanner scanner;
 };
@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <clocale>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <thread>
 #include <QDesktopWidget>
@@ -142,7 +144,12 @@ static void InitializeLogging() {
 
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.log_binary) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+        Log::SetDeferredFormatting(true);
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -744,6 +751,7 @@ void GMainWindow::ConnectMenuEvents() {
     connect(ui->action_Play_Movie, &QAction::triggered, this, &GMainWindow::OnPlayMovie);
     connect(ui->action_Stop_Recording_Playback, &QAction::triggered, this,
             &GMainWindow::OnStopRecordingPlayback);
+    connect(ui->action_Seek_Movie, &QAction::triggered, this, &GMainWindow::OnSeekMovie);
     connect(ui->action_Enable_Frame_Advancing, &QAction::triggered, this, [this] {
         if (emulation_running) {
             Core::System::GetInstance().frame_limiter.SetFrameAdvancing(
@@ -1865,6 +1873,7 @@ void GMainWindow::OnRecordMovie() {
     ui->action_Record_Movie->setEnabled(false);
     ui->action_Play_Movie->setEnabled(false);
     ui->action_Stop_Recording_Playback->setEnabled(true);
+    ui->action_Seek_Movie->setEnabled(true);
 }
 
 bool GMainWindow::ValidateMovie(const QString& path, u64 program_id) {
@@ -1959,6 +1968,7 @@ void GMainWindow::OnPlayMovie() {
     ui->action_Record_Movie->setEnabled(false);
     ui->action_Play_Movie->setEnabled(false);
     ui->action_Stop_Recording_Playback->setEnabled(true);
+    ui->action_Seek_Movie->setEnabled(true);
 }
 
 void GMainWindow::OnStopRecordingPlayback() {
@@ -1977,6 +1987,33 @@ void GMainWindow::OnStopRecordingPlayback() {
     ui->action_Record_Movie->setEnabled(true);
     ui->action_Play_Movie->setEnabled(true);
     ui->action_Stop_Recording_Playback->setEnabled(false);
+    ui->action_Seek_Movie->setEnabled(false);
+}
+
+void GMainWindow::OnSeekMovie() {
+    auto& movie = Core::Movie::GetInstance();
+    if (!movie.IsPlayingInput() && !movie.IsRecordingInput()) {
+        QMessageBox::information(this, tr("Seek Movie"),
+                                 tr("Seeking is possible once the movie has started."));
+        return;
+    }
+
+    const int frame_count =
+        static_cast<int>(std::min<u64>(movie.GetFrameCount(), std::numeric_limits<int>::max()));
+    const QString label =
+        movie.IsRecordingInput()
+            ? tr("Emulation pauses at this frame, from which recording continues. Input recorded "
+                 "after this frame is discarded.")
+            : tr("Emulation pauses at this frame, from which playback continues.");
+    bool ok = false;
+    const int frame =
+        QInputDialog::getInt(this, tr("Seek to Frame"), label,
+                             static_cast<int>(std::min<u64>(movie.GetCurrentFrame(), frame_count)),
+                             0, frame_count, 1, &ok);
+    if (ok) {
+        movie.SeekToFrame(static_cast<u64>(frame),
+                          [this] { QMetaObject::invokeMethod(this, "OnMovieSeekCompleted"); });
+    }
 }
 
 void GMainWindow::OnCaptureScreenshot() {
@@ -2343,11 +2380,18 @@ void GMainWindow::OnLanguageChanged(const QString& locale) {
         ui->action_Start->setText(tr("Continue"));
 }
 
+void GMainWindow::OnMovieSeekCompleted() {
+    // The movie enabled frame advancing to pause at the frame sought to
+    ui->action_Enable_Frame_Advancing->setChecked(true);
+    ui->action_Advance_Frame->setEnabled(true);
+}
+
 void GMainWindow::OnMoviePlaybackCompleted() {
     QMessageBox::information(this, tr("Playback Completed"), tr("Movie playback completed."));
     ui->action_Record_Movie->setEnabled(true);
     ui->action_Play_Movie->setEnabled(true);
     ui->action_Stop_Recording_Playback->setEnabled(false);
+    ui->action_Seek_Movie->setEnabled(false);
 }
 
 void GMainWindow::UpdateWindowTitle() {
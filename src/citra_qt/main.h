@@ -209,6 +209,7 @@ private slots:
     void OnRecordMovie();
     void OnPlayMovie();
     void OnStopRecordingPlayback();
+    void OnSeekMovie();
     void OnCaptureScreenshot();
 #ifdef ENABLE_FFMPEG_VIDEO_DUMPER
     void OnStartVideoDumping();
@@ -226,6 +227,7 @@ private slots:
 private:
     bool ValidateMovie(const QString& path, u64 program_id = 0);
     Q_INVOKABLE void OnMoviePlaybackCompleted();
+    Q_INVOKABLE void OnMovieSeekCompleted();
     void UpdateStatusBar();
     void LoadTranslation();
     void UpdateWindowTitle();
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -43,7 +44,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -344,6 +347,21 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+u64 GetModificationTime(const std::string& filename) {
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<u64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -1045,4 +1063,116 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::string& filename) : filename(filename) {
+    Open();
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    Swap(other);
+    return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(filename, other.filename);
+}
+
+bool MappedFile::Open() {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(Common::UTF8ToUTF16W(filename).c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(Common_Filesystem, "Failed to open {}: {}", filename, GetLastErrorMsg());
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The view keeps a reference to the mapping object, which in turn keeps the file open
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to create mapping of {}: {}", filename,
+                  GetLastErrorMsg());
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}: {}", filename, GetLastErrorMsg());
+        return false;
+    }
+    m_size = static_cast<u64>(file_size.QuadPart);
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        LOG_ERROR(Common_Filesystem, "Failed to open {}: {}", filename, GetLastErrorMsg());
+        return false;
+    }
+
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || file_info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* view = mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}: {}", filename, GetLastErrorMsg());
+        return false;
+    }
+    m_size = static_cast<u64>(file_info.st_size);
+#endif
+
+    m_data = static_cast<const u8*>(view);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<u8*>(m_data), static_cast<std::size_t>(m_size));
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+std::size_t MappedFile::ReadBytes(u64 offset, void* dest, std::size_t length) const {
+    if (!IsOpen() || offset >= m_size) {
+        return 0;
+    }
+
+    length = static_cast<std::size_t>(std::min<u64>(length, m_size - offset));
+    std::memcpy(dest, m_data + offset, length);
+    return length;
+}
+
 } // namespace FileUtil
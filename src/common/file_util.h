@@ -105,6 +105,9 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, or 0 on failure
+[[nodiscard]] u64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -376,6 +379,61 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * A read-only memory mapping of a whole file. Reading through the mapping is served straight from
+ * the host page cache, which avoids a syscall and an intermediate buffer per read and lets several
+ * processes share the same physical pages.
+ */
+class MappedFile : public NonCopyable {
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& filename);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    void Swap(MappedFile& other) noexcept;
+
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const {
+        return nullptr != m_data;
+    }
+
+    [[nodiscard]] const u8* GetData() const {
+        return m_data;
+    }
+
+    [[nodiscard]] u64 GetSize() const {
+        return m_size;
+    }
+
+    /**
+     * Copies data out of the mapping.
+     * @return The number of bytes copied, which is less than length when reading past the end.
+     */
+    std::size_t ReadBytes(u64 offset, void* dest, std::size_t length) const;
+
+private:
+    bool Open();
+
+    const u8* m_data = nullptr;
+    u64 m_size = 0;
+
+    std::string filename;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& Path::make(filename);
+        if (Archive::is_loading::value) {
+            Open();
+        }
+    }
+    friend class boost::serialization::access;
+};
+
 } // namespace FileUtil
 
 // To deal with Windows being dumb at unicode:
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <regex>
@@ -17,6 +18,7 @@
 #else
 #define _SH_DENYWR 0
 #endif
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
@@ -26,6 +28,116 @@
 
 namespace Log {
 
+/// Time between two collections of the messages in the log buffers of every thread
+constexpr std::chrono::milliseconds DeferredMessageInterval{10};
+
+/// Size of the log buffer of each thread
+constexpr std::size_t LogRingSize = 512 * 1024;
+
+/// Format string of messages that were formatted by the logging call
+constexpr char FormattedMessageFormat[] = "{}";
+
+/// Header of a message in a log buffer, followed by its captured arguments
+struct DeferredRecord {
+    u32 size; ///< Size of the record including its arguments, or RingPaddingMarker
+    u8 log_class;
+    u8 log_level;
+    u8 num_args;
+    u32 line_num;
+    u32 args_size;
+    s64 timestamp;
+    const char* filename;
+    const char* function;
+    const char* format;
+};
+
+/// Record size telling the reader to continue at the start of the buffer
+constexpr u32 RingPaddingMarker = 0xFFFFFFFF;
+
+/**
+ * Single producer, single consumer buffer of variable sized records. Each record is contiguous,
+ * so records that do not fit at the end of the buffer start again at its beginning.
+ */
+class LogRing {
+public:
+    LogRing() : buffer(std::make_unique<u8[]>(LogRingSize)) {}
+
+    /// Returns space for a record of the given size, or nullptr if the buffer is full
+    u8* Reserve(std::size_t size) {
+        size = Common::AlignUp(size, alignof(DeferredRecord));
+        if (size > LogRingSize / 2) {
+            return nullptr;
+        }
+
+        const u64 write = write_pos.load(std::memory_order_relaxed);
+        const u64 read = read_pos.load(std::memory_order_acquire);
+        const std::size_t offset = write % LogRingSize;
+        const std::size_t skip = LogRingSize - offset < size ? LogRingSize - offset : 0;
+        if (write + skip + size - read > LogRingSize) {
+            return nullptr;
+        }
+        if (skip != 0) {
+            std::memcpy(buffer.get() + offset, &RingPaddingMarker, sizeof(u32));
+        }
+
+        reserved_size = skip + size;
+        return buffer.get() + (write + skip) % LogRingSize;
+    }
+
+    /// Makes the last reserved record visible to the consumer
+    void Commit() {
+        write_pos.store(write_pos.load(std::memory_order_relaxed) + reserved_size,
+                        std::memory_order_release);
+    }
+
+    /// Calls the function with every record written since the last call
+    template <typename Func>
+    void Consume(Func&& func) {
+        u64 read = read_pos.load(std::memory_order_relaxed);
+        const u64 write = write_pos.load(std::memory_order_acquire);
+        while (read != write) {
+            const std::size_t offset = read % LogRingSize;
+            DeferredRecord record;
+            std::memcpy(&record.size, buffer.get() + offset, sizeof(u32));
+            if (record.size == RingPaddingMarker) {
+                read += LogRingSize - offset;
+                continue;
+            }
+            std::memcpy(&record, buffer.get() + offset, sizeof(record));
+            func(record, buffer.get() + offset + sizeof(record));
+            read += record.size;
+        }
+        read_pos.store(read, std::memory_order_release);
+    }
+
+    bool IsEmpty() const {
+        return read_pos.load(std::memory_order_acquire) ==
+               write_pos.load(std::memory_order_acquire);
+    }
+
+    /// Set once the thread owning the buffer has exited
+    std::atomic_bool retired{false};
+
+private:
+    std::unique_ptr<u8[]> buffer;
+    std::atomic<u64> write_pos{0};
+    std::atomic<u64> read_pos{0};
+    std::size_t reserved_size = 0;
+};
+
+/// Log buffer of the calling thread, retired when the thread exits
+struct ThreadLogRing {
+    std::shared_ptr<LogRing> ring;
+
+    ~ThreadLogRing() {
+        if (ring) {
+            ring->retired = true;
+        }
+    }
+};
+
+static thread_local ThreadLogRing thread_log_ring;
+
 /**
  * Static state as a singleton.
  */
@@ -45,6 +157,49 @@ public:
             CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
     }
 
+    u8* ReserveDeferredMessage(Class log_class, Level log_level, const char* filename,
+                               unsigned int line_num, const char* function, const char* format,
+                               std::size_t num_args, std::size_t args_size) {
+        if (!deferred_formatting.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        auto& ring = thread_log_ring.ring;
+        if (!ring) {
+            ring = std::make_shared<LogRing>();
+            std::lock_guard lock{rings_mutex};
+            rings.push_back(ring);
+        }
+
+        u8* const data = ring->Reserve(sizeof(DeferredRecord) + args_size);
+        if (data == nullptr) {
+            return nullptr;
+        }
+
+        using std::chrono::duration_cast;
+        using std::chrono::steady_clock;
+
+        DeferredRecord record;
+        record.size = static_cast<u32>(
+            Common::AlignUp(sizeof(DeferredRecord) + args_size, alignof(DeferredRecord)));
+        record.log_class = static_cast<u8>(log_class);
+        record.log_level = static_cast<u8>(log_level);
+        record.num_args = static_cast<u8>(num_args);
+        record.line_num = line_num;
+        record.args_size = static_cast<u32>(args_size);
+        record.timestamp =
+            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin).count();
+        record.filename = filename;
+        record.function = function;
+        record.format = format;
+        std::memcpy(data, &record, sizeof(record));
+        return data + sizeof(record);
+    }
+
+    void CommitDeferredMessage() {
+        thread_log_ring.ring->Commit();
+    }
+
     void AddBackend(std::unique_ptr<Backend> backend) {
         std::lock_guard lock{writing_mutex};
         backends.push_back(std::move(backend));
@@ -66,6 +221,17 @@ public:
         filter = f;
     }
 
+    bool IsDeferredFormattingEnabled() const {
+        return deferred_formatting.load(std::memory_order_relaxed);
+    }
+
+    void SetDeferredFormatting(bool enabled) {
+        deferred_formatting = enabled;
+        // Also wakes up the logging thread, which only starts polling the log buffers afterwards
+        PushEntry(Class::Log, Level::Info, TrimSourcePath(__FILE__), __LINE__, __func__,
+                  enabled ? "Deferred formatting enabled" : "Deferred formatting disabled");
+    }
+
     Backend* GetBackend(std::string_view backend_name) {
         const auto it =
             std::find_if(backends.begin(), backends.end(),
@@ -86,13 +252,24 @@ private:
                 }
             };
             while (true) {
-                entry = message_queue.PopWait();
+                // Deferred messages are collected periodically, so that logging them never has to
+                // wake up this thread.
+                if (deferred_formatting || HasLogRings()) {
+                    WriteDeferredMessages();
+                    if (!message_queue.PopWaitFor(entry, DeferredMessageInterval)) {
+                        continue;
+                    }
+                } else {
+                    entry = message_queue.PopWait();
+                }
                 if (entry.final_entry) {
                     break;
                 }
                 write_logs(entry);
             }
 
+            WriteDeferredMessages();
+
             // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
             // where a system is repeatedly spamming logs even on close.
             constexpr int MAX_LOGS_TO_WRITE = 100;
@@ -128,14 +305,92 @@ private:
         return entry;
     }
 
+    bool HasLogRings() {
+        std::lock_guard lock{rings_mutex};
+        return !rings.empty();
+    }
+
+    /// Writes the messages in the log buffers of every thread, in the order they were logged
+    void WriteDeferredMessages() {
+        std::vector<std::shared_ptr<LogRing>> current_rings;
+        {
+            std::lock_guard lock{rings_mutex};
+            current_rings = rings;
+        }
+
+        deferred_data.clear();
+        deferred_records.clear();
+        for (const auto& ring : current_rings) {
+            ring->Consume([this](const DeferredRecord& record, const u8* args) {
+                deferred_records.push_back({record, deferred_data.size()});
+                deferred_data.insert(deferred_data.end(), args, args + record.args_size);
+            });
+        }
+
+        {
+            std::lock_guard lock{rings_mutex};
+            rings.erase(std::remove_if(rings.begin(), rings.end(),
+                                       [](const auto& ring) {
+                                           return ring->retired && ring->IsEmpty();
+                                       }),
+                        rings.end());
+        }
+
+        if (deferred_records.empty()) {
+            return;
+        }
+        std::stable_sort(deferred_records.begin(), deferred_records.end(),
+                         [](const auto& a, const auto& b) {
+                             return a.first.timestamp < b.first.timestamp;
+                         });
+
+        std::lock_guard lock{writing_mutex};
+        for (const auto& [record, args_offset] : deferred_records) {
+            DeferredEntry entry{std::chrono::microseconds{record.timestamp},
+                                static_cast<Class>(record.log_class),
+                                static_cast<Level>(record.log_level),
+                                record.filename,
+                                record.line_num,
+                                record.function,
+                                record.format,
+                                record.num_args,
+                                deferred_data.data() + args_offset,
+                                record.args_size,
+                                std::nullopt};
+            for (const auto& backend : backends) {
+                backend->WriteDeferred(entry);
+            }
+        }
+    }
+
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
     Common::MPSCQueue<Log::Entry> message_queue;
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+
+    std::atomic_bool deferred_formatting{false};
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::vector<std::pair<DeferredRecord, std::size_t>> deferred_records;
+    std::vector<u8> deferred_data;
 };
 
+const Entry& DeferredEntry::GetEntry() const {
+    if (!formatted_entry) {
+        Entry& entry = formatted_entry.emplace();
+        entry.timestamp = timestamp;
+        entry.log_class = log_class;
+        entry.log_level = log_level;
+        entry.filename = filename;
+        entry.line_num = line_num;
+        entry.function = function;
+        entry.message = FormatDeferredMessage(format, num_args, args, args_size);
+    }
+    return *formatted_entry;
+}
+
 void ConsoleBackend::Write(const Entry& entry) {
     PrintMessage(entry);
 }
@@ -170,6 +425,104 @@ void FileBackend::Write(const Entry& entry) {
     }
 }
 
+/// Identifies a binary log file, "CTLB"
+constexpr u32 BinaryLogMagic = 0x424C5443;
+constexpr u32 BinaryLogVersion = 1;
+
+/**
+ * Kinds of records in a binary log. All values are stored in host byte order, and strings as a u32
+ * length followed by their characters.
+ */
+enum class BinaryLogRecord : u8 {
+    /// Defines a static string: u32 id, string
+    String,
+    /// A message captured with deferred formatting: s64 timestamp, u8 class, u8 level, u32 line,
+    /// u32 filename id, u32 function id, u32 format id, u8 argument count, u32 arguments size,
+    /// arguments
+    DeferredMessage,
+    /// A formatted message: s64 timestamp, u8 class, u8 level, u32 line, filename string,
+    /// function string, message string
+    Message,
+};
+
+template <typename T>
+static void AppendValue(std::vector<u8>& buffer, const T& value) {
+    const auto* const bytes = reinterpret_cast<const u8*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+static void AppendString(std::vector<u8>& buffer, std::string_view str) {
+    AppendValue(buffer, static_cast<u32>(str.size()));
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+BinaryFileBackend::BinaryFileBackend(const std::string& filename) {
+    if (FileUtil::Exists(filename + ".old")) {
+        FileUtil::Delete(filename + ".old");
+    }
+    if (FileUtil::Exists(filename)) {
+        FileUtil::Rename(filename, filename + ".old");
+    }
+
+    file = FileUtil::IOFile(filename, "wb", _SH_DENYWR);
+    AppendValue(buffer, BinaryLogMagic);
+    AppendValue(buffer, BinaryLogVersion);
+    Flush(Level::Critical);
+}
+
+void BinaryFileBackend::Write(const Entry& entry) {
+    buffer.push_back(static_cast<u8>(BinaryLogRecord::Message));
+    AppendValue(buffer, static_cast<s64>(entry.timestamp.count()));
+    AppendValue(buffer, static_cast<u8>(entry.log_class));
+    AppendValue(buffer, static_cast<u8>(entry.log_level));
+    AppendValue(buffer, static_cast<u32>(entry.line_num));
+    AppendString(buffer, entry.filename);
+    AppendString(buffer, entry.function);
+    AppendString(buffer, entry.message);
+    Flush(entry.log_level);
+}
+
+void BinaryFileBackend::WriteDeferred(const DeferredEntry& entry) {
+    const u32 filename_id = GetStringId(entry.filename);
+    const u32 function_id = GetStringId(entry.function);
+    const u32 format_id = GetStringId(entry.format);
+
+    buffer.push_back(static_cast<u8>(BinaryLogRecord::DeferredMessage));
+    AppendValue(buffer, static_cast<s64>(entry.timestamp.count()));
+    AppendValue(buffer, static_cast<u8>(entry.log_class));
+    AppendValue(buffer, static_cast<u8>(entry.log_level));
+    AppendValue(buffer, static_cast<u32>(entry.line_num));
+    AppendValue(buffer, filename_id);
+    AppendValue(buffer, function_id);
+    AppendValue(buffer, format_id);
+    AppendValue(buffer, static_cast<u8>(entry.num_args));
+    AppendValue(buffer, static_cast<u32>(entry.args_size));
+    buffer.insert(buffer.end(), entry.args, entry.args + entry.args_size);
+    Flush(entry.log_level);
+}
+
+u32 BinaryFileBackend::GetStringId(const char* str) {
+    const auto [it, inserted] = string_ids.try_emplace(str, static_cast<u32>(string_ids.size()));
+    if (inserted) {
+        buffer.push_back(static_cast<u8>(BinaryLogRecord::String));
+        AppendValue(buffer, it->second);
+        AppendString(buffer, str);
+    }
+    return it->second;
+}
+
+void BinaryFileBackend::Flush(Level log_level) {
+    // Same limit as the text log, which holds several times more messages in this format
+    constexpr std::size_t MAX_BYTES_WRITTEN = 50 * 1024L * 1024L;
+    if (file.IsOpen() && bytes_written <= MAX_BYTES_WRITTEN) {
+        bytes_written += file.WriteBytes(buffer.data(), buffer.size());
+        if (log_level >= Level::Error) {
+            file.Flush();
+        }
+    }
+    buffer.clear();
+}
+
 void DebuggerBackend::Write(const Entry& entry) {
 #ifdef _WIN32
     ::OutputDebugStringW(Common::UTF8ToUTF16W(FormatLogMessage(entry).append(1, '\n')).c_str());
@@ -299,6 +652,151 @@ Backend* GetBackend(std::string_view backend_name) {
     return Impl::Instance().GetBackend(backend_name);
 }
 
+bool IsDeferredFormattingEnabled() {
+    return Impl::Instance().IsDeferredFormattingEnabled();
+}
+
+void SetDeferredFormatting(bool enabled) {
+    Impl::Instance().SetDeferredFormatting(enabled);
+}
+
+namespace {
+
+/// Reads the values of a binary log, failing once it runs out of data
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(std::string_view data) : data(data) {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data.size() - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(std::size_t size, const u8*& bytes) {
+        if (data.size() - position < size) {
+            return false;
+        }
+        bytes = reinterpret_cast<const u8*>(data.data() + position);
+        position += size;
+        return true;
+    }
+
+    bool ReadString(std::string& str) {
+        u32 length;
+        const u8* bytes;
+        if (!Read(length) || !ReadBytes(length, bytes)) {
+            return false;
+        }
+        str.assign(reinterpret_cast<const char*>(bytes), length);
+        return true;
+    }
+
+    bool AtEnd() const {
+        return position == data.size();
+    }
+
+private:
+    std::string_view data;
+    std::size_t position = 0;
+};
+
+} // Anonymous namespace
+
+bool DecodeBinaryLog(const std::string& filename,
+                     const std::function<void(const Entry&)>& callback) {
+    std::string data;
+    if (FileUtil::ReadFileToString(false, filename, data) == 0) {
+        return false;
+    }
+
+    BinaryLogReader reader(data);
+    u32 magic, version;
+    if (!reader.Read(magic) || !reader.Read(version) || magic != BinaryLogMagic ||
+        version != BinaryLogVersion) {
+        return false;
+    }
+
+    std::vector<std::string> strings;
+    const auto get_string = [&strings](u32 id) -> const std::string* {
+        return id < strings.size() ? &strings[id] : nullptr;
+    };
+
+    std::string filename_str;
+    Entry entry;
+    while (!reader.AtEnd()) {
+        u8 kind;
+        if (!reader.Read(kind)) {
+            return false;
+        }
+
+        switch (static_cast<BinaryLogRecord>(kind)) {
+        case BinaryLogRecord::String: {
+            u32 id;
+            std::string str;
+            if (!reader.Read(id) || !reader.ReadString(str)) {
+                return false;
+            }
+            if (id >= strings.size()) {
+                strings.resize(id + 1);
+            }
+            strings[id] = std::move(str);
+            continue;
+        }
+        case BinaryLogRecord::DeferredMessage:
+        case BinaryLogRecord::Message:
+            break;
+        default:
+            return false;
+        }
+
+        s64 timestamp;
+        u8 log_class, log_level;
+        u32 line_num;
+        if (!reader.Read(timestamp) || !reader.Read(log_class) || !reader.Read(log_level) ||
+            !reader.Read(line_num) || log_class >= static_cast<u8>(Class::Count) ||
+            log_level >= static_cast<u8>(Level::Count)) {
+            return false;
+        }
+        entry.timestamp = std::chrono::microseconds{timestamp};
+        entry.log_class = static_cast<Class>(log_class);
+        entry.log_level = static_cast<Level>(log_level);
+        entry.line_num = line_num;
+
+        if (static_cast<BinaryLogRecord>(kind) == BinaryLogRecord::Message) {
+            if (!reader.ReadString(filename_str) || !reader.ReadString(entry.function) ||
+                !reader.ReadString(entry.message)) {
+                return false;
+            }
+            entry.filename = filename_str.c_str();
+        } else {
+            u32 filename_id, function_id, format_id, args_size;
+            u8 num_args;
+            const u8* args;
+            if (!reader.Read(filename_id) || !reader.Read(function_id) ||
+                !reader.Read(format_id) || !reader.Read(num_args) || !reader.Read(args_size) ||
+                !reader.ReadBytes(args_size, args)) {
+                return false;
+            }
+            const std::string* filename_ptr = get_string(filename_id);
+            const std::string* function = get_string(function_id);
+            const std::string* format = get_string(format_id);
+            if (filename_ptr == nullptr || function == nullptr || format == nullptr) {
+                return false;
+            }
+            entry.filename = filename_ptr->c_str();
+            entry.function = *function;
+            entry.message = FormatDeferredMessage(format->c_str(), num_args, args, args_size);
+        }
+        callback(entry);
+    }
+    return true;
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -310,4 +808,41 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
     instance.PushEntry(log_class, log_level, filename, line_num, function,
                        fmt::vformat(format, args));
 }
+
+void FmtLogStaticMessageImpl(Class log_class, Level log_level, const char* filename,
+                             unsigned int line_num, const char* function, const char* format,
+                             const fmt::format_args& args) {
+    auto& instance = Impl::Instance();
+    const auto& filter = instance.GetGlobalFilter();
+    if (!filter.CheckMessage(log_class, log_level))
+        return;
+
+    std::string message = fmt::vformat(format, args);
+    if (instance.IsDeferredFormattingEnabled()) {
+        u8* const data =
+            instance.ReserveDeferredMessage(log_class, log_level, filename, line_num, function,
+                                            FormattedMessageFormat, 1, GetEncodedArgSize(message));
+        if (data != nullptr) {
+            EncodeDeferredArg(data, message);
+            instance.CommitDeferredMessage();
+            return;
+        }
+    }
+    instance.PushEntry(log_class, log_level, filename, line_num, function, std::move(message));
+}
+
+u8* ReserveDeferredMessage(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, const char* format,
+                           std::size_t num_args, std::size_t args_size) {
+    auto& instance = Impl::Instance();
+    if (!instance.GetGlobalFilter().CheckMessage(log_class, log_level))
+        return nullptr;
+
+    return instance.ReserveDeferredMessage(log_class, log_level, filename, line_num, function,
+                                           format, num_args, args_size);
+}
+
+void CommitDeferredMessage() {
+    Impl::Instance().CommitDeferredMessage();
+}
 } // namespace Log
@@ -5,9 +5,13 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "common/file_util.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
@@ -37,6 +41,29 @@ struct Entry {
     Entry& operator=(const Entry& o) = default;
 };
 
+/**
+ * A log entry whose arguments were captured by the thread that logged it instead of formatting
+ * them. The strings it points to have static storage duration, while its arguments are only valid
+ * while it is being written.
+ */
+struct DeferredEntry {
+    std::chrono::microseconds timestamp;
+    Class log_class;
+    Level log_level;
+    const char* filename;
+    unsigned int line_num;
+    const char* function;
+    const char* format;
+    std::size_t num_args;
+    const u8* args;
+    std::size_t args_size;
+
+    /// Formats the message into a regular entry. The result is kept for the other backends.
+    const Entry& GetEntry() const;
+
+    mutable std::optional<Entry> formatted_entry;
+};
+
 /**
  * Interface for logging backends. As loggers can be created and removed at runtime, this can be
  * used by a frontend for adding a custom logging backend as needed
@@ -49,6 +76,9 @@ public:
     }
     virtual const char* GetName() const = 0;
     virtual void Write(const Entry& entry) = 0;
+    virtual void WriteDeferred(const DeferredEntry& entry) {
+        Write(entry.GetEntry());
+    }
 
 private:
     Filter filter;
@@ -105,6 +135,37 @@ private:
     std::size_t bytes_written;
 };
 
+/**
+ * Backend that writes to a file in a compact binary format. Messages captured with deferred
+ * formatting are stored without formatting them, and are formatted by DecodeBinaryLog instead.
+ */
+class BinaryFileBackend : public Backend {
+public:
+    explicit BinaryFileBackend(const std::string& filename);
+
+    static const char* Name() {
+        return "binary_file";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    void Write(const Entry& entry) override;
+    void WriteDeferred(const DeferredEntry& entry) override;
+
+private:
+    /// Returns the id of a static string, defining it in the file the first time it is seen
+    u32 GetStringId(const char* str);
+
+    void Flush(Level log_level);
+
+    FileUtil::IOFile file;
+    std::size_t bytes_written = 0;
+    std::vector<u8> buffer;
+    std::unordered_map<const char*, u32> string_ids;
+};
+
 /**
  * Backend that writes to Visual Studio's output window
  */
@@ -142,4 +203,19 @@ const char* GetLevelName(Level log_level);
  * never get the message
  */
 void SetGlobalFilter(const Filter& filter);
+
+/**
+ * When enabled, the LOG_* macros copy the arguments of a message into a buffer of the calling
+ * thread, and the message is formatted on the logging thread when it is written.
+ */
+void SetDeferredFormatting(bool enabled);
+
+/**
+ * Reads a log written by BinaryFileBackend.
+ * @param filename Path of the binary log.
+ * @param callback Function called with every entry of the log, in order.
+ * @returns false if the file could not be read or is malformed.
+ */
+bool DecodeBinaryLog(const std::string& filename,
+                     const std::function<void(const Entry&)>& callback);
 } // namespace Log
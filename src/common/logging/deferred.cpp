@@ -0,0 +1,167 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <fmt/format.h>
+#include "common/logging/deferred.h"
+
+namespace Log {
+namespace {
+
+/// An argument decoded from its captured bytes
+struct DeferredArg {
+    DeferredArgType type = DeferredArgType::Int;
+    union {
+        bool bool_value;
+        char char_value;
+        s64 int_value;
+        u64 uint_value;
+        float float_value;
+        double double_value;
+    };
+    std::string_view string_value;
+    /// Unset for the padding passed to fmt after the captured arguments
+    bool captured = false;
+
+    DeferredArg() : int_value(0) {}
+};
+
+template <typename T>
+bool ReadValue(const u8*& data, const u8* end, T& value) {
+    if (static_cast<std::size_t>(end - data) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+bool DecodeArg(const u8*& data, const u8* end, DeferredArg& arg) {
+    u8 type;
+    if (!ReadValue(data, end, type)) {
+        return false;
+    }
+    arg.type = static_cast<DeferredArgType>(type);
+    arg.captured = true;
+    switch (arg.type) {
+    case DeferredArgType::Bool: {
+        u8 value;
+        if (!ReadValue(data, end, value)) {
+            return false;
+        }
+        arg.bool_value = value != 0;
+        return true;
+    }
+    case DeferredArgType::Char:
+        return ReadValue(data, end, arg.char_value);
+    case DeferredArgType::Int:
+        return ReadValue(data, end, arg.int_value);
+    case DeferredArgType::UInt:
+    case DeferredArgType::Pointer:
+        return ReadValue(data, end, arg.uint_value);
+    case DeferredArgType::Float:
+        return ReadValue(data, end, arg.float_value);
+    case DeferredArgType::Double:
+        return ReadValue(data, end, arg.double_value);
+    case DeferredArgType::String: {
+        u32 length;
+        if (!ReadValue(data, end, length) || static_cast<std::size_t>(end - data) < length) {
+            return false;
+        }
+        arg.string_value = {reinterpret_cast<const char*>(data), length};
+        data += length;
+        return true;
+    }
+    }
+    return false;
+}
+
+} // Anonymous namespace
+} // namespace Log
+
+/**
+ * Formats a decoded argument as its original type. The format spec is only known once the
+ * argument type is, so it is kept as written and applied in format().
+ */
+template <>
+struct fmt::formatter<Log::DeferredArg> {
+    std::string spec;
+
+    template <typename ParseContext>
+    auto parse(ParseContext& ctx) {
+        auto end = ctx.begin();
+        while (end != ctx.end() && *end != '}') {
+            ++end;
+        }
+        spec = fmt::format("{{:{}}}", std::string_view(ctx.begin(), end - ctx.begin()));
+        return end;
+    }
+
+    template <typename FormatContext>
+    auto format(const Log::DeferredArg& arg, FormatContext& ctx) const {
+        using Log::DeferredArgType;
+        if (!arg.captured) {
+            throw fmt::format_error("argument not found");
+        }
+        std::string formatted;
+        switch (arg.type) {
+        case DeferredArgType::Bool:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.bool_value));
+            break;
+        case DeferredArgType::Char:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.char_value));
+            break;
+        case DeferredArgType::Int:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.int_value));
+            break;
+        case DeferredArgType::UInt:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.uint_value));
+            break;
+        case DeferredArgType::Float:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.float_value));
+            break;
+        case DeferredArgType::Double:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.double_value));
+            break;
+        case DeferredArgType::Pointer: {
+            const void* pointer = reinterpret_cast<const void*>(arg.uint_value);
+            formatted = fmt::vformat(spec, fmt::make_format_args(pointer));
+            break;
+        }
+        case DeferredArgType::String:
+            formatted = fmt::vformat(spec, fmt::make_format_args(arg.string_value));
+            break;
+        }
+        return std::copy(formatted.begin(), formatted.end(), ctx.out());
+    }
+};
+
+namespace Log {
+
+std::string FormatDeferredMessage(const char* format, std::size_t num_args, const u8* args,
+                                  std::size_t args_size) {
+    std::array<DeferredArg, MaxDeferredArgs> decoded{};
+    const u8* data = args;
+    const u8* const end = args + args_size;
+    if (num_args > decoded.size()) {
+        return fmt::format("<invalid log message> {}", format);
+    }
+    for (std::size_t i = 0; i < num_args; ++i) {
+        if (!DecodeArg(data, end, decoded[i])) {
+            return fmt::format("<invalid log message> {}", format);
+        }
+    }
+
+    try {
+        return fmt::vformat(
+            format, fmt::make_format_args(decoded[0], decoded[1], decoded[2], decoded[3],
+                                          decoded[4], decoded[5], decoded[6], decoded[7],
+                                          decoded[8], decoded[9], decoded[10], decoded[11],
+                                          decoded[12], decoded[13], decoded[14], decoded[15]));
+    } catch (const fmt::format_error& error) {
+        return fmt::format("<log format error: {}> {}", error.what(), format);
+    }
+}
+
+} // namespace Log
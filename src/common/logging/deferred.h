@@ -0,0 +1,128 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Log {
+
+/// Maximum number of arguments a message can have to be formatted on the logging thread
+constexpr std::size_t MaxDeferredArgs = 16;
+
+/// Type tag that precedes each captured argument
+enum class DeferredArgType : u8 {
+    Bool,
+    Char,
+    Int,     ///< Any signed integer, stored as s64
+    UInt,    ///< Any unsigned integer, stored as u64
+    Float,   ///< Kept apart from double, as fmt prints floats with their own precision
+    Double,
+    Pointer, ///< Stored as u64
+    String,  ///< Stored as a u32 length followed by the characters
+};
+
+template <typename T>
+constexpr bool IsDeferrableArg() {
+    using U = std::decay_t<T>;
+    constexpr bool is_char = std::is_same_v<U, char> || std::is_same_v<U, wchar_t> ||
+                             std::is_same_v<U, char16_t> || std::is_same_v<U, char32_t>;
+    return std::is_same_v<U, bool> || std::is_same_v<U, char> ||
+           (std::is_integral_v<U> && !is_char) || std::is_same_v<U, float> ||
+           std::is_same_v<U, double> || std::is_same_v<U, const void*> ||
+           std::is_same_v<U, void*> || std::is_same_v<U, const char*> ||
+           std::is_same_v<U, char*> || std::is_same_v<U, std::string> ||
+           std::is_same_v<U, std::string_view>;
+}
+
+/**
+ * Whether a message with these argument types can be captured without formatting it. Other types
+ * (enums, types with custom formatters...) are formatted by the logging call as usual.
+ */
+template <typename... Args>
+constexpr bool AreDeferrableArgs() {
+    return sizeof...(Args) <= MaxDeferredArgs && (IsDeferrableArg<Args>() && ...);
+}
+
+namespace Detail {
+
+template <typename T>
+std::string_view ToStringView(const T& value) {
+    if constexpr (std::is_same_v<std::decay_t<T>, const char*> ||
+                  std::is_same_v<std::decay_t<T>, char*>) {
+        return value != nullptr ? std::string_view{value} : std::string_view{"(null)"};
+    } else {
+        return std::string_view{value};
+    }
+}
+
+template <typename T>
+u8* WriteValue(u8* data, DeferredArgType type, T value) {
+    *data = static_cast<u8>(type);
+    std::memcpy(data + 1, &value, sizeof(value));
+    return data + 1 + sizeof(value);
+}
+
+} // namespace Detail
+
+/// Number of bytes EncodeDeferredArg writes for an argument
+template <typename T>
+std::size_t GetEncodedArgSize(const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>) {
+        return 1 + sizeof(u8);
+    } else if constexpr (std::is_integral_v<U> || std::is_same_v<U, double> ||
+                         std::is_same_v<U, const void*> || std::is_same_v<U, void*>) {
+        return 1 + sizeof(u64);
+    } else if constexpr (std::is_same_v<U, float>) {
+        return 1 + sizeof(float);
+    } else {
+        return 1 + sizeof(u32) + Detail::ToStringView(value).size();
+    }
+}
+
+/// Writes a type tag and the value of an argument, returning the end of the written data
+template <typename T>
+u8* EncodeDeferredArg(u8* data, const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        return Detail::WriteValue(data, DeferredArgType::Bool, static_cast<u8>(value));
+    } else if constexpr (std::is_same_v<U, char>) {
+        return Detail::WriteValue(data, DeferredArgType::Char, value);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return Detail::WriteValue(data, DeferredArgType::Int, static_cast<s64>(value));
+    } else if constexpr (std::is_integral_v<U>) {
+        return Detail::WriteValue(data, DeferredArgType::UInt, static_cast<u64>(value));
+    } else if constexpr (std::is_same_v<U, float>) {
+        return Detail::WriteValue(data, DeferredArgType::Float, value);
+    } else if constexpr (std::is_same_v<U, double>) {
+        return Detail::WriteValue(data, DeferredArgType::Double, value);
+    } else if constexpr (std::is_same_v<U, const void*> || std::is_same_v<U, void*>) {
+        return Detail::WriteValue(data, DeferredArgType::Pointer,
+                                  static_cast<u64>(reinterpret_cast<uintptr_t>(value)));
+    } else {
+        const std::string_view str = Detail::ToStringView(value);
+        u8* const chars = Detail::WriteValue(data, DeferredArgType::String,
+                                             static_cast<u32>(str.size()));
+        std::memcpy(chars, str.data(), str.size());
+        return chars + str.size();
+    }
+}
+
+/**
+ * Formats a message from its format string and the arguments captured by EncodeDeferredArg.
+ * @param format Format string of the message.
+ * @param num_args Number of captured arguments.
+ * @param args Captured arguments.
+ * @param args_size Size of the captured arguments in bytes.
+ */
+std::string FormatDeferredMessage(const char* format, std::size_t num_args, const u8* args,
+                                  std::size_t args_size);
+
+} // namespace Log
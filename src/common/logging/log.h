@@ -6,6 +6,7 @@
 
 #include <fmt/format.h>
 #include "common/common_types.h"
+#include "common/logging/deferred.h"
 
 namespace Log {
 
@@ -125,33 +126,88 @@ void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsig
                       fmt::make_format_args(args...));
 }
 
+/**
+ * Logs a message whose filename, function and format strings have static storage duration, like
+ * the ones of the LOG_* macros. The message is formatted on the calling thread, but still goes
+ * through the thread's log buffer when deferred formatting is enabled, so that it stays in order
+ * with the deferred messages of that thread.
+ */
+void FmtLogStaticMessageImpl(Class log_class, Level log_level, const char* filename,
+                             unsigned int line_num, const char* function, const char* format,
+                             const fmt::format_args& args);
+
+/// Whether the LOG_* macros capture the arguments of messages instead of formatting them
+bool IsDeferredFormattingEnabled();
+
+/**
+ * Reserves space for a message in the calling thread's log buffer, to be formatted on the logging
+ * thread. Must be followed by a call to CommitDeferredMessage.
+ * @param num_args Number of arguments captured after the message.
+ * @param args_size Size of the captured arguments in bytes.
+ * @returns Where to write the captured arguments, or nullptr if the message is filtered out,
+ *          deferred formatting is disabled or the buffer is full.
+ */
+u8* ReserveDeferredMessage(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, const char* format,
+                           std::size_t num_args, std::size_t args_size);
+
+/// Makes the message reserved by ReserveDeferredMessage visible to the logging thread
+void CommitDeferredMessage();
+
+/// Logs a message from a LOG_* macro, capturing its arguments instead of formatting them if it can
+template <typename... Args>
+void FmtLogStaticMessage(Class log_class, Level log_level, const char* filename,
+                         unsigned int line_num, const char* function, const char* format,
+                         const Args&... args) {
+    if constexpr (AreDeferrableArgs<Args...>()) {
+        if (IsDeferredFormattingEnabled()) {
+            const std::size_t args_size = (GetEncodedArgSize(args) + ... + std::size_t{0});
+            u8* data = ReserveDeferredMessage(log_class, log_level, filename, line_num, function,
+                                              format, sizeof...(Args), args_size);
+            if (data != nullptr) {
+                ((data = EncodeDeferredArg(data, args)), ...);
+                CommitDeferredMessage();
+                return;
+            }
+        }
+    }
+    FmtLogStaticMessageImpl(log_class, log_level, filename, line_num, function, format,
+                            fmt::make_format_args(args...));
+}
+
 } // namespace Log
 
 // Define the fmt lib macros
 #define LOG_GENERIC(log_class, log_level, ...)                                                     \
-    ::Log::FmtLogMessage(log_class, log_level, ::Log::TrimSourcePath(__FILE__), __LINE__,          \
-                         __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(log_class, log_level, ::Log::TrimSourcePath(__FILE__), __LINE__,    \
+                               __func__, __VA_ARGS__)
 
 #ifdef _DEBUG
 #define LOG_TRACE(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Trace,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Trace,                       \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
 #else
 #define LOG_TRACE(log_class, fmt, ...) (void(0))
 #endif
 
 #define LOG_DEBUG(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Debug,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Debug,                       \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
 #define LOG_INFO(log_class, ...)                                                                   \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Info,                              \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Info,                        \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
 #define LOG_WARNING(log_class, ...)                                                                \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Warning,                           \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Warning,                     \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
 #define LOG_ERROR(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Error,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Error,                       \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
 #define LOG_CRITICAL(log_class, ...)                                                               \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Critical,                          \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogStaticMessage(::Log::Class::log_class, ::Log::Level::Critical,                    \
+                               ::Log::TrimSourcePath(__FILE__), __LINE__, __func__,                \
+                               __VA_ARGS__)
@@ -5,3 +5,181 @@
 // Includes the MicroProfile implementation in this file for compilation
 #define MICROPROFILE_IMPL 1
 #include "common/microprofile.h"
+
+#include <array>
+#include <iterator>
+#include <mutex>
+#include <vector>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Common {
+
+#if MICROPROFILE_ENABLED
+
+/// Size at which the trace being built is flushed to the file
+constexpr std::size_t TraceFlushSize = 1024 * 1024;
+
+/// Escapes the characters that cannot appear as-is inside a JSON string
+static std::string EscapeJson(const char* str) {
+    std::string escaped;
+    for (; *str != '\0'; ++str) {
+        const auto c = static_cast<unsigned char>(*str);
+        if (c < 0x20) {
+            escaped += fmt::format("\\u{:04x}", c);
+            continue;
+        }
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += *str;
+    }
+    return escaped;
+}
+
+void EnableMicroProfileRecording() {
+    MicroProfileSetForceEnable(true);
+    MicroProfileSetEnableAllGroups(true);
+}
+
+bool WriteMicroProfileTrace(const std::string& path) {
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    std::lock_guard lock{MicroProfileGetMutex()};
+    MicroProfile& profile = *MicroProfileGet();
+
+    // Stop threads from pushing new entries while their logs are read, like MicroProfileDumpHtml
+    const u32 running = profile.nRunning;
+    const u64 active_group = profile.nActiveGroup;
+    profile.nRunning = 0;
+    profile.nActiveGroup = 0;
+
+    const double ticks_to_us = 1000000.0 / MicroProfileTicksPerSecondCpu();
+    const float ticks_to_ms = MicroProfileTickToMsMultiplier(MicroProfileTicksPerSecondCpu());
+
+    // Frames past the current one are still being filled in by MicroProfileFlip
+    const u32 num_frames = MICROPROFILE_MAX_FRAME_HISTORY - MICROPROFILE_GPU_FRAME_DELAY - 3;
+    const u32 first_frame = (profile.nFrameCurrent + MICROPROFILE_MAX_FRAME_HISTORY - num_frames) %
+                            MICROPROFILE_MAX_FRAME_HISTORY;
+    const s64 start_tick = profile.Frames[first_frame].nFrameStartCpu;
+    const auto to_us = [&](s64 tick) { return (tick - start_tick) * ticks_to_us; };
+
+    std::string trace = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    auto out = std::back_inserter(trace);
+    bool ok = true;
+    const auto flush = [&] {
+        ok &= file.WriteString(trace) == trace.size();
+        trace.clear();
+    };
+
+    fmt::format_to(out, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                        "\"args\":{{\"name\":\"Citra\"}}}}");
+    for (u32 thread = 0; thread < profile.nNumLogs; ++thread) {
+        const MicroProfileThreadLog* log = profile.Pool[thread];
+        if (log != nullptr && !log->nGpu) {
+            fmt::format_to(out,
+                           ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                           "\"args\":{{\"name\":\"{}\"}}}}",
+                           thread, EscapeJson(log->ThreadName));
+        }
+    }
+
+    // Per thread nesting depth of every group, so that nested scopes of a group count only once
+    std::vector<std::array<u32, MICROPROFILE_MAX_GROUPS>> group_depth(profile.nNumLogs);
+    std::vector<std::array<s64, MICROPROFILE_MAX_GROUPS>> group_enter(profile.nNumLogs);
+    std::array<s64, MICROPROFILE_MAX_GROUPS> frame_group_ticks;
+
+    for (u32 i = 0; i < num_frames; ++i) {
+        const u32 frame = (first_frame + i) % MICROPROFILE_MAX_FRAME_HISTORY;
+        const u32 next_frame = (frame + 1) % MICROPROFILE_MAX_FRAME_HISTORY;
+        const MicroProfileFrameState& frame_state = profile.Frames[frame];
+        const MicroProfileFrameState& next_frame_state = profile.Frames[next_frame];
+        if (next_frame_state.nFrameStartCpu <= frame_state.nFrameStartCpu) {
+            // Not recorded yet, the history has not been filled since recording started
+            continue;
+        }
+        frame_group_ticks.fill(0);
+
+        for (u32 thread = 0; thread < profile.nNumLogs; ++thread) {
+            const MicroProfileThreadLog* log = profile.Pool[thread];
+            if (log == nullptr || log->nGpu) {
+                continue;
+            }
+
+            const u32 log_end = next_frame_state.nLogStart[thread];
+            for (u32 k = frame_state.nLogStart[thread]; k != log_end;
+                 k = (k + 1) % MICROPROFILE_BUFFER_SIZE) {
+                const MicroProfileLogEntry entry = log->Log[k];
+                const int type = MicroProfileLogType(entry);
+                if (type != MP_LOG_ENTER && type != MP_LOG_LEAVE) {
+                    continue;
+                }
+
+                const u64 timer = MicroProfileLogTimerIndex(entry);
+                const u32 group = profile.TimerToGroup[timer];
+                const s64 tick = frame_state.nFrameStartCpu +
+                                 MicroProfileLogTickDifference(
+                                     MicroProfileLogGetTick(frame_state.nFrameStartCpu), entry);
+                fmt::format_to(out,
+                               ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},"
+                               "\"pid\":1,\"tid\":{}}}",
+                               EscapeJson(profile.TimerInfo[timer].pName),
+                               EscapeJson(profile.GroupInfo[group].pName),
+                               type == MP_LOG_ENTER ? 'B' : 'E', to_us(tick), thread);
+
+                u32& depth = group_depth[thread][group];
+                if (type == MP_LOG_ENTER) {
+                    if (depth++ == 0) {
+                        group_enter[thread][group] = tick;
+                    }
+                } else if (depth != 0 && --depth == 0) {
+                    frame_group_ticks[group] += tick - group_enter[thread][group];
+                }
+            }
+        }
+
+        fmt::format_to(out,
+                       ",\n{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":1}}",
+                       to_us(frame_state.nFrameStartCpu));
+        fmt::format_to(out,
+                       ",\n{{\"name\":\"Group time (ms)\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,"
+                       "\"args\":{{\"Frame\":{:.3f}",
+                       to_us(frame_state.nFrameStartCpu),
+                       (next_frame_state.nFrameStartCpu - frame_state.nFrameStartCpu) *
+                           ticks_to_ms);
+        for (u32 group = 0; group < profile.nGroupCount; ++group) {
+            if (frame_group_ticks[group] != 0) {
+                fmt::format_to(out, ",\"{}\":{:.3f}", EscapeJson(profile.GroupInfo[group].pName),
+                               frame_group_ticks[group] * ticks_to_ms);
+            }
+        }
+        trace += "}}";
+
+        if (trace.size() >= TraceFlushSize) {
+            flush();
+        }
+    }
+
+    profile.nRunning = running;
+    profile.nActiveGroup = active_group;
+
+    trace += "\n]}\n";
+    flush();
+    return ok;
+}
+
+#else
+
+void EnableMicroProfileRecording() {}
+
+bool WriteMicroProfileTrace([[maybe_unused]] const std::string& path) {
+    return false;
+}
+
+#endif
+
+} // namespace Common
@@ -32,3 +32,24 @@ typedef void* HANDLE;
 #ifdef PAGE_MASK
 #undef PAGE_MASK
 #endif
+
+#include <string>
+
+namespace Common {
+
+/**
+ * Makes MicroProfile record every group even when no profiler UI is attached, so that traces can
+ * be taken on headless runs.
+ */
+void EnableMicroProfileRecording();
+
+/**
+ * Writes the scopes recorded over the frames in MicroProfile's history to a file in the Chrome
+ * trace event format, which can be opened in chrome://tracing or the Perfetto UI. Each frame also
+ * gets a counter event with the time spent in every group during that frame.
+ * @param path Path of the trace file to write.
+ * @returns true on success, false if the file could not be written or MicroProfile is disabled.
+ */
+bool WriteMicroProfileTrace(const std::string& path);
+
+} // namespace Common
@@ -8,6 +8,7 @@
 // single reader, single writer queue
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <mutex>
@@ -93,6 +94,17 @@ public:
         return t;
     }
 
+    template <typename Rep, typename Period>
+    bool PopWaitFor(T& t, const std::chrono::duration<Rep, Period>& timeout) {
+        if (Empty()) {
+            std::unique_lock lock{cv_mutex};
+            if (!cv.wait_for(lock, timeout, [this]() { return !Empty(); })) {
+                return false;
+            }
+        }
+        return Pop(t);
+    }
+
     // not thread-safe
     void Clear() {
         size.store(0);
@@ -160,6 +172,11 @@ public:
         return spsc_queue.PopWait();
     }
 
+    template <typename Rep, typename Period>
+    bool PopWaitFor(T& t, const std::chrono::duration<Rep, Period>& timeout) {
+        return spsc_queue.PopWaitFor(t, timeout);
+    }
+
     // not thread-safe
     void Clear() {
         spsc_queue.Clear();
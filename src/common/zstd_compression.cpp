@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <memory>
 #include <zstd.h>
 
 #include "common/assert.h"
+#include "common/file_util.h"
 #include "common/zstd_compression.h"
 
 namespace Common::Compression {
@@ -48,4 +50,51 @@ std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
     return decompressed;
 }
 
+std::vector<u8> DecompressDataZSTD(FileUtil::IOFile& file) {
+    const std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream{ZSTD_createDStream(),
+                                                                             &ZSTD_freeDStream};
+    if (!stream || ZSTD_isError(ZSTD_initDStream(stream.get()))) {
+        return {};
+    }
+
+    std::vector<u8> chunk(ZSTD_DStreamInSize());
+    const std::size_t output_chunk_size = ZSTD_DStreamOutSize();
+    std::vector<u8> decompressed;
+    std::size_t result = 0;
+    while (true) {
+        const std::size_t read_size = file.ReadBytes(chunk.data(), chunk.size());
+        if (read_size == 0) {
+            break;
+        }
+        if (decompressed.empty()) {
+            const auto content_size = ZSTD_getFrameContentSize(chunk.data(), read_size);
+            if (content_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+                content_size != ZSTD_CONTENTSIZE_ERROR) {
+                decompressed.reserve(content_size);
+            }
+        }
+
+        ZSTD_inBuffer input{chunk.data(), read_size, 0};
+        bool output_full = false;
+        while (input.pos < input.size || output_full) {
+            const std::size_t offset = decompressed.size();
+            decompressed.resize(offset + output_chunk_size);
+            ZSTD_outBuffer output{decompressed.data() + offset, output_chunk_size, 0};
+            result = ZSTD_decompressStream(stream.get(), &output, &input);
+            if (ZSTD_isError(result)) {
+                return {};
+            }
+            decompressed.resize(offset + output.pos);
+            // The decoder may still hold data when the output is full, unless the frame ended
+            output_full = output.pos == output.size && result != 0;
+        }
+    }
+
+    // A nonzero result means the data ended in the middle of a frame
+    if (result != 0) {
+        return {};
+    }
+    return decompressed;
+}
+
 } // namespace Common::Compression
@@ -8,6 +8,10 @@
 
 #include "common/common_types.h"
 
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Common::Compression {
 
 /**
@@ -42,4 +46,14 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed);
 
+/**
+ * Decompresses Zstandard data read from a file in chunks, without loading the whole compressed
+ * data in memory first.
+ *
+ * @param file the file to read the compressed data from, up to its end.
+ *
+ * @return the decompressed data, or an empty vector on failure.
+ */
+[[nodiscard]] std::vector<u8> DecompressDataZSTD(FileUtil::IOFile& file);
+
 } // namespace Common::Compression
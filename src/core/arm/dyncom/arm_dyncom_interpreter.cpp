@@ -5,6 +5,7 @@
 #define CITRA_IGNORE_EXIT(x)
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstdio>
 #include "common/common_types.h"
@@ -34,47 +35,44 @@
 #define ROTATE_RIGHT_32(n, i) ROTATE_RIGHT(n, i, 32)
 #define ROTATE_LEFT_32(n, i) ROTATE_LEFT(n, i, 32)
 
+// For each condition code, a mask of the NZCV flag combinations it passes for. Bit (N << 3 |
+// Z << 2 | C << 1 | V) of a mask is set when the condition holds with those flags.
+static constexpr std::array<u16, 16> ConditionTable = [] {
+    std::array<u16, 16> table{};
+    for (u32 nzcv = 0; nzcv < 16; ++nzcv) {
+        const bool n_flag = (nzcv & 8) != 0;
+        const bool z_flag = (nzcv & 4) != 0;
+        const bool c_flag = (nzcv & 2) != 0;
+        const bool v_flag = (nzcv & 1) != 0;
+        const std::array<bool, 16> passed{
+            z_flag,                        // EQ
+            !z_flag,                       // NE
+            c_flag,                        // CS
+            !c_flag,                       // CC
+            n_flag,                        // MI
+            !n_flag,                       // PL
+            v_flag,                        // VS
+            !v_flag,                       // VC
+            c_flag && !z_flag,             // HI
+            !c_flag || z_flag,             // LS
+            n_flag == v_flag,              // GE
+            n_flag != v_flag,              // LT
+            !z_flag && (n_flag == v_flag), // GT
+            z_flag || (n_flag != v_flag),  // LE
+            true,                          // AL
+            true,                          // NV (Unconditional)
+        };
+        for (std::size_t cond = 0; cond < passed.size(); ++cond) {
+            table[cond] |= static_cast<u16>(passed[cond] << nzcv);
+        }
+    }
+    return table;
+}();
+
 static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
-    const bool n_flag = cpu->NFlag != 0;
-    const bool z_flag = cpu->ZFlag != 0;
-    const bool c_flag = cpu->CFlag != 0;
-    const bool v_flag = cpu->VFlag != 0;
-
-    switch (cond) {
-    case ConditionCode::EQ:
-        return z_flag;
-    case ConditionCode::NE:
-        return !z_flag;
-    case ConditionCode::CS:
-        return c_flag;
-    case ConditionCode::CC:
-        return !c_flag;
-    case ConditionCode::MI:
-        return n_flag;
-    case ConditionCode::PL:
-        return !n_flag;
-    case ConditionCode::VS:
-        return v_flag;
-    case ConditionCode::VC:
-        return !v_flag;
-    case ConditionCode::HI:
-        return (c_flag && !z_flag);
-    case ConditionCode::LS:
-        return (!c_flag || z_flag);
-    case ConditionCode::GE:
-        return (n_flag == v_flag);
-    case ConditionCode::LT:
-        return (n_flag != v_flag);
-    case ConditionCode::GT:
-        return (!z_flag && (n_flag == v_flag));
-    case ConditionCode::LE:
-        return (z_flag || (n_flag != v_flag));
-    case ConditionCode::AL:
-    case ConditionCode::NV: // Unconditional
-        return true;
-    }
-
-    return false;
+    const u32 nzcv = (cpu->NFlag != 0) << 3 | (cpu->ZFlag != 0) << 2 | (cpu->CFlag != 0) << 1 |
+                     (cpu->VFlag != 0);
+    return (ConditionTable[cond & 0xF] >> nzcv) & 1;
 }
 
 static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
@@ -926,6 +924,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     /// Nearest upcoming GDB code execution breakpoint, relative to the last dispatch's address.
     GDBStub::BreakpointAddress breakpoint_data;
     breakpoint_data.type = GDBStub::BreakpointType::None;
+    // The GDB server is only toggled from the frontend while emulation is paused
+    const bool gdb_server_enabled = GDBStub::IsServerEnabled();
 
 #undef RM
 #undef RS
@@ -956,7 +956,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 #define GDB_BP_CHECK                                                                               \
     cpu->Cpsr &= ~(1 << 5);                                                                        \
     cpu->Cpsr |= cpu->TFlag << 5;                                                                  \
-    if (GDBStub::IsServerEnabled()) {                                                              \
+    if (gdb_server_enabled) {                                                                      \
         if (GDBStub::IsMemoryBreak()) {                                                            \
             goto END;                                                                              \
         } else if (breakpoint_data.type != GDBStub::BreakpointType::None &&                        \
@@ -1640,16 +1640,25 @@ DISPATCH : {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
+    // The page table may have changed since the last block, e.g. by an SVC or an MMIO write
+    cpu->ClearPageCache();
+
     // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
-    } else if (cpu->NumInstrsToExecute != 1) {
-        if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+    auto& lookup = cpu->GetBlockLookupEntry(cpu->Reg[15]);
+    if (lookup.pc == cpu->Reg[15]) {
+        ptr = lookup.ptr;
     } else {
-        if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+        auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
+        if (itr != cpu->instruction_cache.end()) {
+            ptr = itr->second;
+        } else if (cpu->NumInstrsToExecute != 1) {
+            if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        } else {
+            if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        }
+        lookup = {cpu->Reg[15], ptr};
     }
 
     // Find breakpoint if one exists within the block
@@ -3870,6 +3879,7 @@ SWI_INST : {
             num_instrs >= cpu->NumInstrsToExecute ? 0 : cpu->NumInstrsToExecute - num_instrs;
         num_instrs = 0;
         Kernel::SVCContext{*cpu->system}.CallSVC(inst_cream->num & 0xFFFF);
+        cpu->ClearPageCache();
         // The kernel would call ERET to get here, which clears exclusive memory state.
         cpu->UnsetExclusiveMemoryAddress();
     }
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include "common/logging/log.h"
 #include "common/swap.h"
 #include "core/arm/skyeye_common/armstate.h"
@@ -190,16 +191,39 @@ static void CheckMemoryBreakpoint(u32 address, GDBStub::BreakpointType type) {
     }
 }
 
+u8* ARMul_State::GetCachedPagePointer(u32 address) const {
+    const u32 page_index = address >> Memory::PAGE_BITS;
+    if (page_index != cached_page_index) {
+        cached_page_pointer = memory.GetPagePointer(address);
+        cached_page_index = page_index;
+    }
+    return cached_page_pointer;
+}
+
 u8 ARMul_State::ReadMemory8(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    return memory.Read8(address);
+    u8 data;
+    if (const u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(&data, page_pointer + (address & Memory::PAGE_MASK), sizeof(data));
+    } else {
+        data = memory.Read8(address);
+        ClearPageCache();
+    }
+
+    return data;
 }
 
 u16 ARMul_State::ReadMemory16(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u16 data = memory.Read16(address);
+    u16 data;
+    if (const u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(&data, page_pointer + (address & Memory::PAGE_MASK), sizeof(data));
+    } else {
+        data = memory.Read16(address);
+        ClearPageCache();
+    }
 
     if (InBigEndianMode())
         data = Common::swap16(data);
@@ -210,7 +234,13 @@ u16 ARMul_State::ReadMemory16(u32 address) const {
 u32 ARMul_State::ReadMemory32(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u32 data = memory.Read32(address);
+    u32 data;
+    if (const u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(&data, page_pointer + (address & Memory::PAGE_MASK), sizeof(data));
+    } else {
+        data = memory.Read32(address);
+        ClearPageCache();
+    }
 
     if (InBigEndianMode())
         data = Common::swap32(data);
@@ -221,7 +251,13 @@ u32 ARMul_State::ReadMemory32(u32 address) const {
 u64 ARMul_State::ReadMemory64(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u64 data = memory.Read64(address);
+    u64 data;
+    if (const u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(&data, page_pointer + (address & Memory::PAGE_MASK), sizeof(data));
+    } else {
+        data = memory.Read64(address);
+        ClearPageCache();
+    }
 
     if (InBigEndianMode())
         data = Common::swap64(data);
@@ -232,7 +268,12 @@ u64 ARMul_State::ReadMemory64(u32 address) const {
 void ARMul_State::WriteMemory8(u32 address, u8 data) {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
 
-    memory.Write8(address, data);
+    if (u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(page_pointer + (address & Memory::PAGE_MASK), &data, sizeof(data));
+    } else {
+        memory.Write8(address, data);
+        ClearPageCache();
+    }
 }
 
 void ARMul_State::WriteMemory16(u32 address, u16 data) {
@@ -241,7 +282,12 @@ void ARMul_State::WriteMemory16(u32 address, u16 data) {
     if (InBigEndianMode())
         data = Common::swap16(data);
 
-    memory.Write16(address, data);
+    if (u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(page_pointer + (address & Memory::PAGE_MASK), &data, sizeof(data));
+    } else {
+        memory.Write16(address, data);
+        ClearPageCache();
+    }
 }
 
 void ARMul_State::WriteMemory32(u32 address, u32 data) {
@@ -250,7 +296,12 @@ void ARMul_State::WriteMemory32(u32 address, u32 data) {
     if (InBigEndianMode())
         data = Common::swap32(data);
 
-    memory.Write32(address, data);
+    if (u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(page_pointer + (address & Memory::PAGE_MASK), &data, sizeof(data));
+    } else {
+        memory.Write32(address, data);
+        ClearPageCache();
+    }
 }
 
 void ARMul_State::WriteMemory64(u32 address, u64 data) {
@@ -259,7 +310,12 @@ void ARMul_State::WriteMemory64(u32 address, u64 data) {
     if (InBigEndianMode())
         data = Common::swap64(data);
 
-    memory.Write64(address, data);
+    if (u8* page_pointer = GetCachedPagePointer(address)) {
+        std::memcpy(page_pointer + (address & Memory::PAGE_MASK), &data, sizeof(data));
+    } else {
+        memory.Write64(address, data);
+        ClearPageCache();
+    }
 }
 
 // Reads from the CP15 registers. Used with implementation of the MRC instruction.
@@ -164,6 +164,12 @@ public:
     void WriteMemory32(u32 address, u32 data);
     void WriteMemory64(u32 address, u64 data);
 
+    // Forgets the page pointer cached by the memory accesses. Must be called whenever the page
+    // table may have changed, which the interpreter does on every block dispatch.
+    void ClearPageCache() const {
+        cached_page_index = INVALID_PAGE_INDEX;
+    }
+
     u32 ReadCP15Register(u32 crn, u32 opcode_1, u32 crm, u32 opcode_2) const;
     void WriteCP15Register(u32 value, u32 crn, u32 opcode_1, u32 crm, u32 opcode_2);
 
@@ -256,9 +262,30 @@ public:
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
     std::unordered_map<u32, std::size_t> instruction_cache;
 
+    // Direct-mapped cache of instruction_cache lookups, indexed by the low bits of the PC
+    struct BlockLookupEntry {
+        u32 pc = 0xFFFFFFFF;
+        std::size_t ptr = 0;
+    };
+    static constexpr std::size_t BLOCK_LOOKUP_SIZE = 0x1000;
+    std::array<BlockLookupEntry, BLOCK_LOOKUP_SIZE> block_lookup{};
+
+    BlockLookupEntry& GetBlockLookupEntry(u32 pc) {
+        return block_lookup[(pc >> 1) & (BLOCK_LOOKUP_SIZE - 1)];
+    }
+    void ClearInstructionCache() {
+        instruction_cache.clear();
+        block_lookup.fill({});
+    }
+
 private:
     void ResetMPCoreCP15Registers();
 
+    // Returns the host pointer of the page of an address if it is plain memory, going through the
+    // page table only when the page differs from the one of the previous access. Accesses to other
+    // pages clear the cache, as MMIO handlers and rasterizer flushes may change the page table.
+    u8* GetCachedPagePointer(u32 address) const;
+
     // Defines a reservation granule of 2 words, which protects the first 2 words starting at the
     // tag. This is the smallest granule allowed by the v7 spec, and is coincidentally just large
     // enough to support LDR/STREXD.
@@ -269,4 +296,8 @@ private:
 
     GDBStub::BreakpointAddress last_bkpt{};
     bool last_bkpt_hit = false;
+
+    static constexpr u32 INVALID_PAGE_INDEX = 0xFFFFFFFF;
+    mutable u32 cached_page_index = INVALID_PAGE_INDEX;
+    mutable u8* cached_page_pointer = nullptr;
 };
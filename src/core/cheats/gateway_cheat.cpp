@@ -29,16 +29,14 @@ struct State {
 };
 
 template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
-                                                              const State& state,
-                                                              ReadFunction read_func,
-                                                              WriteFunction write_func,
-                                                              Core::System& system) {
+static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(
+    const GatewayCheat::CheatLine& line, const State& state, ReadFunction read_func,
+    WriteFunction write_func, const GatewayCheat::ExecutionContext& context) {
     u32 addr = line.address + state.offset;
     T val = read_func(addr);
     if (val != static_cast<T>(line.value)) {
         write_func(addr, static_cast<T>(line.value));
-        system.InvalidateCacheRange(addr, sizeof(T));
+        context.invalidate_cache_range(addr, sizeof(T));
     }
 }
 
@@ -106,12 +104,12 @@ static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state)
 template <typename T, typename ReadFunction, typename WriteFunction>
 static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
     const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
-    WriteFunction write_func, Core::System& system) {
+    WriteFunction write_func, const GatewayCheat::ExecutionContext& context) {
     u32 addr = line.value + state.offset;
     T val = read_func(addr);
     if (val != static_cast<T>(state.reg)) {
         write_func(addr, static_cast<T>(state.reg));
-        system.InvalidateCacheRange(addr, sizeof(T));
+        context.invalidate_cache_range(addr, sizeof(T));
     }
     state.offset += sizeof(T);
 }
@@ -129,19 +127,16 @@ static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state
 }
 
 static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
-    u32 pad_state = system.ServiceManager()
-                        .GetService<Service::HID::Module::Interface>("hid:USER")
-                        ->GetModule()
-                        ->GetState()
-                        .hex;
+                           const GatewayCheat::ExecutionContext& context) {
+    u32 pad_state = context.get_pad_state();
     bool pressed = (pad_state & line.value) == line.value;
     if (!pressed) {
         state.if_flag++;
     }
 }
 
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
+static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state,
+                           const GatewayCheat::ExecutionContext& context,
                            const std::vector<GatewayCheat::CheatLine>& cheat_lines) {
     if (state.if_flag > 0) {
         // Skip over the additional patch lines
@@ -150,7 +145,7 @@ static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Co
     }
     u32 num_bytes = line.value;
     u32 addr = line.address + state.offset;
-    system.InvalidateCacheRange(addr, num_bytes);
+    context.invalidate_cache_range(addr, num_bytes);
 
     bool first = true;
     u32 bit_offset = 0;
@@ -163,7 +158,7 @@ static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Co
             state.current_line_nr++;
         }
         first = !first;
-        system.Memory().Write32(addr, tmp);
+        context.memory.Write32(addr, tmp);
         addr += 4;
         num_bytes -= 4;
     }
@@ -171,13 +166,57 @@ static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Co
         u32 tmp = (first ? cheat_lines[state.current_line_nr].first
                          : cheat_lines[state.current_line_nr].value) >>
                   bit_offset;
-        system.Memory().Write8(addr, tmp);
+        context.memory.Write8(addr, tmp);
         addr += 1;
         num_bytes -= 1;
         bit_offset += 8;
     }
 }
 
+static bool IsCondition(GatewayCheat::CheatType type) {
+    switch (type) {
+    case GatewayCheat::CheatType::GreaterThan32:
+    case GatewayCheat::CheatType::LessThan32:
+    case GatewayCheat::CheatType::EqualTo32:
+    case GatewayCheat::CheatType::NotEqualTo32:
+    case GatewayCheat::CheatType::GreaterThan16WithMask:
+    case GatewayCheat::CheatType::LessThan16WithMask:
+    case GatewayCheat::CheatType::EqualTo16WithMask:
+    case GatewayCheat::CheatType::NotEqualTo16WithMask:
+    case GatewayCheat::CheatType::Joker:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Number of lines following a patch line that hold its data
+static std::size_t GetPatchLineCount(u32 num_bytes) {
+    return (static_cast<std::size_t>(num_bytes) + 7) / 8;
+}
+
+template <typename T>
+static T ReadValue(Memory::MemorySystem& memory, VAddr addr) {
+    if constexpr (sizeof(T) == 1) {
+        return memory.Read8(addr);
+    } else if constexpr (sizeof(T) == 2) {
+        return memory.Read16(addr);
+    } else {
+        return memory.Read32(addr);
+    }
+}
+
+template <typename T>
+static void WriteValue(Memory::MemorySystem& memory, VAddr addr, T value) {
+    if constexpr (sizeof(T) == 1) {
+        memory.Write8(addr, value);
+    } else if constexpr (sizeof(T) == 2) {
+        memory.Write16(addr, value);
+    } else {
+        memory.Write32(addr, value);
+    }
+}
+
 GatewayCheat::CheatLine::CheatLine(const std::string& line) {
     constexpr std::size_t cheat_length = 17;
     if (line.length() != cheat_length) {
@@ -209,6 +248,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -223,14 +263,265 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(code_lines[i]);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
+void GatewayCheat::Compile() {
+    operations.resize(cheat_lines.size());
+
+    for (std::size_t i = 0; i < cheat_lines.size(); ++i) {
+        const CheatLine& line = cheat_lines[i];
+        if (!line.valid) {
+            continue;
+        }
+
+        Operation& operation = operations[i];
+        operation.type = line.type;
+        operation.address = line.address;
+        operation.value = line.value;
+        if (line.type != CheatType::Patch) {
+            continue;
+        }
+
+        // The data lines hold the bytes as pairs of little endian words. Patches longer than the
+        // lines left only write the bytes that are there.
+        const std::size_t data_begin = i + 1;
+        const std::size_t data_end =
+            std::min(data_begin + GetPatchLineCount(line.value), cheat_lines.size());
+        const u32 num_bytes = static_cast<u32>(
+            std::min<std::size_t>(line.value, (data_end - data_begin) * 8));
+
+        operation.next = data_begin + GetPatchLineCount(line.value);
+        operation.value = num_bytes;
+        operation.data_offset = patch_data.size();
+        for (u32 byte = 0; byte < num_bytes; ++byte) {
+            const CheatLine& data_line = cheat_lines[data_begin + byte / 8];
+            const u32 word =
+                !data_line.valid ? 0 : byte % 8 < 4 ? data_line.first : data_line.value;
+            patch_data.push_back(static_cast<u8>(word >> (byte % 4 * 8)));
+        }
+        i = data_end - 1;
+    }
+
+    // Find where the block skipped by a failed condition ends, following the conditions nested
+    // in it
+    for (std::size_t i = 0; i < operations.size(); ++i) {
+        if (!IsCondition(operations[i].type)) {
+            continue;
+        }
+
+        u32 depth = 1;
+        std::size_t next = i + 1;
+        while (next < operations.size()) {
+            const Operation& skipped = operations[next];
+            if (IsCondition(skipped.type)) {
+                ++depth;
+            } else if (skipped.type == CheatType::Terminator && --depth == 0) {
+                ++next;
+                break;
+            } else if (skipped.type == CheatType::FullTerminator) {
+                break;
+            } else if (skipped.type == CheatType::Patch) {
+                next = skipped.next;
+                continue;
+            }
+            ++next;
+        }
+        operations[i].next = next;
+        operations[i].skip_depth = depth;
+    }
+}
+
 void GatewayCheat::Execute(Core::System& system) const {
+    const ExecutionContext context{
+        system.Memory(),
+        [&system](VAddr address, std::size_t size) { system.InvalidateCacheRange(address, size); },
+        [&system] {
+            return system.ServiceManager()
+                .GetService<Service::HID::Module::Interface>("hid:USER")
+                ->GetModule()
+                ->GetState()
+                .hex;
+        },
+    };
+    Run(context);
+}
+
+void GatewayCheat::Run(const ExecutionContext& context) const {
+    State state;
+    Memory::MemorySystem& memory = context.memory;
+
+    // No emulated code runs until the cheat is done, so the CPU caches are invalidated once at the
+    // end for each range written
+    std::vector<std::pair<VAddr, std::size_t>> written_ranges;
+    const auto mark_written = [&written_ranges](VAddr addr, std::size_t size) {
+        if (!written_ranges.empty()) {
+            auto& [start, length] = written_ranges.back();
+            if (addr >= start && addr <= start + length) {
+                length = std::max<std::size_t>(length, addr - start + size);
+                return;
+            }
+        }
+        written_ranges.emplace_back(addr, size);
+    };
+
+    const auto write_if_changed = [&memory, &mark_written](VAddr addr, auto value) {
+        using T = decltype(value);
+        if (ReadValue<T>(memory, addr) != value) {
+            WriteValue<T>(memory, addr, value);
+            mark_written(addr, sizeof(T));
+        }
+    };
+
+    const auto evaluate_condition = [&memory, &state, &context](const Operation& operation) {
+        const VAddr addr = operation.address + state.offset;
+        const u16 value16 = static_cast<u16>(operation.value);
+        const u16 mask16 = static_cast<u16>(~operation.value >> 16);
+        switch (operation.type) {
+        case CheatType::GreaterThan32:
+            return operation.value > memory.Read32(addr);
+        case CheatType::LessThan32:
+            return operation.value < memory.Read32(addr);
+        case CheatType::EqualTo32:
+            return operation.value == memory.Read32(addr);
+        case CheatType::NotEqualTo32:
+            return operation.value != memory.Read32(addr);
+        case CheatType::GreaterThan16WithMask:
+            return value16 > (mask16 & memory.Read16(addr));
+        case CheatType::LessThan16WithMask:
+            return value16 < (mask16 & memory.Read16(addr));
+        case CheatType::EqualTo16WithMask:
+            return value16 == (mask16 & memory.Read16(addr));
+        case CheatType::NotEqualTo16WithMask:
+            return value16 != (mask16 & memory.Read16(addr));
+        default:
+            return (context.get_pad_state() & operation.value) == operation.value;
+        }
+    };
+
+    for (state.current_line_nr = 0; state.current_line_nr < operations.size();
+         state.current_line_nr++) {
+        const Operation& operation = operations[state.current_line_nr];
+        if (state.if_flag > 0) {
+            // Failed conditions jump over their block, so this is only reached when a
+            // FullTerminator ending a skipped block loops back, and the block is skipped line by
+            // line like the interpreter does
+            if (IsCondition(operation.type)) {
+                state.if_flag++;
+            } else if (operation.type == CheatType::Patch) {
+                state.current_line_nr = operation.next - 1;
+            } else if (operation.type == CheatType::Terminator) {
+                TerminateOp(state);
+            } else if (operation.type == CheatType::FullTerminator) {
+                FullTerminateOp(state);
+            }
+            continue;
+        }
+
+        switch (operation.type) {
+        case CheatType::Null:
+            break;
+        case CheatType::Write32:
+            write_if_changed(operation.address + state.offset, operation.value);
+            break;
+        case CheatType::Write16:
+            write_if_changed(operation.address + state.offset, static_cast<u16>(operation.value));
+            break;
+        case CheatType::Write8:
+            write_if_changed(operation.address + state.offset, static_cast<u8>(operation.value));
+            break;
+        case CheatType::GreaterThan32:
+        case CheatType::LessThan32:
+        case CheatType::EqualTo32:
+        case CheatType::NotEqualTo32:
+        case CheatType::GreaterThan16WithMask:
+        case CheatType::LessThan16WithMask:
+        case CheatType::EqualTo16WithMask:
+        case CheatType::NotEqualTo16WithMask:
+        case CheatType::Joker:
+            if (!evaluate_condition(operation)) {
+                state.if_flag = operation.skip_depth;
+                state.current_line_nr = operation.next - 1;
+            }
+            break;
+        case CheatType::LoadOffset:
+            state.offset = memory.Read32(operation.address + state.offset);
+            break;
+        case CheatType::Loop:
+            state.loop_flag = state.loop_count < operation.value;
+            state.loop_count++;
+            state.loop_back_line = state.current_line_nr;
+            break;
+        case CheatType::Terminator:
+            TerminateOp(state);
+            break;
+        case CheatType::LoopExecuteVariant:
+            LoopExecuteVariantOp(state);
+            break;
+        case CheatType::FullTerminator:
+            FullTerminateOp(state);
+            break;
+        case CheatType::SetOffset:
+            state.offset = operation.value;
+            break;
+        case CheatType::AddValue:
+            state.reg += operation.value;
+            break;
+        case CheatType::SetValue:
+            state.reg = operation.value;
+            break;
+        case CheatType::IncrementiveWrite32:
+            write_if_changed(operation.value + state.offset, state.reg);
+            state.offset += 4;
+            break;
+        case CheatType::IncrementiveWrite16:
+            write_if_changed(operation.value + state.offset, static_cast<u16>(state.reg));
+            state.offset += 2;
+            break;
+        case CheatType::IncrementiveWrite8:
+            write_if_changed(operation.value + state.offset, static_cast<u8>(state.reg));
+            state.offset += 1;
+            break;
+        case CheatType::Load32:
+            state.reg = memory.Read32(operation.value + state.offset);
+            break;
+        case CheatType::Load16:
+            state.reg = memory.Read16(operation.value + state.offset);
+            break;
+        case CheatType::Load8:
+            state.reg = memory.Read8(operation.value + state.offset);
+            break;
+        case CheatType::AddOffset:
+            state.offset += operation.value;
+            break;
+        case CheatType::Patch: {
+            VAddr addr = operation.address + state.offset;
+            const u8* data = patch_data.data() + operation.data_offset;
+            u32 num_bytes = operation.value;
+            mark_written(addr, num_bytes);
+            for (; num_bytes >= 4; num_bytes -= 4, addr += 4, data += 4) {
+                memory.Write32(addr, data[0] | data[1] << 8 | data[2] << 16 | data[3] << 24);
+            }
+            for (; num_bytes > 0; --num_bytes, ++addr, ++data) {
+                memory.Write8(addr, *data);
+            }
+            state.current_line_nr = operation.next - 1;
+            break;
+        }
+        }
+    }
+
+    for (const auto& [start, length] : written_ranges) {
+        context.invalidate_cache_range(start, length);
+    }
+}
+
+void GatewayCheat::RunInterpreted(const ExecutionContext& context) const {
     State state;
 
-    Memory::MemorySystem& memory = system.Memory();
+    Memory::MemorySystem& memory = context.memory;
     auto Read8 = [&memory](VAddr addr) { return memory.Read8(addr); };
     auto Read16 = [&memory](VAddr addr) { return memory.Read16(addr); };
     auto Read32 = [&memory](VAddr addr) { return memory.Read32(addr); };
@@ -259,7 +550,7 @@ void GatewayCheat::Execute(Core::System& system) const {
                 // EXXXXXXX YYYYYYYY
                 // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
                 // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, cheat_lines);
+                PatchOp(line, state, context, cheat_lines);
                 break;
             case CheatType::Terminator:
                 // D0000000 00000000 - ENDIF
@@ -280,15 +571,15 @@ void GatewayCheat::Execute(Core::System& system) const {
             break;
         case CheatType::Write32:
             // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
-            WriteOp<u32>(line, state, Read32, Write32, system);
+            WriteOp<u32>(line, state, Read32, Write32, context);
             break;
         case CheatType::Write16:
             // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
-            WriteOp<u16>(line, state, Read16, Write16, system);
+            WriteOp<u16>(line, state, Read16, Write16, context);
             break;
         case CheatType::Write8:
             // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
-            WriteOp<u8>(line, state, Read8, Write8, system);
+            WriteOp<u8>(line, state, Read8, Write8, context);
             break;
         case CheatType::GreaterThan32:
             // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
@@ -334,7 +625,7 @@ void GatewayCheat::Execute(Core::System& system) const {
             break;
         case CheatType::LoadOffset:
             // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
-            LoadOffsetOp(system.Memory(), line, state);
+            LoadOffsetOp(memory, line, state);
             break;
         case CheatType::Loop: {
             // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
@@ -374,17 +665,17 @@ void GatewayCheat::Execute(Core::System& system) const {
         }
         case CheatType::IncrementiveWrite32: {
             // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
-            IncrementiveWriteOp<u32>(line, state, Read32, Write32, system);
+            IncrementiveWriteOp<u32>(line, state, Read32, Write32, context);
             break;
         }
         case CheatType::IncrementiveWrite16: {
             // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
-            IncrementiveWriteOp<u16>(line, state, Read16, Write16, system);
+            IncrementiveWriteOp<u16>(line, state, Read16, Write16, context);
             break;
         }
         case CheatType::IncrementiveWrite8: {
             // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
-            IncrementiveWriteOp<u8>(line, state, Read8, Write8, system);
+            IncrementiveWriteOp<u8>(line, state, Read8, Write8, context);
             break;
         }
         case CheatType::Load32: {
@@ -409,13 +700,13 @@ void GatewayCheat::Execute(Core::System& system) const {
         }
         case CheatType::Joker: {
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            JokerOp(line, state, context);
             break;
         }
         case CheatType::Patch: {
             // EXXXXXXX YYYYYYYY
             // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, cheat_lines);
+            PatchOp(line, state, context, cheat_lines);
             break;
         }
         }
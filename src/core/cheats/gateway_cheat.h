@@ -5,9 +5,16 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <vector>
+#include "common/common_types.h"
 #include "core/cheats/cheat_base.h"
 
+namespace Memory {
+class MemorySystem;
+}
+
 namespace Cheats {
 class GatewayCheat final : public CheatBase {
 public:
@@ -53,12 +60,28 @@ public:
         bool valid = true;
     };
 
+    /// What running a cheat needs from the emulated system
+    struct ExecutionContext {
+        Memory::MemorySystem& memory;
+        /// Invalidates the CPU caches for a range of written memory
+        std::function<void(VAddr address, std::size_t size)> invalidate_cache_range;
+        /// Returns the state of the pad buttons, as in the HID shared memory
+        std::function<u32()> get_pad_state;
+    };
+
     GatewayCheat(std::string name, std::vector<CheatLine> cheat_lines, std::string comments);
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
 
     void Execute(Core::System& system) const override;
 
+    /// Runs the compiled cheat
+    void Run(const ExecutionContext& context) const;
+
+    /// Runs the cheat by interpreting its lines one at a time. Kept as the reference for tests and
+    /// benchmarks of the compiled cheat.
+    void RunInterpreted(const ExecutionContext& context) const;
+
     bool IsEnabled() const override;
     void SetEnabled(bool enabled) override;
 
@@ -78,9 +101,38 @@ public:
     static std::vector<std::unique_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /**
+     * Cheat line decoded for execution. Operations are indexed like the lines they come from, the
+     * data lines of patches being left as Null operations that are never reached.
+     */
+    struct Operation {
+        CheatType type = CheatType::Null;
+        u32 address = 0;
+        u32 value = 0;
+        /**
+         * Conditions: operation to continue at when the condition fails, past the block skipped.
+         * Patches: operation following the patch data.
+         */
+        std::size_t next = 0;
+        /**
+         * Conditions: number of blocks still being skipped at `next`. Only nonzero when the skip
+         * ends on a FullTerminator, which decides at run time whether the skip continues.
+         */
+        u32 skip_depth = 0;
+        /// Patches: offset of the bytes to write in patch_data
+        std::size_t data_offset = 0;
+    };
+
+    /// Decodes the cheat lines into operations
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
     const std::string comments;
+
+    std::vector<Operation> operations;
+    /// Bytes written by every patch of the cheat, one after the other
+    std::vector<u8> patch_data;
 };
 } // namespace Cheats
@@ -95,6 +95,14 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         }
     }
 
+    try {
+        Movie::GetInstance().HandleKeyframeRequests();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Error loading movie keyframe: {}", e.what());
+        status_details = e.what();
+        return ResultStatus::ErrorSavestate;
+    }
+
     Signal signal{Signal::None};
     u32 param{};
     {
@@ -309,6 +317,7 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
                   static_cast<u32>(load_result));
     }
     perf_stats = std::make_unique<PerfStats>(title_id);
+    service_call_stats.Reset();
     custom_tex_cache = std::make_unique<Core::CustomTexCache>();
 
     if (Settings::values.custom_textures) {
@@ -456,6 +465,18 @@ const Service::FS::ArchiveManager& System::ArchiveManager() const {
     return *archive_manager;
 }
 
+RPC::RPCServer& System::RPCServer() {
+    return *rpc_server;
+}
+
+Service::CallStats& System::ServiceCallStats() {
+    return service_call_stats;
+}
+
+const Service::CallStats& System::ServiceCallStats() const {
+    return service_call_stats;
+}
+
 Kernel::KernelSystem& System::Kernel() {
     return *kernel;
 }
@@ -7,12 +7,14 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "core/custom_tex_cache.h"
 #include "core/frontend/applets/mii_selector.h"
 #include "core/frontend/applets/swkbd.h"
 #include "core/frontend/image_interface.h"
+#include "core/hle/service/call_stats.h"
 #include "core/loader/loader.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
@@ -225,6 +227,15 @@ public:
     /// Gets a const reference to the archive manager
     [[nodiscard]] const Service::FS::ArchiveManager& ArchiveManager() const;
 
+    /// Gets a reference to the RPC server
+    [[nodiscard]] RPC::RPCServer& RPCServer();
+
+    /// Gets a reference to the HLE service call statistics
+    [[nodiscard]] Service::CallStats& ServiceCallStats();
+
+    /// Gets a const reference to the HLE service call statistics
+    [[nodiscard]] const Service::CallStats& ServiceCallStats() const;
+
     /// Gets a reference to the kernel
     [[nodiscard]] Kernel::KernelSystem& Kernel();
 
@@ -305,6 +316,12 @@ public:
 
     void LoadState(u32 slot);
 
+    /// Serializes the emulated system into a compressed buffer, as stored in savestate files
+    [[nodiscard]] std::vector<u8> SaveStateToBuffer() const;
+
+    /// Restores the emulated system from a buffer returned by SaveStateToBuffer
+    void LoadStateFromBuffer(const std::vector<u8>& buffer);
+
 private:
     /**
      * Initialize the emulated system.
@@ -359,6 +376,9 @@ private:
 
     std::unique_ptr<Service::FS::ArchiveManager> archive_manager;
 
+    /// Outlives the services, which keep references to their counters
+    Service::CallStats service_call_stats;
+
     std::unique_ptr<Memory::MemorySystem> memory;
     std::unique_ptr<Kernel::KernelSystem> kernel;
     std::unique_ptr<Timing> timing;
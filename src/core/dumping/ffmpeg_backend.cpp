@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <unordered_set>
 #include "common/assert.h"
 #include "common/file_util.h"
@@ -110,7 +111,6 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
         return false;
 
     layout = layout_;
-    frame_count = 0;
 
     // Initialize video codec
     const AVCodec* codec = avcodec_find_encoder_by_name(Settings::values.video_encoder.c_str());
@@ -133,6 +133,8 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     codec_context->time_base.num = static_cast<int>(GPU::frame_ticks);
     codec_context->time_base.den = static_cast<int>(BASE_CLOCK_RATE_ARM11);
     codec_context->gop_size = 12;
+    // 0 lets the encoder pick a thread count from the number of host cores
+    codec_context->thread_count = static_cast<int>(Settings::values.video_encoder_threads);
     codec_context->pix_fmt = codec->pix_fmts ? codec->pix_fmts[0] : AV_PIX_FMT_YUV420P;
     if (format_context->oformat->flags & AVFMT_GLOBALHEADER)
         codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
@@ -156,60 +158,61 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
         return false;
     }
 
-    // Allocate frames
-    current_frame.reset(av_frame_alloc());
-    scaled_frame.reset(av_frame_alloc());
-    scaled_frame->format = codec_context->pix_fmt;
-    scaled_frame->width = layout.width;
-    scaled_frame->height = layout.height;
-    if (av_frame_get_buffer(scaled_frame.get(), 0) < 0) {
-        LOG_ERROR(Render, "Could not allocate frame buffer");
-        return false;
-    }
-
-    // Create SWS Context
-    auto* context = sws_getCachedContext(
-        sws_context.get(), layout.width, layout.height, pixel_format, layout.width, layout.height,
-        codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
-    if (context != sws_context.get())
-        sws_context.reset(context);
-
     return true;
 }
 
 void FFmpegVideoStream::Free() {
     FFmpegStream::Free();
+}
+
+AVFramePtr FFmpegVideoStream::AllocateFrame() const {
+    AVFramePtr frame{av_frame_alloc()};
+    if (!frame) {
+        return nullptr;
+    }
+    frame->format = codec_context->pix_fmt;
+    frame->width = layout.width;
+    frame->height = layout.height;
+    if (av_frame_get_buffer(frame.get(), 0) < 0) {
+        LOG_ERROR(Render, "Could not allocate frame buffer");
+        return nullptr;
+    }
+    return frame;
+}
 
-    current_frame.reset();
-    scaled_frame.reset();
-    sws_context.reset();
+void FFmpegVideoStream::EncodeFrame(AVFrame* frame, s64 pts) {
+    frame->pts = pts;
+    SendFrame(frame);
 }
 
-void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
+bool FFmpegVideoConverter::Init(const FFmpegVideoStream& stream) {
+    layout = stream.layout;
+    sws_context.reset(sws_getContext(layout.width, layout.height, pixel_format, layout.width,
+                                     layout.height, stream.codec_context->pix_fmt, SWS_BICUBIC,
+                                     nullptr, nullptr, nullptr));
+    if (!sws_context) {
+        LOG_ERROR(Render, "Could not create SWS context");
+        return false;
+    }
+    return true;
+}
+
+bool FFmpegVideoConverter::Convert(VideoFrame& frame, AVFrame* converted_frame) {
     if (frame.width != layout.width || frame.height != layout.height) {
         LOG_ERROR(Render, "Frame dropped: resolution does not match");
-        return;
+        return false;
     }
-    // Prepare frame
-    current_frame->data[0] = frame.data.data();
-    current_frame->linesize[0] = frame.stride;
-    current_frame->format = pixel_format;
-    current_frame->width = layout.width;
-    current_frame->height = layout.height;
-
-    // Scale the frame
-    if (av_frame_make_writable(scaled_frame.get()) < 0) {
+    // The encoder may still reference a frame it was sent before
+    if (av_frame_make_writable(converted_frame) < 0) {
         LOG_ERROR(Render, "Video frame dropped: Could not prepare frame");
-        return;
-    }
-    if (sws_context) {
-        sws_scale(sws_context.get(), current_frame->data, current_frame->linesize, 0, layout.height,
-                  scaled_frame->data, scaled_frame->linesize);
+        return false;
     }
-    scaled_frame->pts = frame_count++;
 
-    // Encode frame
-    SendFrame(scaled_frame.get());
+    const std::array<const u8*, 4> data{frame.data.data()};
+    const std::array<int, 4> linesize{static_cast<int>(frame.stride)};
+    sws_scale(sws_context.get(), data.data(), linesize.data(), 0, layout.height,
+              converted_frame->data, converted_frame->linesize);
+    return true;
 }
 
 FFmpegAudioStream::~FFmpegAudioStream() {
@@ -461,8 +464,16 @@ void FFmpegMuxer::Free() {
     format_context.reset();
 }
 
-void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame) {
-    video_stream.ProcessFrame(frame);
+bool FFmpegMuxer::InitVideoConverter(FFmpegVideoConverter& converter) const {
+    return converter.Init(video_stream);
+}
+
+AVFramePtr FFmpegMuxer::AllocateVideoFrame() const {
+    return video_stream.AllocateFrame();
+}
+
+void FFmpegMuxer::EncodeVideoFrame(AVFrame* frame, s64 pts) {
+    video_stream.EncodeFrame(frame, pts);
 }
 
 void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
@@ -493,6 +504,10 @@ FFmpegBackend::~FFmpegBackend() {
         video_processing_thread.join();
     if (audio_processing_thread.joinable())
         audio_processing_thread.join();
+    for (auto& thread : video_conversion_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
     ffmpeg.Free();
 }
 
@@ -509,21 +524,34 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 
     if (video_processing_thread.joinable())
         video_processing_thread.join();
+    for (auto& thread : video_conversion_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+    video_conversion_threads.clear();
+
+    {
+        std::lock_guard lock{video_mutex};
+        video_jobs.clear();
+        converted_video_frames.clear();
+        free_video_frames.clear();
+        video_frames_in_flight = 0;
+        max_video_frames_in_flight = std::max<std::size_t>(
+            1, static_cast<std::size_t>(Settings::values.video_frame_queue_size));
+        next_video_sequence = 0;
+        next_video_pts = 0;
+        dropped_video_frames = 0;
+        video_input_ended = false;
+    }
+
+    const u32 num_conversion_threads = std::max(1u, Settings::values.video_conversion_threads);
+    for (u32 i = 0; i < num_conversion_threads; ++i) {
+        video_conversion_threads.emplace_back([this] { ConversionLoop(); });
+    }
     video_processing_thread = std::thread([&] {
-        event1.Set();
-        while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
-            // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
-            if (frame.width == 0 && frame.height == 0) {
-                // An empty frame marks the end of frame data
-                ffmpeg.FlushVideo();
-                break;
-            }
-            ffmpeg.ProcessVideoFrame(frame);
+        EncodingLoop();
+        for (auto& thread : video_conversion_threads) {
+            thread.join();
         }
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
@@ -554,9 +582,30 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 }
 
 void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+    {
+        std::unique_lock lock{video_mutex};
+        if (video_input_ended) {
+            return;
+        }
+        const s64 pts = next_video_pts++;
+        if (video_frames_in_flight >= max_video_frames_in_flight) {
+            if (Settings::values.drop_video_frames) {
+                if (dropped_video_frames++ == 0) {
+                    LOG_WARNING(Render, "Video frames are being dropped, encoding is too slow");
+                }
+                return;
+            }
+            video_cv.wait(lock, [this] {
+                return video_input_ended || video_frames_in_flight < max_video_frames_in_flight;
+            });
+            if (video_input_ended) {
+                return;
+            }
+        }
+        ++video_frames_in_flight;
+        video_jobs.push_back({next_video_sequence++, pts, std::move(frame)});
+    }
+    video_cv.notify_all();
 }
 
 void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
@@ -582,8 +631,12 @@ void FFmpegBackend::StopDumping() {
     is_dumping = false;
     VideoCore::g_renderer->CleanupVideoDumping();
 
-    // Flush the video processing queue
-    AddVideoFrame(VideoFrame());
+    // Let the video threads finish the queued frames and flush the encoder
+    {
+        std::lock_guard lock{video_mutex};
+        video_input_ended = true;
+    }
+    video_cv.notify_all();
     for (auto i : {0, 1}) {
         // Flush the audio processing queue
         audio_frame_queues[i].Push(VariableAudioFrame());
@@ -600,8 +653,88 @@ Layout::FramebufferLayout FFmpegBackend::GetLayout() const {
     return video_layout;
 }
 
+void FFmpegBackend::ConversionLoop() {
+    Common::SetCurrentThreadName("VideoDumper:Convert");
+    FFmpegVideoConverter converter;
+    const bool converter_ready = ffmpeg.InitVideoConverter(converter);
+    while (true) {
+        VideoJob job;
+        AVFramePtr converted_frame;
+        {
+            std::unique_lock lock{video_mutex};
+            video_cv.wait(lock, [this] { return video_input_ended || !video_jobs.empty(); });
+            if (video_jobs.empty()) {
+                return;
+            }
+            job = std::move(video_jobs.front());
+            video_jobs.pop_front();
+            if (!free_video_frames.empty()) {
+                converted_frame = std::move(free_video_frames.back());
+                free_video_frames.pop_back();
+            }
+        }
+
+        if (!converted_frame) {
+            converted_frame = ffmpeg.AllocateVideoFrame();
+        }
+        if (!converter_ready || !converted_frame ||
+            !converter.Convert(job.frame, converted_frame.get())) {
+            converted_frame.reset();
+        }
+
+        {
+            std::lock_guard lock{video_mutex};
+            converted_video_frames.emplace(
+                job.sequence, ConvertedVideoFrame{job.pts, std::move(converted_frame)});
+        }
+        video_cv.notify_all();
+    }
+}
+
+void FFmpegBackend::EncodingLoop() {
+    Common::SetCurrentThreadName("VideoDumper:Encode");
+    // Frames are converted out of order, encode them in the order they were added
+    for (u64 sequence = 0;; ++sequence) {
+        ConvertedVideoFrame converted;
+        {
+            std::unique_lock lock{video_mutex};
+            video_cv.wait(lock, [this, sequence] {
+                return converted_video_frames.count(sequence) != 0 ||
+                       (video_input_ended && sequence == next_video_sequence);
+            });
+            auto itr = converted_video_frames.find(sequence);
+            if (itr == converted_video_frames.end()) {
+                break;
+            }
+            converted = std::move(itr->second);
+            converted_video_frames.erase(itr);
+        }
+
+        if (converted.frame) {
+            ffmpeg.EncodeVideoFrame(converted.frame.get(), converted.pts);
+        }
+
+        {
+            std::lock_guard lock{video_mutex};
+            if (converted.frame) {
+                free_video_frames.push_back(std::move(converted.frame));
+            }
+            --video_frames_in_flight;
+        }
+        video_cv.notify_all();
+    }
+    ffmpeg.FlushVideo();
+}
+
 void FFmpegBackend::EndDumping() {
     LOG_INFO(Render, "Ending frame dumping");
+    {
+        std::lock_guard lock{video_mutex};
+        if (dropped_video_frames != 0) {
+            LOG_WARNING(Render, "{} video frames were dropped", dropped_video_frames);
+        }
+        free_video_frames.clear();
+    }
 
     ffmpeg.WriteTrailer();
     ffmpeg.Free();
@@ -6,7 +6,9 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -33,6 +35,14 @@ void InitFFmpegLibraries();
 
 class FFmpegMuxer;
 
+struct AVFrameDeleter {
+    void operator()(AVFrame* frame) const {
+        av_frame_free(&frame);
+    }
+};
+
+using AVFramePtr = std::unique_ptr<AVFrame, AVFrameDeleter>;
+
 /**
  * Wrapper around FFmpeg AVCodecContext + AVStream.
  * Rescales/Resamples, encodes and writes a frame.
@@ -55,12 +65,6 @@ protected:
         }
     };
 
-    struct AVFrameDeleter {
-        void operator()(AVFrame* frame) const {
-            av_frame_free(&frame);
-        }
-    };
-
     AVFormatContext* format_context{};
     std::mutex* format_context_mutex{};
     std::unique_ptr<AVCodecContext, AVCodecContextDeleter> codec_context{};
@@ -69,7 +73,7 @@ protected:
 
 /**
  * A FFmpegStream used for video data.
- * Rescales, encodes and writes a frame.
+ * Encodes and writes frames that were converted by a FFmpegVideoConverter.
  */
 class FFmpegVideoStream : public FFmpegStream {
 public:
@@ -77,7 +81,27 @@ public:
 
     bool Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout);
     void Free();
-    void ProcessFrame(VideoFrame& frame);
+
+    /// Allocates a frame in the size and pixel format of the encoder. Thread-safe.
+    AVFramePtr AllocateFrame() const;
+
+    /// Encodes a converted frame. Frames must be sent in presentation order.
+    void EncodeFrame(AVFrame* frame, s64 pts);
+
+private:
+    friend class FFmpegVideoConverter;
+
+    Layout::FramebufferLayout layout;
+};
+
+/**
+ * Converts frames to the size and pixel format of the video encoder.
+ * Scaler contexts cannot be shared between threads, so each conversion thread has its own.
+ */
+class FFmpegVideoConverter {
+public:
+    bool Init(const FFmpegVideoStream& stream);
+    bool Convert(VideoFrame& frame, AVFrame* converted_frame);
 
 private:
     struct SwsContextDeleter {
@@ -86,10 +110,6 @@ private:
         }
     };
 
-    u64 frame_count{};
-
-    std::unique_ptr<AVFrame, AVFrameDeleter> current_frame{};
-    std::unique_ptr<AVFrame, AVFrameDeleter> scaled_frame{};
     std::unique_ptr<SwsContext, SwsContextDeleter> sws_context{};
     Layout::FramebufferLayout layout;
 
@@ -121,7 +141,7 @@ private:
     u64 frame_size{};
     u64 frame_count{};
 
-    std::unique_ptr<AVFrame, AVFrameDeleter> audio_frame{};
+    AVFramePtr audio_frame{};
     std::unique_ptr<SwrContext, SwrContextDeleter> swr_context{};
 
     u8** resampled_data{};
@@ -138,7 +158,9 @@ public:
 
     bool Init(const std::string& path, const Layout::FramebufferLayout& layout);
     void Free();
-    void ProcessVideoFrame(VideoFrame& frame);
+    bool InitVideoConverter(FFmpegVideoConverter& converter) const;
+    AVFramePtr AllocateVideoFrame() const;
+    void EncodeVideoFrame(AVFrame* frame, s64 pts);
     void ProcessAudioFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
     void FlushVideo();
     void FlushAudio();
@@ -162,7 +184,8 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * Video frames go through a bounded queue to a pool of colour conversion threads, and are encoded
+ * in order by a single thread. Audio frames are resampled and encoded by another thread.
  */
 class FFmpegBackend : public Backend {
 public:
@@ -177,6 +200,21 @@ public:
     Layout::FramebufferLayout GetLayout() const override;
 
 private:
+    /// A video frame waiting to be converted
+    struct VideoJob {
+        u64 sequence; ///< Position among the frames that were not dropped
+        s64 pts;      ///< Presentation timestamp, which also counts the dropped frames
+        VideoFrame frame;
+    };
+
+    /// A video frame waiting to be encoded
+    struct ConvertedVideoFrame {
+        s64 pts;
+        AVFramePtr frame; ///< Null if the conversion failed
+    };
+
+    void ConversionLoop();
+    void EncodingLoop();
     void EndDumping();
 
     std::atomic_bool is_dumping = false; ///< Whether the backend is currently dumping
@@ -184,9 +222,22 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+
+    /// Protects the video frames in flight and the counters below
+    std::mutex video_mutex;
+    /// Signalled when frames are queued, converted or encoded, and when the input ends
+    std::condition_variable video_cv;
+    std::deque<VideoJob> video_jobs;
+    std::map<u64, ConvertedVideoFrame> converted_video_frames;
+    std::vector<AVFramePtr> free_video_frames; ///< Frames already encoded, for reuse
+    std::size_t video_frames_in_flight = 0;    ///< Frames queued but not encoded yet
+    std::size_t max_video_frames_in_flight = 1;
+    u64 next_video_sequence = 0;
+    s64 next_video_pts = 0;
+    u64 dropped_video_frames = 0;
+    bool video_input_ended = false;
+
+    std::vector<std::thread> video_conversion_threads;
     std::thread video_processing_thread;
 
     std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
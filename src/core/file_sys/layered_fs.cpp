@@ -3,7 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <future>
+#include <thread>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
@@ -18,6 +21,9 @@ SERIALIZE_EXPORT_IMPL(FileSys::LayeredFS)
 
 namespace FileSys {
 
+// Maximum number of replacement files kept open between reads
+constexpr std::size_t MaxOpenReplaceFiles = 32;
+
 struct FileRelocationInfo {
     int type;                      // 0 - none, 1 - replaced / created, 2 - patched, 3 - removed
     u64 original_offset;           // Type 0. Offset is absolute
@@ -200,6 +206,18 @@ void LayeredFS::LoadExtRelocations() {
     FileUtil::FSTEntry result;
     FileUtil::ScanDirectoryTree(patch_ext_path, result, 256);
 
+    // Patches are applied on worker threads, since the RomFS reader itself is not thread safe
+    // only the reads are done here.
+    struct PatchJob {
+        File* file;
+        std::string file_path;
+        bool is_ips;
+        bool result;
+        std::vector<u8> patch;
+        std::vector<u8> buffer;
+    };
+    std::vector<PatchJob> jobs;
+
     for (const auto& entry : result.children) {
         if (FileUtil::IsDirectory(entry.physicalName)) {
             continue;
@@ -237,34 +255,57 @@ void LayeredFS::LoadExtRelocations() {
             }
 
             const auto size = patch_file.GetSize();
-            std::vector<u8> patch(size);
-            if (patch_file.ReadBytes(patch.data(), size) != size) {
+            PatchJob job{};
+            job.patch.resize(size);
+            if (patch_file.ReadBytes(job.patch.data(), size) != size) {
                 LOG_ERROR(Service_FS, "LayeredFS Could not read file {}", entry.physicalName);
                 continue;
             }
 
-            auto& file = *file_path_map[file_path];
-            std::vector<u8> buffer(file.relocation.size); // Original size
-            romfs->ReadFile(file.relocation.original_offset, buffer.size(), buffer.data());
+            job.file = file_path_map[file_path];
+            job.file_path = file_path;
+            job.is_ips = extension == ".ips";
+            job.buffer.resize(job.file->relocation.size); // Original size
+            romfs->ReadFile(job.file->relocation.original_offset, job.buffer.size(),
+                            job.buffer.data());
+            jobs.emplace_back(std::move(job));
+        } else {
+            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+        }
+    }
 
-            bool ret = false;
-            if (extension == ".ips") {
-                ret = Patch::ApplyIpsPatch(patch, buffer);
-            } else {
-                ret = Patch::ApplyBpsPatch(patch, buffer);
-            }
+    // Each job only touches its own buffers, so a fixed set of workers can take them in any order
+    std::atomic<std::size_t> next_job = 0;
+    const auto apply_patches = [&jobs, &next_job] {
+        for (std::size_t index = next_job++; index < jobs.size(); index = next_job++) {
+            auto& job = jobs[index];
+            job.result = job.is_ips ? Patch::ApplyIpsPatch(job.patch, job.buffer)
+                                    : Patch::ApplyBpsPatch(job.patch, job.buffer);
+        }
+    };
+
+    const std::size_t num_threads =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), jobs.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(apply_patches);
+    }
+    apply_patches();
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
-            if (ret) {
-                LOG_INFO(Service_FS, "LayeredFS patched file {}", file_path);
+    // Apply the results in order, so that a later patch for the same file still wins
+    for (auto& job : jobs) {
+        if (job.result) {
+            LOG_INFO(Service_FS, "LayeredFS patched file {}", job.file_path);
 
-                file.relocation.type = 2;
-                file.relocation.size = buffer.size();
-                file.relocation.patched_file = std::move(buffer);
-            } else {
-                LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file_path);
-            }
+            auto& file = *job.file;
+            file.relocation.type = 2;
+            file.relocation.size = job.buffer.size();
+            file.relocation.patched_file = std::move(job.buffer);
         } else {
-            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+            LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", job.file_path);
         }
     }
 }
@@ -329,21 +370,16 @@ void LayeredFS::BuildDirectories() {
     directory_metadata_table.resize(current_directory_offset, 0xFF);
 
     std::size_t written = 0;
-    for (const auto& directory : directory_list) {
+    for (std::size_t i = 0; i < directory_list.size(); i++) {
+        const auto& directory = directory_list[i];
         DirectoryMetadata metadata;
         std::memset(&metadata, 0xFF, sizeof(metadata));
         metadata.parent_directory_offset = directory_metadata_offset_map.at(directory->parent);
 
-        if (directory->parent != directory) {
-            bool flag = false;
-            for (const auto& sibling : directory->parent->directories) {
-                if (flag) {
-                    metadata.next_sibling_offset = directory_metadata_offset_map.at(sibling.get());
-                    break;
-                } else if (sibling.get() == directory) {
-                    flag = true;
-                }
-            }
+        // PrepareBuild lists siblings consecutively, so the next sibling (if any) comes right after
+        if (directory->parent != directory && i + 1 < directory_list.size() &&
+            directory_list[i + 1]->parent == directory->parent) {
+            metadata.next_sibling_offset = directory_metadata_offset_map.at(directory_list[i + 1]);
         }
 
         if (!directory->directories.empty()) {
@@ -379,30 +415,23 @@ void LayeredFS::BuildFiles() {
     file_metadata_table.resize(current_file_offset, 0xFF);
 
     std::size_t written = 0;
-    for (const auto& file : file_list) {
+    for (std::size_t i = 0; i < file_list.size(); i++) {
+        const auto& file = file_list[i];
         FileMetadata metadata;
         std::memset(&metadata, 0xFF, sizeof(metadata));
 
         metadata.parent_directory_offset = directory_metadata_offset_map.at(file->parent);
 
-        bool flag = false;
-        for (const auto& sibling : file->parent->files) {
-            if (sibling->relocation.type == 3) { // removed file
-                continue;
-            }
-            if (flag) {
-                metadata.next_sibling_offset = file_metadata_offset_map.at(sibling.get());
-                break;
-            } else if (sibling.get() == file) {
-                flag = true;
-            }
+        // PrepareBuild lists the (non-removed) files of a directory consecutively
+        if (i + 1 < file_list.size() && file_list[i + 1]->parent == file->parent) {
+            metadata.next_sibling_offset = file_metadata_offset_map.at(file_list[i + 1]);
         }
 
         metadata.file_data_offset = current_data_offset;
         metadata.file_data_length = file->relocation.size;
         current_data_offset += Common::AlignUp(metadata.file_data_length, 16);
         if (metadata.file_data_length != 0) {
-            data_offset_map.emplace(metadata.file_data_offset, file);
+            data_offset_map.emplace_back(metadata.file_data_offset, file);
         }
 
         const auto bucket =
@@ -447,8 +476,11 @@ void LayeredFS::RebuildMetadata() {
     directory_hash_table.resize(GetHashTableSize(directory_list.size()), 0xFFFFFFFF);
     file_hash_table.resize(GetHashTableSize(file_list.size()), 0xFFFFFFFF);
 
-    BuildDirectories();
+    // Both tables only read the offset maps, which are final at this point, so they can be built
+    // concurrently
+    auto directories_built = std::async(std::launch::async, [this] { BuildDirectories(); });
     BuildFiles();
+    directories_built.get();
 
     // Create header
     RomFSHeader header;
@@ -487,6 +519,41 @@ std::size_t LayeredFS::GetSize() const {
     return metadata.size() + current_data_offset;
 }
 
+std::size_t LayeredFS::FindDataIndex(u64 offset) {
+    // Reads are mostly sequential, so check where the last read ended first
+    if (last_data_index < data_offset_map.size() &&
+        data_offset_map[last_data_index].first <= offset &&
+        (last_data_index + 1 == data_offset_map.size() ||
+         offset < data_offset_map[last_data_index + 1].first)) {
+        return last_data_index;
+    }
+
+    const auto it = std::upper_bound(
+        data_offset_map.begin(), data_offset_map.end(), offset,
+        [](u64 value, const std::pair<u64, File*>& entry) { return value < entry.first; });
+    return static_cast<std::size_t>(std::distance(data_offset_map.begin(), it)) - 1;
+}
+
+FileUtil::IOFile* LayeredFS::GetReplaceFile(const File& file) {
+    auto it = std::find_if(replace_files.begin(), replace_files.end(),
+                           [&file](const auto& entry) { return entry.first == &file; });
+    if (it != replace_files.end()) {
+        std::rotate(replace_files.begin(), it, it + 1);
+        return &replace_files.front().second;
+    }
+
+    FileUtil::IOFile replace_file(file.relocation.replace_file_path, "rb");
+    if (!replace_file) {
+        return nullptr;
+    }
+
+    if (replace_files.size() >= MaxOpenReplaceFiles) {
+        replace_files.pop_back();
+    }
+    replace_files.emplace(replace_files.begin(), &file, std::move(replace_file));
+    return &replace_files.front().second;
+}
+
 std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
     ASSERT_MSG(offset + length <= GetSize(), "Out of bound");
 
@@ -501,34 +568,79 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
         offset -= metadata.size();
     }
 
-    // Read files
-    auto current = (--data_offset_map.upper_bound(offset));
-    while (read_size < length) {
-        const auto relative_offset = offset - current->first;
+    if (read_size == length) {
+        return read_size;
+    }
+
+    // Returns the amount of file data and zero padding to read from a file, given the offset
+    // relative to the start of the file and the remaining length of the request
+    const auto get_read_sizes = [](const File& file, std::size_t relative_offset,
+                                   std::size_t remaining) {
         std::size_t to_read{};
-        if (current->second->relocation.size > relative_offset) {
-            to_read = std::min<std::size_t>(current->second->relocation.size - relative_offset,
-                                            length - read_size);
+        if (file.relocation.size > relative_offset) {
+            to_read = std::min<std::size_t>(file.relocation.size - relative_offset, remaining);
         }
         const auto alignment =
-            std::min<std::size_t>(Common::AlignUp(current->second->relocation.size, 16) -
-                                      relative_offset,
-                                  length - read_size) -
+            std::min<std::size_t>(Common::AlignUp(file.relocation.size, 16) - relative_offset,
+                                  remaining) -
             to_read;
+        return std::make_pair(to_read, alignment);
+    };
+
+    // Read files
+    std::size_t current = FindDataIndex(offset);
+    while (read_size < length) {
+        const auto& [data_offset, file] = data_offset_map[current];
+        const auto& relocation = file->relocation;
+        const auto relative_offset = offset - data_offset;
+        const auto [to_read, alignment] =
+            get_read_sizes(*file, relative_offset, length - read_size);
 
         // Read the file in different ways depending on relocation type
-        auto& relocation = current->second->relocation;
         if (relocation.type == 0) { // none
-            romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
+            // Neighbouring unmodified files that kept their original layout are merged into a
+            // single read from the underlying RomFS, and their padding is cleared afterwards.
+            std::size_t run_size = to_read + alignment;
+            std::size_t data_size = to_read;
+            std::size_t run_end = current + 1;
+            while (read_size + run_size < length && run_end < data_offset_map.size()) {
+                const auto& [next_data_offset, next_file] = data_offset_map[run_end];
+                if (next_file->relocation.type != 0 ||
+                    next_file->relocation.original_offset - relocation.original_offset !=
+                        next_data_offset - data_offset) {
+                    break;
+                }
+                const auto [next_read, next_alignment] =
+                    get_read_sizes(*next_file, 0, length - read_size - run_size);
+                data_size = run_size + next_read;
+                run_size += next_read + next_alignment;
+                run_end++;
+            }
+
+            romfs->ReadFile(relocation.original_offset + relative_offset, data_size,
                             buffer + read_size);
-        } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
+
+            std::size_t run_offset = 0;
+            for (std::size_t i = current; i < run_end; i++) {
+                const auto [file_read, file_alignment] = get_read_sizes(
+                    *data_offset_map[i].second, i == current ? relative_offset : 0,
+                    length - read_size - run_offset);
+                std::memset(buffer + read_size + run_offset + file_read, 0, file_alignment);
+                run_offset += file_read + file_alignment;
+            }
+
+            read_size += run_size;
+            offset += run_size;
+            current = run_end;
+            continue;
+        }
+
+        if (relocation.type == 1) { // replace
+            if (auto* replace_file = GetReplaceFile(*file)) {
+                replace_file->Seek(relative_offset, SEEK_SET);
+                replace_file->ReadBytes(buffer + read_size, to_read);
             } else {
-                LOG_ERROR(Service_FS, "Could not open replacement file for {}",
-                          current->second->path);
+                LOG_ERROR(Service_FS, "Could not open replacement file for {}", file->path);
             }
         } else if (relocation.type == 2) { // patch
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
@@ -544,6 +656,8 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
         current++;
     }
 
+    // Remember the file the read ended in for the next sequential read
+    last_data_index = current > 0 ? current - 1 : 0;
     return read_size;
 }
 
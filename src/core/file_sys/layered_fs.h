@@ -4,10 +4,10 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
@@ -100,6 +100,12 @@ private:
 
     void Load();
 
+    // Returns the index in data_offset_map of the file containing the given data offset
+    std::size_t FindDataIndex(u64 offset);
+
+    // Returns an open handle to the replacement file of a relocated file, or nullptr on failure
+    FileUtil::IOFile* GetReplaceFile(const File& file);
+
     std::shared_ptr<RomFSReader> romfs;
     std::string patch_path;
     std::string patch_ext_path;
@@ -109,8 +115,12 @@ private:
     Directory root;
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
-    std::map<u64, File*> data_offset_map; // assigned data offset -> file
-    std::vector<u8> metadata;             // Includes header, hash table and metadata
+    std::vector<std::pair<u64, File*>> data_offset_map; // assigned data offset -> file, sorted
+    std::size_t last_data_index{};                      // file the last read ended in
+    std::vector<u8> metadata; // Includes header, hash table and metadata
+
+    // Open replacement files, most recently used first
+    std::vector<std::pair<const File*, FileUtil::IOFile>> replace_files;
 
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
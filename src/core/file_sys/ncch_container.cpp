@@ -5,6 +5,7 @@
 #include <cinttypes>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
@@ -26,6 +27,10 @@ namespace FileSys {
 static const int kMaxSections = 8;   ///< Maximum number of sections (files) in an ExeFs
 static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
 
+/// Serializes deriving keys through the shared NCCH key slots, as containers may be loaded on
+/// several threads at once by the game list
+static std::mutex key_slot_mutex;
+
 u64 GetModId(u64 program_id) {
     constexpr u64 UPDATE_MASK = 0x0000000e'00000000;
     if ((program_id & 0x000000ff'00000000) == UPDATE_MASK) { // Apply the mods to updates
@@ -212,6 +217,7 @@ Loader::ResultStatus NCCHContainer::Load() {
             } else {
                 using namespace HW::AES;
                 InitKeys();
+                std::lock_guard lock{key_slot_mutex};
                 std::array<u8, 16> key_y_primary, key_y_secondary;
 
                 std::copy(ncch_header.signature, ncch_header.signature + key_y_primary.size(),
@@ -426,6 +432,7 @@ Loader::ResultStatus NCCHContainer::Load() {
             }
 
             exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_mapping = FileUtil::MappedFile(filepath);
             has_exefs = true;
         }
 
@@ -458,11 +465,13 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
 
         if (exefs_file.ReadBytes(&exefs_header, sizeof(ExeFs_Header)) == sizeof(ExeFs_Header)) {
             LOG_DEBUG(Service_FS, "Loading ExeFS section from {}", exefs_override);
+            exefs_mapping = FileUtil::MappedFile(exefs_override);
             exefs_offset = 0;
             is_tainted = true;
             has_exefs = true;
         } else {
             exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_mapping = FileUtil::MappedFile(filepath);
         }
     } else if (FileUtil::Exists(exefsdir_override) && FileUtil::IsDirectory(exefsdir_override)) {
         is_tainted = true;
@@ -524,6 +533,13 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
             exefs_file.Seek(section_offset, SEEK_SET);
 
+            // When the ExeFS is mapped, read the section straight out of the page cache
+            const u8* mapped_section = nullptr;
+            if (exefs_mapping.IsOpen() &&
+                static_cast<u64>(section_offset) + section.size <= exefs_mapping.GetSize()) {
+                mapped_section = exefs_mapping.GetData() + section_offset;
+            }
+
             std::array<u8, 16> key;
             if (strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0) {
                 key = primary_key;
@@ -537,30 +553,42 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
+                const u8* compressed = mapped_section;
                 std::unique_ptr<u8[]> temp_buffer;
-                try {
-                    temp_buffer.reset(new u8[section.size]);
-                } catch (std::bad_alloc&) {
-                    return Loader::ResultStatus::ErrorMemoryAllocationFailed;
-                }
+                if (!compressed || is_encrypted) {
+                    // Decryption can not be done in place on the read-only mapping
+                    try {
+                        temp_buffer.reset(new u8[section.size]);
+                    } catch (std::bad_alloc&) {
+                        return Loader::ResultStatus::ErrorMemoryAllocationFailed;
+                    }
 
-                if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
-                    return Loader::ResultStatus::Error;
+                    if (mapped_section) {
+                        std::memcpy(&temp_buffer[0], mapped_section, section.size);
+                    } else if (exefs_file.ReadBytes(&temp_buffer[0], section.size) !=
+                               section.size) {
+                        return Loader::ResultStatus::Error;
+                    }
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    if (is_encrypted) {
+                        dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    }
+                    compressed = &temp_buffer[0];
                 }
 
                 // Decompress .code section...
-                u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
+                u32 decompressed_size = LZSS_GetDecompressedSize(compressed, section.size);
                 buffer.resize(decompressed_size);
-                if (!LZSS_Decompress(&temp_buffer[0], section.size, &buffer[0], decompressed_size))
+                if (!LZSS_Decompress(compressed, section.size, &buffer[0], decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
-                if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size)
+                if (mapped_section) {
+                    std::memcpy(&buffer[0], mapped_section, section.size);
+                } else if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size) {
                     return Loader::ResultStatus::Error;
+                }
                 if (is_encrypted) {
                     dec.ProcessData(&buffer[0], &buffer[0], section.size);
                 }
@@ -676,19 +704,30 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
     if (file.GetSize() < romfs_offset + romfs_size)
         return Loader::ResultStatus::Error;
 
-    // We reopen the file, to allow its position to be independent from file's
-    FileUtil::IOFile romfs_file_inner(filepath, "rb");
-    if (!romfs_file_inner.IsOpen())
-        return Loader::ResultStatus::Error;
-
     std::shared_ptr<RomFSReader> direct_romfs;
-    if (is_encrypted) {
-        direct_romfs =
-            std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner), romfs_offset,
-                                                romfs_size, secondary_key, romfs_ctr, 0x1000);
-    } else {
-        direct_romfs = std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner),
-                                                           romfs_offset, romfs_size);
+    if (!is_encrypted) {
+        // Decrypted RomFS can be read straight out of a mapping of the file
+        FileUtil::MappedFile romfs_mapping(filepath);
+        if (romfs_mapping.IsOpen()) {
+            direct_romfs = std::make_shared<MappedRomFSReader>(std::move(romfs_mapping),
+                                                               romfs_offset, romfs_size);
+        }
+    }
+
+    if (!direct_romfs) {
+        // We reopen the file, to allow its position to be independent from file's
+        FileUtil::IOFile romfs_file_inner(filepath, "rb");
+        if (!romfs_file_inner.IsOpen())
+            return Loader::ResultStatus::Error;
+
+        if (is_encrypted) {
+            direct_romfs =
+                std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner), romfs_offset,
+                                                    romfs_size, secondary_key, romfs_ctr, 0x1000);
+        } else {
+            direct_romfs = std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner),
+                                                               romfs_offset, romfs_size);
+        }
     }
 
     const auto path =
@@ -725,6 +764,16 @@ Loader::ResultStatus NCCHContainer::ReadOverrideRomFS(std::shared_ptr<RomFSReade
     // Check for RomFS overrides
     std::string split_filepath = filepath + ".romfs";
     if (FileUtil::Exists(split_filepath)) {
+        FileUtil::MappedFile romfs_mapping(split_filepath);
+        if (romfs_mapping.IsOpen()) {
+            LOG_WARNING(Service_FS, "File {} overriding built-in RomFS; LayeredFS not enabled",
+                        split_filepath);
+            const std::size_t romfs_size = romfs_mapping.GetSize();
+            romfs_file =
+                std::make_shared<MappedRomFSReader>(std::move(romfs_mapping), 0, romfs_size);
+            return Loader::ResultStatus::Success;
+        }
+
         FileUtil::IOFile romfs_file_inner(split_filepath, "rb");
         if (romfs_file_inner.IsOpen()) {
             LOG_WARNING(Service_FS, "File {} overriding built-in RomFS; LayeredFS not enabled",
@@ -370,6 +370,7 @@ private:
     std::string filepath;
     FileUtil::IOFile file;
     FileUtil::IOFile exefs_file;
+    FileUtil::MappedFile exefs_mapping;
 };
 
 } // namespace FileSys
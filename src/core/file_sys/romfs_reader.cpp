@@ -1,25 +1,93 @@
 #include <algorithm>
+#include <cstring>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
 #include "core/file_sys/romfs_reader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
+SERIALIZE_EXPORT_IMPL(FileSys::MappedRomFSReader)
 
 namespace FileSys {
 
+struct DirectRomFSReader::Decryptor {
+    // Crypto++ picks the AES-NI/ARMv8 implementation at runtime when available and processes CTR
+    // blocks in parallel, so keeping the key schedule around is all we need here.
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption aes;
+};
+
+DirectRomFSReader::DirectRomFSReader() = default;
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size)
+    : is_encrypted(false), file(std::move(file)), file_offset(file_offset), data_size(data_size) {}
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size, const std::array<u8, 16>& key,
+                                     const std::array<u8, 16>& ctr, std::size_t crypto_offset)
+    : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
+      crypto_offset(crypto_offset), data_size(data_size) {}
+
+DirectRomFSReader::~DirectRomFSReader() = default;
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
+    if (length == 0 || offset >= data_size)
         return 0; // Crypto++ does not like zero size buffer
+    length = std::min(length, static_cast<std::size_t>(data_size) - offset);
+
+    if (length >= READ_AHEAD_SIZE) {
+        return ReadFromFile(offset, length, buffer);
+    }
+
+    std::size_t read_length = 0;
+    while (read_length < length) {
+        const std::size_t current_offset = offset + read_length;
+        if (current_offset < cache_offset || current_offset >= cache_offset + cache_size) {
+            FillCache(current_offset);
+            if (current_offset >= cache_offset + cache_size) {
+                break; // The file is shorter than advertised
+            }
+        }
+
+        const std::size_t copy_length =
+            std::min(length - read_length,
+                     static_cast<std::size_t>(cache_offset + cache_size - current_offset));
+        std::memcpy(buffer + read_length, cache.data() + (current_offset - cache_offset),
+                    copy_length);
+        read_length += copy_length;
+    }
+    return read_length;
+}
+
+std::size_t DirectRomFSReader::ReadFromFile(std::size_t offset, std::size_t length, u8* buffer) {
     file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+    const std::size_t read_length = file.ReadBytes(buffer, length);
+    if (is_encrypted && read_length != 0) {
+        if (!decryptor) {
+            decryptor = std::make_unique<Decryptor>();
+            decryptor->aes.SetKeyWithIV(key.data(), key.size(), ctr.data());
+        }
+        decryptor->aes.Seek(crypto_offset + offset);
+        decryptor->aes.ProcessData(buffer, buffer, read_length);
     }
     return read_length;
 }
 
+void DirectRomFSReader::FillCache(std::size_t offset) {
+    if (cache.empty()) {
+        cache.resize(READ_AHEAD_SIZE);
+    }
+    cache_offset = offset - offset % READ_AHEAD_SIZE;
+    const std::size_t length =
+        std::min(READ_AHEAD_SIZE, static_cast<std::size_t>(data_size - cache_offset));
+    cache_size = ReadFromFile(cache_offset, length, cache.data());
+}
+
+std::size_t MappedRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
+    if (offset >= data_size)
+        return 0;
+    length = std::min(length, static_cast<std::size_t>(data_size) - offset);
+    return file.ReadBytes(file_offset + offset, buffer, length);
+}
+
 } // namespace FileSys
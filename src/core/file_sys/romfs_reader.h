@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
@@ -27,20 +29,18 @@ private:
 
 /**
  * A RomFS reader that directly reads the RomFS file.
+ * Small reads are served from a block-aligned read-ahead cache of decrypted data, and the AES-CTR
+ * key schedule is kept across reads for encrypted RomFS.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
-    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size);
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                      std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                      std::size_t crypto_offset);
 
-    ~DirectRomFSReader() override = default;
+    ~DirectRomFSReader() override;
 
     std::size_t GetSize() const override {
         return data_size;
@@ -49,6 +49,15 @@ public:
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
 
 private:
+    /// Size and alignment of the read-ahead cache. Reads of at least this size bypass the cache.
+    static constexpr std::size_t READ_AHEAD_SIZE = 0x20000;
+
+    /// Reads and decrypts data straight from the file, bypassing the read-ahead cache.
+    std::size_t ReadFromFile(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Refills the read-ahead cache with the aligned window containing the given offset.
+    void FillCache(std::size_t offset);
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -57,7 +66,16 @@ private:
     u64 crypto_offset;
     u64 data_size;
 
-    DirectRomFSReader() = default;
+    // Persistent AES-CTR decryption state. This is lazily created and not serialized.
+    struct Decryptor;
+    std::unique_ptr<Decryptor> decryptor;
+
+    // Decrypted read-ahead cache. This is not serialized and starts out empty after loading.
+    std::vector<u8> cache;
+    u64 cache_offset = 0;
+    std::size_t cache_size = 0;
+
+    DirectRomFSReader();
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -73,6 +91,42 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * A RomFS reader for unencrypted RomFS that reads through a memory mapping of the file, so that
+ * each read is a single copy out of the host page cache.
+ */
+class MappedRomFSReader : public RomFSReader {
+public:
+    MappedRomFSReader(FileUtil::MappedFile&& file, std::size_t file_offset,
+                      std::size_t data_size)
+        : file(std::move(file)), file_offset(file_offset), data_size(data_size) {}
+
+    ~MappedRomFSReader() override = default;
+
+    std::size_t GetSize() const override {
+        return data_size;
+    }
+
+    std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
+
+private:
+    FileUtil::MappedFile file;
+    u64 file_offset;
+    u64 data_size;
+
+    MappedRomFSReader() = default;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<RomFSReader>(*this);
+        ar& file;
+        ar& file_offset;
+        ar& data_size;
+    }
+    friend class boost::serialization::access;
+};
+
 } // namespace FileSys
 
 BOOST_CLASS_EXPORT_KEY(FileSys::DirectRomFSReader)
+BOOST_CLASS_EXPORT_KEY(FileSys::MappedRomFSReader)
@@ -89,6 +89,25 @@ public:
         return DynamicObjectCast<T>(GetGeneric(handle));
     }
 
+    /**
+     * Looks up a handle without taking a reference to the object. The pointer is only valid as
+     * long as the handle stays open, so this is meant for SVC handlers that do not keep the object
+     * past the call.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid.
+     */
+    Object* GetGenericPointer(Handle handle) const;
+
+    /**
+     * Looks up a handle while verifying its type, without taking a reference to the object.
+     * @see GetGenericPointer
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid or its
+     *         type differs from the requested one.
+     */
+    template <class T>
+    T* GetPointer(Handle handle) const {
+        return DynamicObjectCast<T>(GetGenericPointer(handle));
+    }
+
     /// Closes all handles held in this table.
     void Clear();
 
@@ -12,6 +12,8 @@
 
 namespace Kernel {
 
+constexpr std::size_t INITIAL_VMA_CAPACITY = 128;
+
 static const char* GetMemoryStateName(MemoryState state) {
     static const char* names[] = {
         "Free",   "Reserved",   "IO",      "Static", "Code",      "Private",
@@ -39,6 +41,8 @@ bool VirtualMemoryArea::CanBeMergedWith(const VirtualMemoryArea& next) const {
 
 VMManager::VMManager(Memory::MemorySystem& memory)
     : page_table(std::make_shared<Memory::PageTable>()), memory(memory) {
+    // Enough for the VMAs of a typical process, so that splitting VMAs does not allocate
+    vma_map.reserve(INITIAL_VMA_CAPACITY);
     Reset();
 }
 
@@ -53,6 +57,7 @@ void VMManager::Reset() {
     VirtualMemoryArea initial_vma;
     initial_vma.size = MAX_ADDRESS;
     vma_map.emplace(initial_vma.base, initial_vma);
+    last_lookup = 0;
 
     page_table->Clear();
 
@@ -62,9 +67,19 @@ void VMManager::Reset() {
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+
+    // As the VMAs cover the whole address space, any VMA containing the target is the right one
+    if (last_lookup < vma_map.size()) {
+        const VMAHandle hint = vma_map.nth(last_lookup);
+        if (target >= hint->second.base && target - hint->second.base < hint->second.size) {
+            return hint;
+        }
+    }
+
+    const VMAHandle vma = std::prev(vma_map.upper_bound(target));
+    last_lookup = vma_map.index_of(vma);
+    return vma;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, MemoryRef memory,
@@ -163,10 +178,9 @@ ResultCode VMManager::ChangeMemoryState(VAddr target, u32 size, MemoryState expe
 
     CASCADE_RESULT(auto vma, CarveVMARange(target, size));
 
-    const VMAIter end = vma_map.end();
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
-    while (vma != end && vma->second.base < target_end) {
+    while (vma != vma_map.end() && vma->second.base < target_end) {
         vma->second.permissions = new_perms;
         vma->second.meminfo_state = new_state;
         UpdatePageTableForVMA(vma->second);
@@ -198,10 +212,9 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
     CASCADE_RESULT(VMAIter vma, CarveVMARange(target, size));
     const VAddr target_end = target + size;
 
-    const VMAIter end = vma_map.end();
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
-    while (vma != end && vma->second.base < target_end) {
+    while (vma != vma_map.end() && vma->second.base < target_end) {
         vma = std::next(Unmap(vma));
     }
 
@@ -227,10 +240,9 @@ ResultCode VMManager::ReprotectRange(VAddr target, u32 size, VMAPermission new_p
     CASCADE_RESULT(VMAIter vma, CarveVMARange(target, size));
     const VAddr target_end = target + size;
 
-    const VMAIter end = vma_map.end();
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
-    while (vma != end && vma->second.base < target_end) {
+    while (vma != vma_map.end() && vma->second.base < target_end) {
         vma = std::next(StripIterConstness(Reprotect(vma, new_perms)));
     }
 
@@ -284,8 +296,9 @@ ResultVal<VMManager::VMAIter> VMManager::CarveVMA(VAddr base, u32 size) {
     }
 
     if (end_in_vma != vma.size) {
-        // Split VMA at the end of the allocated region
-        SplitVMA(vma_handle, end_in_vma);
+        // Split VMA at the end of the allocated region. This invalidates vma_handle, which is
+        // right before the new VMA.
+        vma_handle = std::prev(SplitVMA(vma_handle, end_in_vma));
     }
     if (start_in_vma != 0) {
         // Split VMA at the start of the allocated region
@@ -317,7 +330,9 @@ ResultVal<VMManager::VMAIter> VMManager::CarveVMARange(VAddr target, u32 size) {
 
     VMAIter end_vma = StripIterConstness(FindVMA(target_end));
     if (end_vma != vma_map.end() && target_end != end_vma->second.base) {
-        end_vma = SplitVMA(end_vma, target_end - end_vma->second.base);
+        SplitVMA(end_vma, target_end - end_vma->second.base);
+        // Inserting the new VMA invalidated the iterators
+        begin_vma = StripIterConstness(FindVMA(target));
     }
 
     return MakeResult<VMAIter>(begin_vma);
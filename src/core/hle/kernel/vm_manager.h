@@ -8,6 +8,7 @@
 #include <memory>
 #include <utility>
 #include <vector>
+#include <boost/container/flat_map.hpp>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/split_member.hpp>
@@ -127,9 +128,15 @@ public:
      * `elem.base + elem.size == next.base` is preserved, and mergeable regions must always be
      * merged when possible so that no two similar and adjacent regions exist that have not been
      * merged.
+     *
+     * The VMAs are kept in a sorted vector: a process only has a few dozen of them, which makes
+     * lookups cache friendly and splitting or merging them free of allocations once the storage
+     * has been reserved. Like with a vector, inserting or erasing VMAs invalidates the iterators
+     * past the modified position.
      */
-    std::map<VAddr, VirtualMemoryArea> vma_map;
+    boost::container::flat_map<VAddr, VirtualMemoryArea> vma_map;
     using VMAHandle = decltype(vma_map)::const_iterator;
+    using VMAReverseHandle = decltype(vma_map)::const_reverse_iterator;
 
     explicit VMManager(Memory::MemorySystem& memory);
     ~VMManager();
@@ -137,7 +144,10 @@ public:
     /// Clears the address space map, re-initializing with a single free area.
     void Reset();
 
-    /// Finds the VMA in which the given address is included in, or `vma_map.end()`.
+    /**
+     * Finds the VMA in which the given address is included in, or `vma_map.end()`. The VMA found
+     * last is checked first, as lookups tend to hit the same region repeatedly.
+     */
     VMAHandle FindVMA(VAddr target) const;
 
     // TODO(yuriks): Should these functions actually return the handle?
@@ -255,18 +265,34 @@ private:
 
     Memory::MemorySystem& memory;
 
+    /// Index in vma_map of the VMA returned by the last FindVMA call. It is only a hint, and is
+    /// validated against the target address before use.
+    mutable std::size_t last_lookup{};
+
     // When locked, ChangeMemoryState calls will be ignored, other modification calls will hit an
     // assert. VMManager locks itself after deserialization.
     bool is_locked{};
 
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
-        ar& vma_map;
-        ar& page_table;
-        if (Archive::is_loading::value) {
-            is_locked = true;
-        }
+    void save(Archive& ar, const unsigned int) const {
+        // Saved as a std::map, so that the savestate format does not depend on the container
+        const std::map<VAddr, VirtualMemoryArea> vmas(vma_map.begin(), vma_map.end());
+        ar << vmas;
+        ar << page_table;
     }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int) {
+        std::map<VAddr, VirtualMemoryArea> vmas;
+        ar >> vmas;
+        vma_map.clear();
+        vma_map.insert(boost::container::ordered_unique_range, vmas.begin(), vmas.end());
+        last_lookup = 0;
+        ar >> page_table;
+        is_locked = true;
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
     friend class boost::serialization::access;
 };
 } // namespace Kernel
@@ -81,4 +81,12 @@ inline std::shared_ptr<WaitObject> DynamicObjectCast<WaitObject>(std::shared_ptr
     return nullptr;
 }
 
+template <>
+inline WaitObject* DynamicObjectCast<WaitObject>(Object* object) {
+    if (object != nullptr && object->IsWaitable()) {
+        return static_cast<WaitObject*>(object);
+    }
+    return nullptr;
+}
+
 } // namespace Kernel
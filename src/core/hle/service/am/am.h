@@ -567,7 +567,10 @@ public:
     };
 
 private:
-    explicit Module(Kernel::KernelSystem& kernel);
+    /// Tag for constructing an empty module that is filled in by loading a savestate.
+    struct SavestateTag {};
+
+    Module(Core::System& system, SavestateTag);
 
     /**
      * Scans the for titles in a storage medium for listing.
@@ -580,7 +583,7 @@ private:
      */
     void ScanForAllTitles();
 
-    Kernel::KernelSystem& kernel;
+    Core::System& system;
     bool cia_installing = false;
     std::array<std::vector<u64_le>, 3> am_title_list;
     std::shared_ptr<Kernel::Mutex> system_updater_mutex;
@@ -594,7 +597,7 @@ private:
 
     template <class Archive>
     static void load_construct(Archive& ar, Module* t, const unsigned int file_version) {
-        ::new (t) Module(Core::Global<Kernel::KernelSystem>());
+        ::new (t) Module(Core::Global<Core::System>(), SavestateTag{});
     }
 
     template <class Archive>
@@ -0,0 +1,117 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/logging/log.h"
+#include "core/hle/service/call_stats.h"
+
+namespace Service {
+
+CallStats::Command::Command(std::string service_name, std::string function_name, u32 header_code)
+    : service_name(std::move(service_name)), function_name(std::move(function_name)),
+      header_code(header_code) {}
+
+void CallStats::Command::Record(Clock::duration time) {
+    const u64 ns =
+        static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+    const u64 us = ns / 1000;
+
+    std::size_t bucket = 0;
+    for (u64 bound = 1; bucket < NumBuckets - 1 && us >= bound; bound <<= 1) {
+        ++bucket;
+    }
+
+    calls.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    u64 max = max_ns.load(std::memory_order_relaxed);
+    while (ns > max && !max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::microseconds CallStats::CommandResults::GetPercentile(double percentile) const {
+    const u64 target = static_cast<u64>(calls * percentile / 100.0);
+    u64 count = 0;
+    for (std::size_t bucket = 0; bucket < NumBuckets; ++bucket) {
+        count += histogram[bucket];
+        if (count > target) {
+            return std::chrono::microseconds{u64{1} << bucket};
+        }
+    }
+    return std::chrono::microseconds{u64{1} << (NumBuckets - 1)};
+}
+
+CallStats::Command& CallStats::GetCommand(const std::string& service_name,
+                                          const std::string& function_name, u32 header_code) {
+    std::lock_guard lock{mutex};
+    auto itr = commands.find({service_name, header_code});
+    if (itr == commands.end()) {
+        itr = commands
+                  .emplace(std::piecewise_construct, std::forward_as_tuple(service_name, header_code),
+                           std::forward_as_tuple(service_name, function_name, header_code))
+                  .first;
+    }
+    return itr->second;
+}
+
+std::vector<CallStats::CommandResults> CallStats::GetResults() const {
+    std::vector<CommandResults> results;
+    {
+        std::lock_guard lock{mutex};
+        for (const auto& [key, command] : commands) {
+            const u64 calls = command.calls.load(std::memory_order_relaxed);
+            if (calls == 0) {
+                continue;
+            }
+
+            CommandResults& result = results.emplace_back();
+            result.service_name = command.service_name;
+            result.function_name = command.function_name;
+            result.header_code = command.header_code;
+            result.calls = calls;
+            result.total_time =
+                std::chrono::nanoseconds{command.total_ns.load(std::memory_order_relaxed)};
+            result.max_time =
+                std::chrono::nanoseconds{command.max_ns.load(std::memory_order_relaxed)};
+            for (std::size_t bucket = 0; bucket < NumBuckets; ++bucket) {
+                result.histogram[bucket] =
+                    command.histogram[bucket].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+        return a.total_time > b.total_time;
+    });
+    return results;
+}
+
+void CallStats::Reset() {
+    std::lock_guard lock{mutex};
+    for (auto& [key, command] : commands) {
+        command.calls = 0;
+        command.total_ns = 0;
+        command.max_ns = 0;
+        for (auto& count : command.histogram) {
+            count = 0;
+        }
+    }
+}
+
+void CallStats::LogSummary(std::size_t max_commands) const {
+    const std::vector<CommandResults> results = GetResults();
+    LOG_INFO(Service, "HLE service commands by host time ({} commands called):", results.size());
+    for (std::size_t i = 0; i < std::min(max_commands, results.size()); ++i) {
+        const CommandResults& result = results[i];
+        const double total_ms = result.total_time.count() / 1000000.0;
+        LOG_INFO(Service,
+                 "  {}::{} (0x{:08X}): {} calls, {:.3f} ms total, {:.2f} us mean, p99 < {} us, "
+                 "max {:.2f} us",
+                 result.service_name, result.function_name, result.header_code, result.calls,
+                 total_ms, total_ms * 1000.0 / result.calls,
+                 result.GetPercentile(99).count(), result.max_time.count() / 1000.0);
+    }
+}
+
+} // namespace Service
@@ -0,0 +1,91 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service {
+
+/**
+ * Counts the HLE service commands handled and the host time spent in their handlers, per service
+ * and command. All public functions of this class are thread-safe.
+ */
+class CallStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Number of buckets of the handler time histograms. Bucket 0 counts calls that took less than
+     * 1us, bucket i calls that took [2^(i-1), 2^i) us, and the last bucket every longer call.
+     */
+    static constexpr std::size_t NumBuckets = 16;
+
+    /// Counters of a single command, updated by the emulation thread without locking
+    class Command {
+    public:
+        Command(std::string service_name, std::string function_name, u32 header_code);
+
+        void Record(Clock::duration time);
+
+    private:
+        friend class CallStats;
+
+        const std::string service_name;
+        const std::string function_name;
+        const u32 header_code;
+
+        std::atomic<u64> calls{0};
+        std::atomic<u64> total_ns{0};
+        std::atomic<u64> max_ns{0};
+        std::array<std::atomic<u64>, NumBuckets> histogram{};
+    };
+
+    /// Statistics of a command at the time they were queried
+    struct CommandResults {
+        std::string service_name;
+        std::string function_name;
+        u32 header_code;
+        u64 calls;
+        std::chrono::nanoseconds total_time;
+        std::chrono::nanoseconds max_time;
+        std::array<u64, NumBuckets> histogram;
+
+        /// Estimates a percentile of the handler time from the histogram, as a bucket upper bound
+        std::chrono::microseconds GetPercentile(double percentile) const;
+    };
+
+    /**
+     * Returns the counters of a command, creating them the first time. The returned reference stays
+     * valid for the lifetime of this object, so callers can keep it to skip the lookup.
+     */
+    Command& GetCommand(const std::string& service_name, const std::string& function_name,
+                        u32 header_code);
+
+    /// Returns the statistics of every command called at least once, most host time first
+    std::vector<CommandResults> GetResults() const;
+
+    /// Clears the counters of every command
+    void Reset();
+
+    /// Writes the commands that took the most host time to the log
+    void LogSummary(std::size_t max_commands) const;
+
+private:
+    mutable std::mutex mutex;
+    /// Indexed by service name and header code. Map nodes never move, so Command references stay
+    /// valid.
+    std::map<std::pair<std::string, u32>, Command> commands;
+};
+
+} // namespace Service
@@ -42,6 +42,8 @@ MediaType GetMediaTypeFromPath(std::string_view path) {
 }
 
 ArchiveBackend* ArchiveManager::GetArchive(ArchiveHandle handle) {
+    // Archive operations may touch files that still have host I/O in flight.
+    async_io.WaitIdle();
     auto itr = handle_map.find(handle);
     return (itr == handle_map.end()) ? nullptr : itr->second.get();
 }
@@ -103,7 +105,7 @@ ArchiveManager::OpenFileFromArchive(ArchiveHandle archive_handle, const FileSys:
         return std::make_pair(backend.Code(), open_timeout_ns);
     }
 
-    auto file = std::make_shared<File>(system.Kernel(), std::move(backend).Unwrap(), path);
+    auto file = std::make_shared<File>(system, std::move(backend).Unwrap(), path);
     return std::make_pair(MakeResult(std::move(file)), open_timeout_ns);
 }
 
@@ -218,6 +220,7 @@ ResultCode ArchiveManager::FormatArchive(ArchiveIdCode id_code,
         return UnimplementedFunction(ErrorModule::FS); // TODO(Subv): Find the right error
     }
 
+    async_io.WaitIdle();
     return archive_itr->second->Format(path, format_info, program_id);
 }
 
@@ -275,6 +278,7 @@ ResultCode ArchiveManager::DeleteExtSaveData(MediaType media_type, u32 high, u32
     std::string base_path =
         FileSys::GetExtDataContainerPath(media_type_directory, media_type == MediaType::NAND);
     std::string extsavedata_path = FileSys::GetExtSaveDataPath(base_path, path);
+    async_io.WaitIdle();
     if (FileUtil::Exists(extsavedata_path) && !FileUtil::DeleteDirRecursively(extsavedata_path))
         return ResultCode(-1); // TODO(Subv): Find the right error code
     return RESULT_SUCCESS;
@@ -287,6 +291,7 @@ ResultCode ArchiveManager::DeleteSystemSaveData(u32 high, u32 low) {
     const std::string& nand_directory = FileUtil::GetUserPath(FileUtil::UserPath::NANDDir);
     const std::string base_path = FileSys::GetSystemSaveDataContainerPath(nand_directory);
     const std::string systemsavedata_path = FileSys::GetSystemSaveDataPath(base_path, path);
+    async_io.WaitIdle();
     if (!FileUtil::DeleteDirRecursively(systemsavedata_path)) {
         return ResultCode(-1); // TODO(Subv): Find the right error code
     }
@@ -382,7 +387,7 @@ void ArchiveManager::RegisterSelfNCCH(Loader::AppLoader& app_loader) {
     factory->Register(app_loader);
 }
 
-ArchiveManager::ArchiveManager(Core::System& system) : system(system) {
+ArchiveManager::ArchiveManager(Core::System& system) : system(system), async_io(system) {
     RegisterArchiveTypes();
 }
 
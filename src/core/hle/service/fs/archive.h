@@ -10,9 +10,11 @@
 #include <vector>
 #include <boost/serialization/unique_ptr.hpp>
 #include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/result.h"
+#include "core/hle/service/fs/async_io.h"
 #include "core/hle/service/fs/directory.h"
 #include "core/hle/service/fs/file.h"
 
@@ -257,9 +259,16 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /// Returns the manager that runs host file I/O for File sessions off the emulation thread
+    AsyncIOManager& GetAsyncIO() {
+        return async_io;
+    }
+
 private:
     Core::System& system;
 
+    AsyncIOManager async_io;
+
     /**
      * Registers an Archive type, instances of which can later be opened using its IdCode.
      * @param factory File system backend interface to the archive
@@ -286,12 +295,17 @@ private:
     ArchiveHandle next_handle = 1;
 
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
+    void serialize(Archive& ar, const unsigned int file_version) {
         ar& id_code_map;
         ar& handle_map;
         ar& next_handle;
+        if (file_version > 0) {
+            ar& async_io;
+        }
     }
     friend class boost::serialization::access;
 };
 
 } // namespace Service::FS
+
+BOOST_CLASS_VERSION(Service::FS::ArchiveManager, 1)
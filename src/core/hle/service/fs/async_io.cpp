@@ -0,0 +1,118 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include "common/archives.h"
+#include "common/thread.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/service/fs/async_io.h"
+
+namespace Service::FS {
+
+/// Emulated time between checks on an operation that outlasted its emulated delay
+constexpr int CompletionPollIntervalUs = 100;
+
+template <class Archive>
+void AsyncIOManager::Request::serialize(Archive& ar, const unsigned int) {
+    ar& event;
+}
+
+template <class Archive>
+void AsyncIOManager::serialize(Archive& ar, const unsigned int) {
+    // Results of in-flight operations are stored by their wakeup callbacks, so every operation
+    // has to finish before those are saved.
+    WaitIdle();
+    ar& pending_requests;
+    ar& next_request_id;
+}
+SERIALIZE_IMPL(AsyncIOManager)
+
+AsyncIOManager::AsyncIOManager(Core::System& system) : system(system) {
+    completion_event = system.CoreTiming().RegisterEvent(
+        "FS::AsyncIOCompletion",
+        [this](u64 request_id, s64 cycles_late) { OnCompletion(request_id, cycles_late); });
+    worker = std::thread([this] { WorkerLoop(); });
+}
+
+AsyncIOManager::~AsyncIOManager() {
+    {
+        std::lock_guard lock{queue_mutex};
+        stop = true;
+    }
+    queue_cv.notify_one();
+    worker.join();
+}
+
+std::shared_future<void> AsyncIOManager::Submit(std::function<void()> task,
+                                                std::shared_ptr<Kernel::Event> event,
+                                                std::chrono::nanoseconds delay) {
+    std::packaged_task<void()> packaged_task(std::move(task));
+    std::shared_future<void> done = packaged_task.get_future().share();
+    {
+        std::lock_guard lock{queue_mutex};
+        queue.push_back(std::move(packaged_task));
+        ++tasks_in_flight;
+    }
+    queue_cv.notify_one();
+
+    const u64 request_id = next_request_id++;
+    pending_requests.emplace(request_id, Request{std::move(event), done});
+    system.CoreTiming().ScheduleEvent(nsToCycles(static_cast<s64>(delay.count())),
+                                      completion_event, request_id);
+    return done;
+}
+
+void AsyncIOManager::WaitIdle() {
+    std::unique_lock lock{queue_mutex};
+    idle_cv.wait(lock, [this] { return tasks_in_flight == 0; });
+}
+
+void AsyncIOManager::WorkerLoop() {
+    Common::SetCurrentThreadName("FS:AsyncIO");
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock lock{queue_mutex};
+            queue_cv.wait(lock, [this] { return stop || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        task();
+
+        {
+            std::lock_guard lock{queue_mutex};
+            --tasks_in_flight;
+        }
+        idle_cv.notify_all();
+    }
+}
+
+void AsyncIOManager::OnCompletion(u64 request_id, s64 cycles_late) {
+    auto itr = pending_requests.find(request_id);
+    if (itr == pending_requests.end()) {
+        return;
+    }
+
+    const std::shared_future<void>& done = itr->second.done;
+    if (done.valid() && done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        // The host is slower than the emulated delay, keep the guest thread parked and check
+        // again later instead of blocking the emulation thread.
+        system.CoreTiming().ScheduleEvent(usToCycles(CompletionPollIntervalUs) - cycles_late,
+                                          completion_event, request_id);
+        return;
+    }
+
+    std::shared_ptr<Kernel::Event> event = std::move(itr->second.event);
+    pending_requests.erase(itr);
+    event->Signal();
+}
+
+} // namespace Service::FS
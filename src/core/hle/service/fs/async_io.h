@@ -0,0 +1,94 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <boost/serialization/access.hpp>
+#include "common/common_types.h"
+
+namespace Core {
+class System;
+struct TimingEventType;
+} // namespace Core
+
+namespace Kernel {
+class Event;
+}
+
+namespace Service::FS {
+
+/**
+ * Runs host file I/O on behalf of FS sessions on a dedicated thread, so that a slow host disk
+ * does not stall the emulation thread. The requesting guest thread stays parked until both the
+ * host operation has finished and the emulated access delay has elapsed.
+ *
+ * Operations run in submission order, so a read issued after a write observes its data.
+ */
+class AsyncIOManager {
+public:
+    explicit AsyncIOManager(Core::System& system);
+    ~AsyncIOManager();
+
+    /**
+     * Queues a host I/O operation.
+     * @param task Operation to run on the I/O thread.
+     * @param event Event signaled on the emulation thread once the operation has completed.
+     * @param delay Minimum emulated time that passes before the event is signaled.
+     * @returns Future that becomes ready when the operation has completed.
+     */
+    std::shared_future<void> Submit(std::function<void()> task,
+                                    std::shared_ptr<Kernel::Event> event,
+                                    std::chrono::nanoseconds delay);
+
+    /**
+     * Blocks until every queued operation has finished. Must be called before a file backend is
+     * accessed directly from the emulation thread.
+     */
+    void WaitIdle();
+
+private:
+    struct Request {
+        std::shared_ptr<Kernel::Event> event;
+        /// Not valid for requests restored from a save state, which always completed before saving
+        std::shared_future<void> done;
+
+    private:
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int);
+        friend class boost::serialization::access;
+    };
+
+    void WorkerLoop();
+    void OnCompletion(u64 request_id, s64 cycles_late);
+
+    Core::System& system;
+    Core::TimingEventType* completion_event;
+
+    std::map<u64, Request> pending_requests;
+    u64 next_request_id = 0;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable idle_cv;
+    std::deque<std::packaged_task<void()>> queue;
+    std::size_t tasks_in_flight = 0;
+    bool stop = false;
+    std::thread worker;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int);
+    friend class boost::serialization::access;
+};
+
+} // namespace Service::FS
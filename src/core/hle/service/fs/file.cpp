@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
+#include <boost/serialization/vector.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -13,31 +15,107 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/file.h"
+#include "core/movie.h"
+#include "core/settings.h"
 
 SERIALIZE_EXPORT_IMPL(Service::FS::File)
 SERIALIZE_EXPORT_IMPL(Service::FS::FileSessionSlot)
+SERIALIZE_EXPORT_IMPL(Service::FS::File::AsyncIOCallback)
 
 namespace Service::FS {
 
+/// Carries a Read or Write between the I/O thread and the parked client thread, and writes the
+/// response once the host operation has completed.
+class File::AsyncIOCallback : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    enum class Operation : u8 { Read, Write };
+
+    AsyncIOCallback(std::shared_ptr<File> file_, Operation operation_, u16 command_id_,
+                    u32 buffer_id_)
+        : file(std::move(file_)), operation(operation_), command_id(command_id_),
+          buffer_id(buffer_id_) {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        if (done.valid()) {
+            done.wait();
+        }
+        WriteResponse(ctx);
+    }
+
+    /// Copies the read data back to the guest and writes the reply to the command buffer.
+    void WriteResponse(Kernel::HLERequestContext& ctx) {
+        auto& buffer = ctx.GetMappedBuffer(buffer_id);
+        if (operation == Operation::Read) {
+            if (result.IsSuccess()) {
+                buffer.Write(data.data(), 0, transferred);
+            }
+        } else {
+            // Update file size
+            file->GetSessionData(ctx.Session())->size = file_size;
+        }
+
+        IPC::RequestBuilder rb(ctx, command_id, 2, 2);
+        rb.Push(result);
+        rb.Push<u32>(result.IsSuccess() ? transferred : 0);
+        rb.PushMappedBuffer(buffer);
+    }
+
+    std::shared_ptr<File> file;
+    Operation operation;
+    /// Command id of the request being answered, as dispatched through the function table.
+    u16 command_id;
+    u32 buffer_id;
+
+    /// Data read from or to be written to the file. Only accessed by the I/O thread until done.
+    std::vector<u8> data;
+    ResultCode result = RESULT_SUCCESS;
+    u32 transferred = 0;
+    u64 file_size = 0;
+    std::shared_future<void> done;
+
+private:
+    AsyncIOCallback() = default;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        if (done.valid()) {
+            done.wait();
+        }
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& file;
+        ar& operation;
+        ar& command_id;
+        ar& buffer_id;
+        ar& data;
+        ar& result.raw;
+        ar& transferred;
+        ar& file_size;
+    }
+    friend class boost::serialization::access;
+};
+
 template <class Archive>
 void File::serialize(Archive& ar, const unsigned int) {
+    WaitForPendingIO();
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
     ar& path;
     ar& backend;
 }
 
-File::File() : File(Core::Global<Kernel::KernelSystem>()) {}
+File::File() : File(Core::Global<Core::System>()) {}
 
-File::File(Kernel::KernelSystem& kernel, std::unique_ptr<FileSys::FileBackend>&& backend,
+File::File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend,
            const FileSys::Path& path)
-    : File(kernel) {
+    : File(system) {
     this->backend = std::move(backend);
     this->path = path;
 }
 
-File::File(Kernel::KernelSystem& kernel)
-    : ServiceFramework("", 1), path(""), backend(nullptr), kernel(kernel) {
+File::File(Core::System& system)
+    : ServiceFramework("", 1), path(""), backend(nullptr), system(system) {
     static const FunctionInfo functions[] = {
         {0x08010100, &File::OpenSubFile, "OpenSubFile"},
         {0x080200C2, &File::Read, "Read"},
@@ -70,28 +148,38 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
-    if (offset + length > backend->GetSize()) {
-        LOG_ERROR(Service_FS,
-                  "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
-                  offset, length, backend->GetSize());
-    }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+    auto callback = std::make_shared<AsyncIOCallback>(
+        std::static_pointer_cast<File>(shared_from_this()), AsyncIOCallback::Operation::Read,
+        GetCommandId(ctx), buffer.GetId());
+    auto task = [callback, offset, length] {
+        FileSys::FileBackend& backend = *callback->file->backend;
+        if (offset + length > backend.GetSize()) {
+            LOG_ERROR(Service_FS,
+                      "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
+                      offset, length, backend.GetSize());
+        }
+
+        callback->data.resize(length);
+        ResultVal<std::size_t> read = backend.Read(offset, length, callback->data.data());
+        if (read.Failed()) {
+            callback->result = read.Code();
+        } else {
+            callback->transferred = static_cast<u32>(*read);
+        }
+    };
 
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
+    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+    if (!UseAsyncIO()) {
+        task();
+        callback->WriteResponse(ctx);
+        ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
+        return;
     }
-    rb.PushMappedBuffer(buffer);
 
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
-    ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
+    // The client is resumed once both the host read and the emulated read delay have completed.
+    auto event = ctx.SleepClientThread("file::read", std::chrono::nanoseconds(-1), callback);
+    callback->done = system.ArchiveManager().GetAsyncIO().Submit(std::move(task), std::move(event),
+                                                                 read_timeout_ns);
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -103,33 +191,45 @@ void File::Write(Kernel::HLERequestContext& ctx) {
     LOG_TRACE(Service_FS, "Write {}: offset=0x{:x} length={}, flush=0x{:x}", GetName(), offset,
               length, flush);
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
-    FileSessionSlot* file = GetSessionData(ctx.Session());
+    const FileSessionSlot* file = GetSessionData(ctx.Session());
 
     // Subfiles can not be written to
     if (file->subfile) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         rb.Push<u32>(0);
         rb.PushMappedBuffer(buffer);
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
-
-    // Update file size
-    file->size = backend->GetSize();
+    auto callback = std::make_shared<AsyncIOCallback>(
+        std::static_pointer_cast<File>(shared_from_this()), AsyncIOCallback::Operation::Write,
+        GetCommandId(ctx), buffer.GetId());
+    callback->data.resize(length);
+    buffer.Read(callback->data.data(), 0, length);
+    auto task = [callback, offset, flush] {
+        FileSys::FileBackend& backend = *callback->file->backend;
+        ResultVal<std::size_t> written =
+            backend.Write(offset, callback->data.size(), flush != 0, callback->data.data());
+        if (written.Failed()) {
+            callback->result = written.Code();
+        } else {
+            callback->transferred = static_cast<u32>(*written);
+        }
+        callback->file_size = backend.GetSize();
+        callback->data.clear();
+        callback->data.shrink_to_fit();
+    };
 
-    if (written.Failed()) {
-        rb.Push(written.Code());
-        rb.Push<u32>(0);
-    } else {
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*written));
+    if (!UseAsyncIO()) {
+        task();
+        callback->WriteResponse(ctx);
+        return;
     }
-    rb.PushMappedBuffer(buffer);
+
+    auto event = ctx.SleepClientThread("file::write", std::chrono::nanoseconds(-1), callback);
+    callback->done = system.ArchiveManager().GetAsyncIO().Submit(std::move(task), std::move(event),
+                                                                 std::chrono::nanoseconds(0));
 }
 
 void File::GetSize(Kernel::HLERequestContext& ctx) {
@@ -156,6 +256,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingIO();
     file->size = size;
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
@@ -169,6 +270,7 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
+    WaitForPendingIO();
     backend->Close();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -187,6 +289,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingIO();
     backend->Flush();
     rb.Push(RESULT_SUCCESS);
 }
@@ -216,7 +319,7 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
     using Kernel::ServerSession;
     IPC::RequestParser rp(ctx, 0x080C, 0, 0);
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
-    auto [server, client] = kernel.CreateSessionPair(GetName());
+    auto [server, client] = system.Kernel().CreateSessionPair(GetName());
     ClientConnected(server);
 
     FileSessionSlot* slot = GetSessionData(std::move(server));
@@ -224,6 +327,7 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
+    WaitForPendingIO();
     slot->size = backend->GetSize();
     slot->subfile = false;
 
@@ -262,7 +366,7 @@ void File::OpenSubFile(Kernel::HLERequestContext& ctx) {
 
     using Kernel::ClientSession;
     using Kernel::ServerSession;
-    auto [server, client] = kernel.CreateSessionPair(GetName());
+    auto [server, client] = system.Kernel().CreateSessionPair(GetName());
     ClientConnected(server);
 
     FileSessionSlot* slot = GetSessionData(std::move(server));
@@ -276,12 +380,13 @@ void File::OpenSubFile(Kernel::HLERequestContext& ctx) {
 }
 
 std::shared_ptr<Kernel::ClientSession> File::Connect() {
-    auto [server, client] = kernel.CreateSessionPair(GetName());
+    auto [server, client] = system.Kernel().CreateSessionPair(GetName());
     ClientConnected(server);
 
     FileSessionSlot* slot = GetSessionData(std::move(server));
     slot->priority = 0;
     slot->offset = 0;
+    WaitForPendingIO();
     slot->size = backend->GetSize();
     slot->subfile = false;
 
@@ -300,4 +405,20 @@ std::size_t File::GetSessionFileSize(std::shared_ptr<Kernel::ServerSession> sess
     return slot->size;
 }
 
+bool File::UseAsyncIO() const {
+    // With async I/O the guest resumes depending on how long the host takes, so it is never used
+    // while a movie is recorded or played back.
+    const auto& movie = Core::Movie::GetInstance();
+    return Settings::values.async_fs_io && !movie.IsRecordingInput() && !movie.IsPlayingInput();
+}
+
+u16 File::GetCommandId(Kernel::HLERequestContext& ctx) {
+    // The header is the function table entry this request was dispatched through.
+    return static_cast<u16>(IPC::Header{ctx.CommandBuffer()[0]}.command_id);
+}
+
+void File::WaitForPendingIO() {
+    system.ArchiveManager().GetAsyncIO().WaitIdle();
+}
+
 } // namespace Service::FS
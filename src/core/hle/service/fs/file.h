@@ -39,7 +39,7 @@ private:
 // Consider splitting ServiceFramework interface.
 class File final : public ServiceFramework<File, FileSessionSlot> {
 public:
-    File(Kernel::KernelSystem& kernel, std::unique_ptr<FileSys::FileBackend>&& backend,
+    File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend,
          const FileSys::Path& path);
     ~File() = default;
 
@@ -61,6 +61,8 @@ public:
     // OpenSubFile.
     std::size_t GetSessionFileSize(std::shared_ptr<Kernel::ServerSession> session);
 
+    class AsyncIOCallback;
+
 private:
     void Read(Kernel::HLERequestContext& ctx);
     void Write(Kernel::HLERequestContext& ctx);
@@ -73,9 +75,18 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
-    Kernel::KernelSystem& kernel;
+    /// Returns whether Read and Write may complete on the I/O thread instead of inline.
+    bool UseAsyncIO() const;
+
+    /// Returns the command id of the request being handled.
+    static u16 GetCommandId(Kernel::HLERequestContext& ctx);
+
+    /// Blocks until host I/O queued by any File has finished, so the backend can be used directly.
+    void WaitForPendingIO();
+
+    Core::System& system;
 
-    File(Kernel::KernelSystem& kernel);
+    File(Core::System& system);
     File();
 
     template <class Archive>
@@ -87,3 +98,4 @@ private:
 
 BOOST_CLASS_EXPORT_KEY(Service::FS::FileSessionSlot)
 BOOST_CLASS_EXPORT_KEY(Service::FS::File)
+BOOST_CLASS_EXPORT_KEY(Service::FS::File::AsyncIOCallback)
@@ -18,6 +18,12 @@ void SignalInterrupt(InterruptId interrupt_id) {
     return gpu->SignalInterrupt(interrupt_id);
 }
 
+void SignalInterrupts(std::initializer_list<InterruptId> interrupt_ids) {
+    auto gpu = gsp_gpu.lock();
+    ASSERT(gpu != nullptr);
+    return gpu->SignalInterrupts(interrupt_ids);
+}
+
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
     auto gpu = std::make_shared<GSP_GPU>(system);
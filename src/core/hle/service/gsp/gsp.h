@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <initializer_list>
 #include <string>
 #include "common/common_types.h"
 #include "core/hle/result.h"
@@ -22,6 +23,13 @@ namespace Service::GSP {
  */
 void SignalInterrupt(InterruptId interrupt_id);
 
+/**
+ * Signals that the specified interrupts have occurred to userland code, waking up each thread
+ * once for all of them
+ * @param interrupt_ids IDs of the interrupts that are being signalled, in order
+ */
+void SignalInterrupts(std::initializer_list<InterruptId> interrupt_ids);
+
 void InstallInterfaces(Core::System& system);
 
 void SetGlobalModule(Core::System& system);
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include "common/archives.h"
 #include "common/bit_field.h"
@@ -410,7 +412,13 @@ void GSP_GPU::UnregisterInterruptRelayQueue(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_GSP, "called");
 }
 
-void GSP_GPU::SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id) {
+/// Whether the interrupt is signalled to every registered thread, rather than the active one only
+static bool IsBroadcastInterrupt(InterruptId interrupt_id) {
+    return interrupt_id == InterruptId::PDC0 || interrupt_id == InterruptId::PDC1;
+}
+
+void GSP_GPU::SignalInterruptsForThread(std::initializer_list<InterruptId> interrupt_ids,
+                                        u32 thread_id) {
     SessionData* session_data = FindRegisteredThreadData(thread_id);
     if (session_data == nullptr)
         return;
@@ -420,31 +428,46 @@ void GSP_GPU::SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id)
         LOG_WARNING(Service_GSP, "cannot synchronize until GSP event has been created!");
         return;
     }
+
+    const bool is_active_thread = static_cast<int>(thread_id) == active_thread_id;
     InterruptRelayQueue* interrupt_relay_queue = GetInterruptRelayQueue(shared_memory, thread_id);
-    u8 next = interrupt_relay_queue->index;
-    next += interrupt_relay_queue->number_interrupts;
-    next = next % 0x34; // 0x34 is the number of interrupt slots
-
-    interrupt_relay_queue->number_interrupts += 1;
-
-    interrupt_relay_queue->slot[next] = interrupt_id;
-    interrupt_relay_queue->error_code = 0x0; // No error
-
-    // Update framebuffer information if requested
-    // TODO(yuriks): Confirm where this code should be called. It is definitely updated without
-    //               executing any GSP commands, only waiting on the event.
-    // TODO(Subv): The real GSP module triggers PDC0 after updating both the top and bottom
-    // screen, it is currently unknown what PDC1 does.
-    int screen_id =
-        (interrupt_id == InterruptId::PDC0) ? 0 : (interrupt_id == InterruptId::PDC1) ? 1 : -1;
-    if (screen_id != -1) {
-        FrameBufferUpdate* info = GetFrameBufferInfo(thread_id, screen_id);
-        if (info->is_dirty) {
-            GSP::SetBufferSwap(screen_id, info->framebuffer_info[info->index]);
-            info->is_dirty.Assign(false);
+    bool signalled = false;
+    for (InterruptId interrupt_id : interrupt_ids) {
+        if (!is_active_thread && !IsBroadcastInterrupt(interrupt_id)) {
+            continue;
         }
+
+        u8 next = interrupt_relay_queue->index;
+        next += interrupt_relay_queue->number_interrupts;
+        next = next % 0x34; // 0x34 is the number of interrupt slots
+
+        interrupt_relay_queue->number_interrupts += 1;
+
+        interrupt_relay_queue->slot[next] = interrupt_id;
+        interrupt_relay_queue->error_code = 0x0; // No error
+        signalled = true;
+
+        // Update framebuffer information if requested
+        // TODO(yuriks): Confirm where this code should be called. It is definitely updated without
+        //               executing any GSP commands, only waiting on the event.
+        // TODO(Subv): The real GSP module triggers PDC0 after updating both the top and bottom
+        // screen, it is currently unknown what PDC1 does.
+        int screen_id =
+            (interrupt_id == InterruptId::PDC0) ? 0 : (interrupt_id == InterruptId::PDC1) ? 1 : -1;
+        if (screen_id != -1) {
+            FrameBufferUpdate* info = GetFrameBufferInfo(thread_id, screen_id);
+            if (info->is_dirty) {
+                GSP::SetBufferSwap(screen_id, info->framebuffer_info[info->index]);
+                info->is_dirty.Assign(false);
+            }
+        }
+    }
+
+    // The thread reads every pending entry of its relay queue when woken up, so a single signal
+    // covers the whole batch
+    if (signalled) {
+        interrupt_event->Signal();
     }
-    interrupt_event->Signal();
 }
 
 /**
@@ -454,6 +477,10 @@ void GSP_GPU::SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id)
  * @todo This probably does not belong in the GSP module, instead move to video_core
  */
 void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
+    SignalInterrupts({interrupt_id});
+}
+
+void GSP_GPU::SignalInterrupts(std::initializer_list<InterruptId> interrupt_ids) {
     if (nullptr == shared_memory) {
         LOG_WARNING(Service_GSP, "cannot synchronize until GSP shared memory has been created!");
         return;
@@ -462,9 +489,9 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
     // The PDC0 and PDC1 interrupts are fired even if the GPU right hasn't been acquired.
     // Normal interrupts are only signaled for the active thread (ie, the thread that has the GPU
     // right), but the PDC0/1 interrupts are signaled for every registered thread.
-    if (interrupt_id == InterruptId::PDC0 || interrupt_id == InterruptId::PDC1) {
+    if (std::any_of(interrupt_ids.begin(), interrupt_ids.end(), IsBroadcastInterrupt)) {
         for (u32 thread_id = 0; thread_id < MaxGSPThreads; ++thread_id) {
-            SignalInterruptForThread(interrupt_id, thread_id);
+            SignalInterruptsForThread(interrupt_ids, thread_id);
         }
         return;
     }
@@ -473,10 +500,12 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
     if (active_thread_id == -1)
         return;
 
-    SignalInterruptForThread(interrupt_id, active_thread_id);
+    SignalInterruptsForThread(interrupt_ids, active_thread_id);
 }
 
 MICROPROFILE_DEFINE(GPU_GSP_DMA, "GPU", "GSP DMA", MP_RGB(100, 0, 255));
+MICROPROFILE_DEFINE(GPU_GSP_Command, "GPU", "GSP Command", MP_RGB(150, 0, 255));
+MICROPROFILE_DEFINE(GPU_GSP_CommandQueue, "GPU", "GSP Command Queue", MP_RGB(200, 0, 255));
 
 /// Executes the next GSP command
 static void ExecuteCommand(const Command& command, u32 thread_id) {
@@ -631,22 +660,38 @@ void GSP_GPU::SetLcdForceBlack(Kernel::HLERequestContext& ctx) {
 
 void GSP_GPU::TriggerCmdReqQueue(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0xC, 0, 0);
+    MICROPROFILE_SCOPE(GPU_GSP_CommandQueue);
 
+    u32 num_processed = 0;
     // Iterate through each thread's command queue...
-    for (unsigned thread_id = 0; thread_id < 0x4; ++thread_id) {
+    for (unsigned thread_id = 0; thread_id < MaxGSPThreads; ++thread_id) {
         CommandBuffer* command_buffer = (CommandBuffer*)GetCommandBuffer(shared_memory, thread_id);
 
-        // Iterate through each command...
-        for (unsigned i = 0; i < command_buffer->number_commands; ++i) {
-            g_debugger.GXCommandProcessed((u8*)&command_buffer->commands[i]);
-
-            // Decode and execute command
-            ExecuteCommand(command_buffer->commands[i], thread_id);
+        // The commands form a ring starting at the current index. Each one is consumed before it
+        // is processed, like the GSP module does, so that the application sees the queue drain
+        // and can reuse the slot.
+        while (command_buffer->number_commands != 0) {
+            const u32 index = command_buffer->index;
+            if (index >= std::size(command_buffer->commands)) {
+                LOG_ERROR(Service_GSP, "invalid command index {} for thread {}", index, thread_id);
+                break;
+            }
+            const Command command = command_buffer->commands[index];
 
-            // Indicates that command has completed
+            // Indicates that command has been loaded
+            command_buffer->index.Assign((index + 1) % std::size(command_buffer->commands));
             command_buffer->number_commands.Assign(command_buffer->number_commands - 1);
+
+            g_debugger.GXCommandProcessed((u8*)&command);
+
+            // Decode and execute command
+            MICROPROFILE_SCOPE(GPU_GSP_Command);
+            ExecuteCommand(command, thread_id);
+            ++num_processed;
         }
     }
+    MICROPROFILE_META_CPU("GX commands", num_processed);
+    LOG_TRACE(Service_GSP, "processed {} commands", num_processed);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
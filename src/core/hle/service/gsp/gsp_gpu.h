@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <boost/serialization/base_object.hpp>
@@ -228,6 +229,13 @@ public:
      */
     void SignalInterrupt(InterruptId interrupt_id);
 
+    /**
+     * Signals several interrupts at once, writing all of them to the interrupt relay queue of a
+     * thread before waking it up a single time.
+     * @param interrupt_ids IDs of the interrupts that are being signalled, in order
+     */
+    void SignalInterrupts(std::initializer_list<InterruptId> interrupt_ids);
+
     /**
      * Retrieves the framebuffer info stored in the GSP shared memory for the
      * specified screen index and thread id.
@@ -240,12 +248,14 @@ public:
 
 private:
     /**
-     * Signals that the specified interrupt type has occurred to userland code for the specified GSP
-     * thread id.
-     * @param interrupt_id ID of interrupt that is being signalled.
-     * @param thread_id GSP thread that will receive the interrupt.
+     * Signals that the specified interrupts have occurred to userland code for the specified GSP
+     * thread id. Interrupts other than PDC0 and PDC1 are skipped unless the thread has the GPU
+     * right.
+     * @param interrupt_ids IDs of the interrupts that are being signalled.
+     * @param thread_id GSP thread that will receive the interrupts.
      */
-    void SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id);
+    void SignalInterruptsForThread(std::initializer_list<InterruptId> interrupt_ids,
+                                   u32 thread_id);
 
     /**
      * GSP_GPU::WriteHWRegs service function
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -55,7 +56,7 @@ VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
         return 0;
 
     SegmentEntry entry;
-    GetEntry(system.Memory(), segment_tag.segment_index, entry);
+    GetEntry(memory, segment_tag.segment_index, entry);
 
     if (segment_tag.offset_into_segment >= entry.size)
         return 0;
@@ -71,11 +72,11 @@ ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType reloc
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
-        system.Memory().Write32(target_address, symbol_address + addend);
+        memory.Write32(target_address, symbol_address + addend);
         system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, symbol_address + addend - target_future_address);
+        memory.Write32(target_address, symbol_address + addend - target_future_address);
         system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
@@ -98,7 +99,7 @@ ResultCode CROHelper::ClearRelocation(VAddr target_address, RelocationType reloc
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, 0);
+        memory.Write32(target_address, 0);
         system.InvalidateCacheRange(target_address, sizeof(u32));
         break;
     case RelocationType::ThumbBranch:
@@ -121,8 +122,7 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
-        system.Memory().ReadBlock(process, relocation_address, &relocation,
-                                  sizeof(RelocationEntry));
+        memory.ReadBlock(process, relocation_address, &relocation, sizeof(RelocationEntry));
 
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
         if (relocation_target == 0) {
@@ -143,56 +143,97 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     }
 
     RelocationEntry relocation;
-    system.Memory().ReadBlock(process, batch, &relocation, sizeof(RelocationEntry));
+    memory.ReadBlock(process, batch, &relocation, sizeof(RelocationEntry));
     relocation.is_batch_resolved = reset ? 0 : 1;
-    system.Memory().WriteBlock(process, batch, &relocation, sizeof(RelocationEntry));
+    memory.WriteBlock(process, batch, &relocation, sizeof(RelocationEntry));
     return RESULT_SUCCESS;
 }
 
-VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
-    if (!GetField(ExportTreeNum))
-        return 0;
-
-    std::size_t len = name.size();
-    ExportTreeEntry entry;
-    GetEntry(system.Memory(), 0, entry);
-    ExportTreeEntry::Child next;
-    next.raw = entry.left.raw;
-    u32 found_id;
-
-    while (true) {
-        GetEntry(system.Memory(), next.next_index, entry);
+/**
+ * Reads a string from a string table previously read from memory, or from memory if the string is
+ * not inside of the table.
+ * @param table the contents of the string table
+ * @param table_address the virtual address of the string table
+ * @param address the virtual address of the string
+ * @returns the string, cut at the end of the table like a string read from memory.
+ */
+static std::string ReadTableString(Memory::MemorySystem& memory, const std::vector<char>& table,
+                                   VAddr table_address, VAddr address) {
+    if (address < table_address || address - table_address >= table.size()) {
+        return memory.ReadCString(address, static_cast<u32>(table.size()));
+    }
+    const char* begin = table.data() + (address - table_address);
+    const char* end = table.data() + table.size();
+    return std::string(begin, std::find(begin, end, '\0'));
+}
 
-        if (next.is_end) {
-            found_id = entry.export_table_index;
-            break;
+const CROSymbolCache::ModuleSymbols& CROHelper::GetSymbols() const {
+    if (const auto* symbols = symbol_cache.Find(module_address)) {
+        return *symbols;
+    }
+
+    const auto read_table = [this](HeaderField offset_field, HeaderField size_field) {
+        std::vector<char> table(GetField(size_field));
+        memory.ReadBlock(process, GetField(offset_field), table.data(), table.size());
+        return table;
+    };
+
+    CROSymbolCache::ModuleSymbols symbols;
+    symbols.module_name = ModuleName();
+
+    // Exports can only be found through the export tree, so there are none without it
+    if (GetField(ExportTreeNum) != 0) {
+        const VAddr strings_address = GetField(ExportStringsOffset);
+        const std::vector<char> strings = read_table(ExportStringsOffset, ExportStringsSize);
+        const u32 export_num = GetField(ExportNamedSymbolNum);
+        symbols.exports.reserve(export_num);
+        for (u32 i = 0; i < export_num; ++i) {
+            ExportNamedSymbolEntry entry;
+            GetEntry(memory, i, entry);
+            symbols.exports.emplace(
+                ReadTableString(memory, strings, strings_address, entry.name_offset),
+                entry.symbol_position.raw);
         }
+    }
 
-        u16 test_byte = entry.test_bit >> 3;
-        u16 test_bit_in_byte = entry.test_bit & 7;
+    const VAddr strings_address = GetField(ImportStringsOffset);
+    const std::vector<char> strings = read_table(ImportStringsOffset, ImportStringsSize);
 
-        if (test_byte >= len) {
-            next.raw = entry.left.raw;
-        } else if ((name[test_byte] >> test_bit_in_byte) & 1) {
-            next.raw = entry.right.raw;
-        } else {
-            next.raw = entry.left.raw;
-        }
+    const u32 symbol_import_num = GetField(ImportNamedSymbolNum);
+    symbols.import_symbol_names.reserve(symbol_import_num);
+    for (u32 i = 0; i < symbol_import_num; ++i) {
+        ImportNamedSymbolEntry entry;
+        GetEntry(memory, i, entry);
+        symbols.import_symbol_names.push_back(
+            ReadTableString(memory, strings, strings_address, entry.name_offset));
     }
 
-    u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
-
-    if (found_id >= export_named_symbol_num)
-        return 0;
+    const u32 import_module_num = GetField(ImportModuleNum);
+    symbols.import_module_names.reserve(import_module_num);
+    for (u32 i = 0; i < import_module_num; ++i) {
+        ImportModuleEntry entry;
+        GetEntry(memory, i, entry);
+        symbols.import_module_names.push_back(
+            ReadTableString(memory, strings, strings_address, entry.name_offset));
+    }
 
-    u32 export_strings_size = GetField(ExportStringsSize);
-    ExportNamedSymbolEntry symbol_entry;
-    GetEntry(system.Memory(), found_id, symbol_entry);
+    return symbol_cache.Insert(module_address, std::move(symbols));
+}
 
-    if (system.Memory().ReadCString(symbol_entry.name_offset, export_strings_size) != name)
-        return 0;
+std::vector<CROHelper> CROHelper::GetAutoLinkModules(VAddr crs_address) const {
+    std::vector<CROHelper> modules;
+    ForEachAutoLinkCRO(process, memory, system, symbol_cache, crs_address,
+                       [&modules](CROHelper cro) -> ResultVal<bool> {
+                           modules.push_back(cro);
+                           return MakeResult<bool>(true);
+                       });
+    return modules;
+}
 
-    return SegmentTagToAddress(symbol_entry.symbol_position);
+VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
+    const auto& exports = GetSymbols().exports;
+    const auto it = exports.find(name);
+    return it != exports.end() ? SegmentTagToAddress(SegmentTag(it->second)) : 0;
 }
 
 ResultCode CROHelper::RebaseHeader(u32 cro_size) {
@@ -280,7 +321,7 @@ ResultVal<VAddr> CROHelper::RebaseSegmentTable(u32 cro_size, VAddr data_segment_
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry segment;
-        GetEntry(system.Memory(), i, segment);
+        GetEntry(memory, i, segment);
         if (segment.type == SegmentType::Data) {
             if (segment.size != 0) {
                 if (segment.size > data_segment_size)
@@ -299,7 +340,7 @@ ResultVal<VAddr> CROHelper::RebaseSegmentTable(u32 cro_size, VAddr data_segment_
             if (segment.offset > module_address + cro_size)
                 return CROFormatError(0x19);
         }
-        SetEntry(system.Memory(), i, segment);
+        SetEntry(memory, i, segment);
     }
     return MakeResult<u32>(prev_data_segment + module_address);
 }
@@ -311,7 +352,7 @@ ResultCode CROHelper::RebaseExportNamedSymbolTable() {
     u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
     for (u32 i = 0; i < export_named_symbol_num; ++i) {
         ExportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -321,7 +362,7 @@ ResultCode CROHelper::RebaseExportNamedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -330,7 +371,7 @@ ResultCode CROHelper::VerifyExportTreeTable() const {
     u32 tree_num = GetField(ExportTreeNum);
     for (u32 i = 0; i < tree_num; ++i) {
         ExportTreeEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.left.next_index >= tree_num || entry.right.next_index >= tree_num) {
             return CROFormatError(0x11);
@@ -354,7 +395,7 @@ ResultCode CROHelper::RebaseImportModuleTable() {
     u32 module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -380,7 +421,7 @@ ResultCode CROHelper::RebaseImportModuleTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -396,7 +437,7 @@ ResultCode CROHelper::RebaseImportNamedSymbolTable() {
     u32 num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset += module_address;
@@ -414,7 +455,7 @@ ResultCode CROHelper::RebaseImportNamedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -428,7 +469,7 @@ ResultCode CROHelper::RebaseImportIndexedSymbolTable() {
     u32 num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset += module_address;
@@ -438,7 +479,7 @@ ResultCode CROHelper::RebaseImportIndexedSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -452,7 +493,7 @@ ResultCode CROHelper::RebaseImportAnonymousSymbolTable() {
     u32 num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset += module_address;
@@ -462,7 +503,7 @@ ResultCode CROHelper::RebaseImportAnonymousSymbolTable() {
             }
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
     return RESULT_SUCCESS;
 }
@@ -477,14 +518,14 @@ ResultCode CROHelper::ResetExternalRelocations() {
     ExternalRelocationEntry relocation;
 
     // Verifies that the last relocation is the end of a batch
-    GetEntry(system.Memory(), external_relocation_num - 1, relocation);
+    GetEntry(memory, external_relocation_num - 1, relocation);
     if (!relocation.is_batch_end) {
         return CROFormatError(0x12);
     }
 
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -501,7 +542,7 @@ ResultCode CROHelper::ResetExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
+            SetEntry(memory, i, relocation);
         }
 
         // if current is an end, then the next is a beginning
@@ -517,7 +558,7 @@ ResultCode CROHelper::ClearExternalRelocations() {
 
     bool batch_begin = true;
     for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -533,7 +574,7 @@ ResultCode CROHelper::ClearExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
+            SetEntry(memory, i, relocation);
         }
 
         // if current is an end, then the next is a beginning
@@ -549,13 +590,13 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
         static_relocation_table_offset +
         GetField(StaticRelocationNum) * sizeof(StaticRelocationEntry);
 
-    CROHelper crs(crs_address, process, system);
+    CROHelper crs(crs_address, process, memory, system, symbol_cache);
     u32 offset_export_num = GetField(StaticAnonymousSymbolNum);
     LOG_INFO(Service_LDR, "CRO \"{}\" exports {} static anonymous symbols", ModuleName(),
              offset_export_num);
     for (u32 i = 0; i < offset_export_num; ++i) {
         StaticAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         u32 batch_address = entry.relocation_batch_offset + module_address;
 
         if (batch_address < static_relocation_table_offset ||
@@ -580,7 +621,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr target_addressB = SegmentTagToAddress(relocation.target_position);
         if (target_addressB == 0) {
             return CROFormatError(0x15);
@@ -588,7 +629,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 
         VAddr target_address;
         SegmentEntry target_segment;
-        GetEntry(system.Memory(), relocation.target_position.segment_index, target_segment);
+        GetEntry(memory, relocation.target_position.segment_index, target_segment);
 
         if (target_segment.type == SegmentType::Data) {
             // If the relocation is to the .data segment, we need to relocate it in the old buffer
@@ -603,7 +644,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
         }
 
         SegmentEntry symbol_segment;
-        GetEntry(system.Memory(), relocation.symbol_segment, symbol_segment);
+        GetEntry(memory, relocation.symbol_segment, symbol_segment);
         LOG_TRACE(Service_LDR, "Internally relocates 0x{:08X} with 0x{:08X}", target_address,
                   symbol_segment.offset);
         ResultCode result = ApplyRelocation(target_address, relocation.type, relocation.addend,
@@ -620,7 +661,7 @@ ResultCode CROHelper::ClearInternalRelocations() {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
     for (u32 i = 0; i < internal_relocation_num; ++i) {
         InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+        GetEntry(memory, i, relocation);
         VAddr target_address = SegmentTagToAddress(relocation.target_position);
 
         if (target_address == 0) {
@@ -640,13 +681,13 @@ void CROHelper::UnrebaseImportAnonymousSymbolTable() {
     u32 num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -654,13 +695,13 @@ void CROHelper::UnrebaseImportIndexedSymbolTable() {
     u32 num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.relocation_batch_offset != 0) {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -668,7 +709,7 @@ void CROHelper::UnrebaseImportNamedSymbolTable() {
     u32 num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
@@ -678,7 +719,7 @@ void CROHelper::UnrebaseImportNamedSymbolTable() {
             entry.relocation_batch_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -686,7 +727,7 @@ void CROHelper::UnrebaseImportModuleTable() {
     u32 module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
@@ -700,7 +741,7 @@ void CROHelper::UnrebaseImportModuleTable() {
             entry.import_anonymous_symbol_table_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -708,13 +749,13 @@ void CROHelper::UnrebaseExportNamedSymbolTable() {
     u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
     for (u32 i = 0; i < export_named_symbol_num; ++i) {
         ExportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
 
         if (entry.name_offset != 0) {
             entry.name_offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, entry);
+        SetEntry(memory, i, entry);
     }
 }
 
@@ -722,7 +763,7 @@ void CROHelper::UnrebaseSegmentTable() {
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry segment;
-        GetEntry(system.Memory(), i, segment);
+        GetEntry(memory, i, segment);
 
         if (segment.type == SegmentType::BSS) {
             segment.offset = 0;
@@ -730,7 +771,7 @@ void CROHelper::UnrebaseSegmentTable() {
             segment.offset -= module_address;
         }
 
-        SetEntry(system.Memory(), i, segment);
+        SetEntry(memory, i, segment);
     }
 }
 
@@ -748,41 +789,33 @@ void CROHelper::UnrebaseHeader() {
 }
 
 ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
-    u32 import_strings_size = GetField(ImportStringsSize);
+    const auto& import_symbol_names = GetSymbols().import_symbol_names;
+    const std::vector<CROHelper> sources = GetAutoLinkModules(crs_address);
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
-            ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
-                    u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
-
-                    if (symbol_address != 0) {
-                        LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"",
-                                  ModuleName(), symbol_name, source.ModuleName());
-
-                        ResultCode result = ApplyRelocationBatch(relocation_addr, symbol_address);
-                        if (result.IsError()) {
-                            LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}",
-                                      result.raw);
-                            return result;
-                        }
+            const std::string& symbol_name = import_symbol_names[i];
+            for (const CROHelper& source : sources) {
+                u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
+                if (symbol_address == 0)
+                    continue;
 
-                        return MakeResult<bool>(false);
-                    }
+                LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"", ModuleName(),
+                          symbol_name, source.ModuleName());
 
-                    return MakeResult<bool>(true);
-                });
-            if (result.IsError()) {
-                return result;
+                ResultCode result = ApplyRelocationBatch(relocation_addr, symbol_address);
+                if (result.IsError()) {
+                    LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}", result.raw);
+                    return result;
+                }
+                break;
             }
         }
     }
@@ -795,11 +828,11 @@ ResultCode CROHelper::ResetImportNamedSymbol() {
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
         if (result.IsError()) {
@@ -816,11 +849,11 @@ ResultCode CROHelper::ResetImportIndexedSymbol() {
     u32 import_num = GetField(ImportIndexedSymbolNum);
     for (u32 i = 0; i < import_num; ++i) {
         ImportIndexedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
         if (result.IsError()) {
@@ -837,11 +870,11 @@ ResultCode CROHelper::ResetImportAnonymousSymbol() {
     u32 import_num = GetField(ImportAnonymousSymbolNum);
     for (u32 i = 0; i < import_num; ++i) {
         ImportAnonymousSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         ResultCode result = ApplyRelocationBatch(relocation_addr, unresolved_symbol, true);
         if (result.IsError()) {
@@ -853,25 +886,25 @@ ResultCode CROHelper::ResetImportAnonymousSymbol() {
 }
 
 ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
-    u32 import_strings_size = GetField(ImportStringsSize);
+    const auto& import_module_names = GetSymbols().import_module_names;
 
     u32 import_module_num = GetField(ImportModuleNum);
     for (u32 i = 0; i < import_module_num; ++i) {
         ImportModuleEntry entry;
-        GetEntry(system.Memory(), i, entry);
-        std::string want_cro_name =
-            system.Memory().ReadCString(entry.name_offset, import_strings_size);
+        GetEntry(memory, i, entry);
+        const std::string& want_cro_name = import_module_names[i];
 
         ResultCode result = ForEachAutoLinkCRO(
-            process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                if (want_cro_name == source.ModuleName()) {
+            process, memory, system, symbol_cache, crs_address,
+            [&](CROHelper source) -> ResultVal<bool> {
+                if (want_cro_name == source.GetSymbols().module_name) {
                     LOG_INFO(Service_LDR, "CRO \"{}\" imports {} indexed symbols from \"{}\"",
                              ModuleName(), entry.import_indexed_symbol_num, source.ModuleName());
                     for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
                         ImportIndexedSymbolEntry im;
-                        entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+                        entry.GetImportIndexedSymbolEntry(process, memory, j, im);
                         ExportIndexedSymbolEntry ex;
-                        source.GetEntry(system.Memory(), im.index, ex);
+                        source.GetEntry(memory, im.index, ex);
                         u32 symbol_address = source.SegmentTagToAddress(ex.symbol_position);
                         LOG_TRACE(Service_LDR, "    Imports 0x{:08X}", symbol_address);
                         ResultCode result =
@@ -886,7 +919,7 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
                              ModuleName(), entry.import_anonymous_symbol_num, source.ModuleName());
                     for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
                         ImportAnonymousSymbolEntry im;
-                        entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+                        entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
                         u32 symbol_address = source.SegmentTagToAddress(im.symbol_position);
                         LOG_TRACE(Service_LDR, "    Imports 0x{:08X}", symbol_address);
                         ResultCode result =
@@ -911,19 +944,18 @@ ResultCode CROHelper::ApplyModuleImport(VAddr crs_address) {
 ResultCode CROHelper::ApplyExportNamedSymbol(CROHelper target) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" exports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
-    u32 target_import_strings_size = target.GetField(ImportStringsSize);
+    const auto& target_import_symbol_names = target.GetSymbols().import_symbol_names;
     u32 target_symbol_import_num = target.GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < target_symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
-            std::string symbol_name =
-                system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
+            const std::string& symbol_name = target_import_symbol_names[i];
             u32 symbol_address = FindExportNamedSymbol(symbol_name);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    exports symbol \"{}\"", symbol_name);
@@ -942,19 +974,18 @@ ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target) {
     LOG_DEBUG(Service_LDR, "CRO \"{}\" unexports named symbols to \"{}\"", ModuleName(),
               target.ModuleName());
     u32 unresolved_symbol = target.GetOnUnresolvedAddress();
-    u32 target_import_strings_size = target.GetField(ImportStringsSize);
+    const auto& target_import_symbol_names = target.GetSymbols().import_symbol_names;
     u32 target_symbol_import_num = target.GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < target_symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
         if (relocation_entry.is_batch_resolved) {
-            std::string symbol_name =
-                system.Memory().ReadCString(entry.name_offset, target_import_strings_size);
+            const std::string& symbol_name = target_import_symbol_names[i];
             u32 symbol_address = FindExportNamedSymbol(symbol_name);
             if (symbol_address != 0) {
                 LOG_TRACE(Service_LDR, "    unexports symbol \"{}\"", symbol_name);
@@ -971,24 +1002,23 @@ ResultCode CROHelper::ResetExportNamedSymbol(CROHelper target) {
 }
 
 ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
-    std::string module_name = ModuleName();
-    u32 target_import_string_size = target.GetField(ImportStringsSize);
+    const std::string& module_name = GetSymbols().module_name;
+    const auto& target_import_module_names = target.GetSymbols().import_module_names;
     u32 target_import_module_num = target.GetField(ImportModuleNum);
     for (u32 i = 0; i < target_import_module_num; ++i) {
         ImportModuleEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
 
-        if (system.Memory().ReadCString(entry.name_offset, target_import_string_size) !=
-            module_name)
+        if (target_import_module_names[i] != module_name)
             continue;
 
         LOG_INFO(Service_LDR, "CRO \"{}\" exports {} indexed symbols to \"{}\"", module_name,
                  entry.import_indexed_symbol_num, target.ModuleName());
         for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
             ImportIndexedSymbolEntry im;
-            entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportIndexedSymbolEntry(process, memory, j, im);
             ExportIndexedSymbolEntry ex;
-            GetEntry(system.Memory(), im.index, ex);
+            GetEntry(memory, im.index, ex);
             u32 symbol_address = SegmentTagToAddress(ex.symbol_position);
             LOG_TRACE(Service_LDR, "    exports symbol 0x{:08X}", symbol_address);
             ResultCode result =
@@ -1003,7 +1033,7 @@ ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
                  entry.import_anonymous_symbol_num, target.ModuleName());
         for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
             ImportAnonymousSymbolEntry im;
-            entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
             u32 symbol_address = SegmentTagToAddress(im.symbol_position);
             LOG_TRACE(Service_LDR, "    exports symbol 0x{:08X}", symbol_address);
             ResultCode result =
@@ -1021,22 +1051,21 @@ ResultCode CROHelper::ApplyModuleExport(CROHelper target) {
 ResultCode CROHelper::ResetModuleExport(CROHelper target) {
     u32 unresolved_symbol = target.GetOnUnresolvedAddress();
 
-    std::string module_name = ModuleName();
-    u32 target_import_string_size = target.GetField(ImportStringsSize);
+    const std::string& module_name = GetSymbols().module_name;
+    const auto& target_import_module_names = target.GetSymbols().import_module_names;
     u32 target_import_module_num = target.GetField(ImportModuleNum);
     for (u32 i = 0; i < target_import_module_num; ++i) {
         ImportModuleEntry entry;
-        target.GetEntry(system.Memory(), i, entry);
+        target.GetEntry(memory, i, entry);
 
-        if (system.Memory().ReadCString(entry.name_offset, target_import_string_size) !=
-            module_name)
+        if (target_import_module_names[i] != module_name)
             continue;
 
         LOG_DEBUG(Service_LDR, "CRO \"{}\" unexports indexed symbols to \"{}\"", module_name,
                   target.ModuleName());
         for (u32 j = 0; j < entry.import_indexed_symbol_num; ++j) {
             ImportIndexedSymbolEntry im;
-            entry.GetImportIndexedSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportIndexedSymbolEntry(process, memory, j, im);
             ResultCode result =
                 target.ApplyRelocationBatch(im.relocation_batch_offset, unresolved_symbol, true);
             if (result.IsError()) {
@@ -1049,7 +1078,7 @@ ResultCode CROHelper::ResetModuleExport(CROHelper target) {
                   target.ModuleName());
         for (u32 j = 0; j < entry.import_anonymous_symbol_num; ++j) {
             ImportAnonymousSymbolEntry im;
-            entry.GetImportAnonymousSymbolEntry(process, system.Memory(), j, im);
+            entry.GetImportAnonymousSymbolEntry(process, memory, j, im);
             ResultCode result =
                 target.ApplyRelocationBatch(im.relocation_batch_offset, unresolved_symbol, true);
             if (result.IsError()) {
@@ -1063,20 +1092,20 @@ ResultCode CROHelper::ResetModuleExport(CROHelper target) {
 }
 
 ResultCode CROHelper::ApplyExitRelocations(VAddr crs_address) {
-    u32 import_strings_size = GetField(ImportStringsSize);
+    const auto& import_symbol_names = GetSymbols().import_symbol_names;
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
     for (u32 i = 0; i < symbol_import_num; ++i) {
         ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
-        system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
-                                  sizeof(ExternalRelocationEntry));
+        memory.ReadBlock(process, relocation_addr, &relocation_entry,
+                         sizeof(ExternalRelocationEntry));
 
-        if (system.Memory().ReadCString(entry.name_offset, import_strings_size) ==
-            "__aeabi_atexit") {
+        if (import_symbol_names[i] == "__aeabi_atexit") {
             ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+                process, memory, system, symbol_cache, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol("nnroAeabiAtexit_");
 
                     if (symbol_address != 0) {
@@ -1124,6 +1153,7 @@ static ResultCode VerifyStringTableLength(Memory::MemorySystem& memory, VAddr ad
 ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment_addresss,
                              u32 data_segment_size, VAddr bss_segment_address, u32 bss_segment_size,
                              bool is_crs) {
+    symbol_cache.Invalidate(module_address);
 
     ResultCode result = RebaseHeader(cro_size);
     if (result.IsError()) {
@@ -1131,8 +1161,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ModuleNameOffset),
-                                     GetField(ModuleNameSize));
+    result = VerifyStringTableLength(memory, GetField(ModuleNameOffset), GetField(ModuleNameSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying module name {:08X}", result.raw);
         return result;
@@ -1161,7 +1190,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ExportStringsOffset),
+    result = VerifyStringTableLength(memory, GetField(ExportStringsOffset),
                                      GetField(ExportStringsSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying export strings {:08X}", result.raw);
@@ -1198,7 +1227,7 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
         return result;
     }
 
-    result = VerifyStringTableLength(system.Memory(), GetField(ImportStringsOffset),
+    result = VerifyStringTableLength(memory, GetField(ImportStringsOffset),
                                      GetField(ImportStringsSize));
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error verifying import strings {:08X}", result.raw);
@@ -1231,6 +1260,8 @@ ResultCode CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment
 }
 
 void CROHelper::Unrebase(bool is_crs) {
+    symbol_cache.Invalidate(module_address);
+
     UnrebaseImportAnonymousSymbolTable();
     UnrebaseImportIndexedSymbolTable();
     UnrebaseImportNamedSymbolTable();
@@ -1272,11 +1303,11 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
             // so we do the same
             if (GetField(SegmentNum) >= 2) { // means we have .data segment
                 SegmentEntry entry;
-                GetEntry(system.Memory(), 2, entry);
+                GetEntry(memory, 2, entry);
                 ASSERT(entry.type == SegmentType::Data);
                 data_segment_address = entry.offset;
                 entry.offset = GetField(DataOffset);
-                SetEntry(system.Memory(), 2, entry);
+                SetEntry(memory, 2, entry);
             }
         }
         SCOPE_EXIT({
@@ -1284,9 +1315,9 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
             if (link_on_load_bug_fix) {
                 if (GetField(SegmentNum) >= 2) {
                     SegmentEntry entry;
-                    GetEntry(system.Memory(), 2, entry);
+                    GetEntry(memory, 2, entry);
                     entry.offset = data_segment_address;
-                    SetEntry(system.Memory(), 2, entry);
+                    SetEntry(memory, 2, entry);
                 }
             }
         });
@@ -1307,7 +1338,7 @@ ResultCode CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     }
 
     // Exports symbols to other modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, memory, system, symbol_cache, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ApplyExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1352,7 +1383,7 @@ ResultCode CROHelper::Unlink(VAddr crs_address) {
 
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, memory, system, symbol_cache, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     ResultCode result = ResetExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1393,13 +1424,14 @@ void CROHelper::InitCRS() {
 }
 
 void CROHelper::Register(VAddr crs_address, bool auto_link) {
-    CROHelper crs(crs_address, process, system);
-    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, system);
+    CROHelper crs(crs_address, process, memory, system, symbol_cache);
+    CROHelper head(auto_link ? crs.NextModule() : crs.PreviousModule(), process, memory,
+                   system, symbol_cache);
 
     if (head.module_address) {
         // there are already CROs registered
         // register as the new tail
-        CROHelper tail(head.PreviousModule(), process, system);
+        CROHelper tail(head.PreviousModule(), process, memory, system, symbol_cache);
 
         // link with the old tail
         ASSERT(tail.NextModule() == 0);
@@ -1425,11 +1457,11 @@ void CROHelper::Register(VAddr crs_address, bool auto_link) {
 }
 
 void CROHelper::Unregister(VAddr crs_address) {
-    CROHelper crs(crs_address, process, system);
-    CROHelper next_head(crs.NextModule(), process, system);
-    CROHelper previous_head(crs.PreviousModule(), process, system);
-    CROHelper next(NextModule(), process, system);
-    CROHelper previous(PreviousModule(), process, system);
+    CROHelper crs(crs_address, process, memory, system, symbol_cache);
+    CROHelper next_head(crs.NextModule(), process, memory, system, symbol_cache);
+    CROHelper previous_head(crs.PreviousModule(), process, memory, system, symbol_cache);
+    CROHelper next(NextModule(), process, memory, system, symbol_cache);
+    CROHelper previous(PreviousModule(), process, memory, system, symbol_cache);
 
     if (module_address == next_head.module_address ||
         module_address == previous_head.module_address) {
@@ -1494,6 +1526,8 @@ u32 CROHelper::Fix(u32 fix_level) {
     u32 fix_end = GetFixEnd(fix_level);
 
     if (fix_level != 0) {
+        // Cropped tables no longer provide symbols
+        symbol_cache.Invalidate(module_address);
         SetField(Magic, MAGIC_FIXD);
 
         for (int field = FIX_BARRIERS[fix_level]; field < Fix0Barrier; field += 2) {
@@ -1523,7 +1557,7 @@ std::tuple<VAddr, u32> CROHelper::GetExecutablePages() const {
     u32 segment_num = GetField(SegmentNum);
     for (u32 i = 0; i < segment_num; ++i) {
         SegmentEntry entry;
-        GetEntry(system.Memory(), i, entry);
+        GetEntry(memory, i, entry);
         if (entry.type == SegmentType::Code && entry.size != 0) {
             VAddr begin = Common::AlignDown(entry.offset, Memory::PAGE_SIZE);
             VAddr end = Common::AlignUp(entry.offset + entry.size, Memory::PAGE_SIZE);
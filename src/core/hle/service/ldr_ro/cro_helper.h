@@ -5,7 +5,10 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -29,15 +32,55 @@ namespace Service::LDR {
 static constexpr u32 CRO_HEADER_SIZE = 0x138;
 static constexpr u32 CRO_HASH_SIZE = 0x80;
 
+/**
+ * Symbol tables of the loaded modules of a process. They are read from guest memory the first time
+ * a module is linked against and kept until the module tables change, so that linking looks
+ * symbols up by name instead of walking the export tree and reading strings for every pair of
+ * modules.
+ */
+class CROSymbolCache {
+public:
+    struct ModuleSymbols {
+        std::string module_name;
+        /// Raw segment tags of the exported named symbols, by name. They are resolved to addresses
+        /// on lookup, as the address of a segment can change while the module is being fixed.
+        std::unordered_map<std::string, u32> exports;
+        /// Names of the imported named symbols, by index in the import named symbol table
+        std::vector<std::string> import_symbol_names;
+        /// Names of the imported modules, by index in the import module table
+        std::vector<std::string> import_module_names;
+    };
+
+    /// Returns the symbols of the module at an address, or nullptr if they are not cached
+    const ModuleSymbols* Find(VAddr module_address) const {
+        const auto it = modules.find(module_address);
+        return it != modules.end() ? &it->second : nullptr;
+    }
+
+    const ModuleSymbols& Insert(VAddr module_address, ModuleSymbols symbols) {
+        return modules.insert_or_assign(module_address, std::move(symbols)).first->second;
+    }
+
+    /// Drops the symbols of the module at an address. Must be called whenever its tables change.
+    void Invalidate(VAddr module_address) {
+        modules.erase(module_address);
+    }
+
+private:
+    std::unordered_map<VAddr, ModuleSymbols> modules;
+};
+
 /// Represents a loaded module (CRO) with interfaces manipulating it.
 class CROHelper final {
 public:
     // TODO (wwylele): pass in the process handle for memory access
-    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system)
-        : module_address(cro_address), process(process), system(system) {}
+    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Memory::MemorySystem& memory,
+                       Core::System& system, CROSymbolCache& symbol_cache)
+        : module_address(cro_address), process(process), memory(memory), system(system),
+          symbol_cache(symbol_cache) {}
 
     std::string ModuleName() const {
-        return system.Memory().ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
+        return memory.ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
     }
 
     u32 GetFileSize() const {
@@ -143,7 +186,9 @@ public:
 private:
     const VAddr module_address; ///< the virtual address of this module
     Kernel::Process& process;   ///< the owner process of this module
+    Memory::MemorySystem& memory;
     Core::System& system;
+    CROSymbolCache& symbol_cache; ///< the symbol tables of the modules of the process
 
     /**
      * Each item in this enum represents a u32 field in the header begin from address+0x80,
@@ -401,11 +446,11 @@ private:
     }
 
     u32 GetField(HeaderField field) const {
-        return system.Memory().Read32(Field(field));
+        return memory.Read32(Field(field));
     }
 
     void SetField(HeaderField field, u32 value) {
-        system.Memory().Write32(Field(field), value);
+        memory.Write32(Field(field), value);
     }
 
     /**
@@ -472,11 +517,12 @@ private:
      *         otherwise error code of the last iteration.
      */
     template <typename FunctionObject>
-    static ResultCode ForEachAutoLinkCRO(Kernel::Process& process, Core::System& system,
+    static ResultCode ForEachAutoLinkCRO(Kernel::Process& process, Memory::MemorySystem& memory,
+                                         Core::System& system, CROSymbolCache& symbol_cache,
                                          VAddr crs_address, FunctionObject func) {
         VAddr current = crs_address;
         while (current != 0) {
-            CROHelper cro(current, process, system);
+            CROHelper cro(current, process, memory, system, symbol_cache);
             CASCADE_RESULT(bool next, func(cro));
             if (!next)
                 break;
@@ -516,6 +562,15 @@ private:
      */
     ResultCode ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool reset = false);
 
+    /**
+     * Gets the symbol tables of this module, reading them from memory if they are not cached yet.
+     * @note the module must be rebased.
+     */
+    const CROSymbolCache::ModuleSymbols& GetSymbols() const;
+
+    /// Gets all registered auto-link modules, including the static module, in link order.
+    std::vector<CROHelper> GetAutoLinkModules(VAddr crs_address) const;
+
     /**
      * Finds an exported named symbol in this module.
      * @param name the name of the symbol to find
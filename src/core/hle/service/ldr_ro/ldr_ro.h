@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/hle/service/ldr_ro/cro_helper.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -14,6 +15,8 @@ namespace Service::LDR {
 
 struct ClientSlot : public Kernel::SessionRequestHandler::SessionDataBase {
     VAddr loaded_crs = 0; ///< the virtual address of the static module
+    /// Symbol tables of the loaded modules, which are not saved as they are read back from memory
+    CROSymbolCache symbol_cache;
 
 private:
     template <class Archive>
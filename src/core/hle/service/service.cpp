@@ -6,7 +6,9 @@
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/handle_table.h"
@@ -52,6 +54,7 @@
 #include "core/hle/service/soc_u.h"
 #include "core/hle/service/ssl_c.h"
 #include "core/hle/service/y2r_u.h"
+#include "core/settings.h"
 
 namespace Service {
 
@@ -166,10 +169,12 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const Funct
     cmd_buf[1] = 0;
 }
 
+MICROPROFILE_DEFINE(HLE_Service, "HLE", "Service Request", MP_RGB(200, 150, 70));
+
 void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
     u32 header_code = context.CommandBuffer()[0];
     auto itr = handlers.find(header_code);
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+    FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
     if (info == nullptr || info->handler_callback == nullptr) {
         context.ReportUnimplemented();
         return ReportUnimplementedFunction(context.CommandBuffer(), info);
@@ -177,7 +182,14 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+    MICROPROFILE_SCOPE(HLE_Service);
+    if (info->call_stats == nullptr) {
+        info->call_stats = &Core::System::GetInstance().ServiceCallStats().GetCommand(
+            service_name, info->name, header_code);
+    }
+    const auto start_time = CallStats::Clock::now();
     handler_invoker(this, info->handler_callback, context);
+    info->call_stats->Record(CallStats::Clock::now() - start_time);
 }
 
 std::string ServiceFrameworkBase::GetFunctionName(u32 header) const {
@@ -208,10 +220,31 @@ static bool AttemptLLE(const ServiceModuleInfo& service_module) {
     return true;
 }
 
+/// Emulated time between two dumps of the service call statistics to the log
+constexpr int CallStatsLogIntervalMs = 10000;
+/// Number of commands included in each dump
+constexpr std::size_t CallStatsLogCommands = 10;
+
+static Core::TimingEventType* call_stats_log_event = nullptr;
+
+static void LogCallStats(Core::System& core, s64 cycles_late) {
+    core.ServiceCallStats().LogSummary(CallStatsLogCommands);
+    core.CoreTiming().ScheduleEvent(msToCycles(CallStatsLogIntervalMs) - cycles_late,
+                                    call_stats_log_event);
+}
+
 /// Initialize ServiceManager
 void Init(Core::System& core) {
     SM::ServiceManager::InstallInterfaces(core);
 
+    call_stats_log_event =
+        core.CoreTiming().RegisterEvent("Service::LogCallStats", [&core](u64, s64 cycles_late) {
+            LogCallStats(core, cycles_late);
+        });
+    if (Settings::values.log_service_stats) {
+        core.CoreTiming().ScheduleEvent(msToCycles(CallStatsLogIntervalMs), call_stats_log_event);
+    }
+
     for (const auto& service_module : service_module_map) {
         if (!AttemptLLE(service_module) && service_module.init_function != nullptr)
             service_module.init_function(core);
@@ -16,6 +16,7 @@
 #include "common/construct.h"
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/object.h"
+#include "core/hle/service/call_stats.h"
 #include "core/hle/service/sm/sm.h"
 
 namespace Core {
@@ -83,6 +84,8 @@ private:
         u32 expected_header;
         HandlerFnP<ServiceFrameworkBase> handler_callback;
         const char* name;
+        /// Counters of the command, looked up on its first call
+        CallStats::Command* call_stats = nullptr;
     };
 
     using InvokerFn = void(ServiceFrameworkBase* object, HandlerFnP<ServiceFrameworkBase> member,
@@ -17,6 +17,7 @@
 #include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
+#include "core/rpc/rpc_server.h"
 #include "core/tracer/recorder.h"
 #include "video_core/command_processor.h"
 #include "video_core/debug_utils/debug_utils.h"
@@ -506,13 +507,16 @@ template void Write<u8>(u32 addr, const u8 data);
 static void VBlankCallback(u64 userdata, s64 cycles_late) {
     VideoCore::g_renderer->SwapBuffers();
 
+    // Batched RPC requests see the memory of a whole frame
+    Core::System::GetInstance().RPCServer().HandleFrameRequests();
+
     // Signal to GSP that GPU interrupt has occurred
     // TODO(yuriks): hwtest to determine if PDC0 is for the Top screen and PDC1 for the Sub
     // screen, or if both use the same interrupts and these two instead determine the
     // beginning and end of the VBlank period. If needed, split the interrupt firing into
     // two different intervals.
-    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PDC0);
-    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PDC1);
+    Service::GSP::SignalInterrupts(
+        {Service::GSP::InterruptId::PDC0, Service::GSP::InterruptId::PDC1});
 
     // Reschedule recurrent event
     Core::System::GetInstance().CoreTiming().ScheduleEvent(frame_ticks - cycles_late, vblank_event);
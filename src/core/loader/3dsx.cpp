@@ -309,6 +309,13 @@ ResultStatus AppLoader_THREEDSX::ReadRomFS(std::shared_ptr<FileSys::RomFSReader>
         LOG_DEBUG(Loader, "RomFS offset:           {:#010X}", romfs_offset);
         LOG_DEBUG(Loader, "RomFS size:             {:#010X}", romfs_size);
 
+        FileUtil::MappedFile romfs_mapping(filepath);
+        if (romfs_mapping.IsOpen()) {
+            romfs_file = std::make_shared<FileSys::MappedRomFSReader>(std::move(romfs_mapping),
+                                                                      romfs_offset, romfs_size);
+            return ResultStatus::Success;
+        }
+
         // We reopen the file, to allow its position to be independent from file's
         FileUtil::IOFile romfs_file_inner(filepath, "rb");
         if (!romfs_file_inner.IsOpen())
@@ -0,0 +1,243 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/vector.hpp>
+#include "common/archives.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "core/hle/service/am/am.h"
+#include "core/hle/service/fs/archive.h"
+#include "core/loader/game_scanner.h"
+#include "core/loader/smdh.h"
+
+namespace Loader {
+
+namespace {
+
+/// Bumped whenever GameEntry or the way it is read changes, which discards older caches
+constexpr u32 CacheVersion = 2;
+
+/// Returns the path of the installed update of a title, or an empty string if it has none
+std::string GetUpdatePath(u64 program_id) {
+    if (program_id & ~0x00040000FFFFFFFF) {
+        return {};
+    }
+    std::string update_path = Service::AM::GetTitleContentPath(Service::FS::MediaType::SDMC,
+                                                                program_id | 0x0000000E00000000);
+    if (!FileUtil::Exists(update_path)) {
+        return {};
+    }
+    return update_path;
+}
+
+u64 GetUpdateModificationTime(u64 program_id) {
+    const std::string update_path = GetUpdatePath(program_id);
+    return update_path.empty() ? 0 : FileUtil::GetModificationTime(update_path);
+}
+
+/// Opens the file to fill in the metadata of an entry
+void ReadMetadata(GameEntry& entry) {
+    std::unique_ptr<AppLoader> loader = GetLoader(entry.path);
+    if (!loader) {
+        return;
+    }
+
+    bool executable = false;
+    const auto res = loader->IsExecutable(executable);
+    if (!executable && res != ResultStatus::ErrorEncrypted) {
+        return;
+    }
+
+    entry.is_game = true;
+    entry.file_type = loader->GetFileType();
+    loader->ReadProgramId(entry.program_id);
+    loader->ReadExtdataId(entry.extdata_id);
+
+    // Look for an update icon if available
+    const std::string update_path = GetUpdatePath(entry.program_id);
+    if (!update_path.empty()) {
+        entry.update_modification_time = FileUtil::GetModificationTime(update_path);
+        std::unique_ptr<AppLoader> update_loader = GetLoader(update_path);
+        if (update_loader) {
+            update_loader->ReadIcon(entry.smdh);
+        }
+    }
+
+    if (!IsValidSMDH(entry.smdh)) {
+        // Read the original smdh if there is no valid update smdh
+        entry.smdh.clear();
+        loader->ReadIcon(entry.smdh);
+    }
+}
+
+} // Anonymous namespace
+
+GameScanner::GameScanner(std::string cache_path_, std::size_t num_threads_)
+    : cache_path(std::move(cache_path_)), num_threads(num_threads_) {
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+}
+
+GameScanner::~GameScanner() = default;
+
+void GameScanner::Scan(const std::vector<std::string>& paths, const Callback& callback) {
+    if (!cache_loaded) {
+        LoadCache();
+        cache_loaded = true;
+    }
+
+    std::mutex mutex;
+    std::condition_variable entry_ready;
+    std::vector<std::optional<GameEntry>> entries(paths.size());
+    std::atomic<std::size_t> next_path = 0;
+    std::size_t threads_running = std::min(num_threads, paths.size());
+
+    const auto scan_paths = [&] {
+        while (!stop_processing) {
+            const std::size_t index = next_path++;
+            if (index >= paths.size()) {
+                break;
+            }
+            GameEntry entry = GetEntry(paths[index]);
+            {
+                std::lock_guard lock{mutex};
+                entries[index] = std::move(entry);
+            }
+            entry_ready.notify_one();
+        }
+        {
+            std::lock_guard lock{mutex};
+            --threads_running;
+        }
+        entry_ready.notify_one();
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < threads_running; ++i) {
+        threads.emplace_back(scan_paths);
+    }
+
+    // Report the entries in order as they come in, until the scan ends or is cancelled
+    for (std::size_t index = 0; index < paths.size(); ++index) {
+        std::optional<GameEntry> entry;
+        {
+            std::unique_lock lock{mutex};
+            entry_ready.wait(lock, [&] { return entries[index] || threads_running == 0; });
+            entry.swap(entries[index]);
+        }
+        if (!entry) {
+            break;
+        }
+        if (entry->is_game) {
+            callback(*entry);
+        }
+        scanned_entries.insert_or_assign(entry->path, std::move(*entry));
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void GameScanner::Cancel() {
+    stop_processing = true;
+}
+
+GameEntry GameScanner::GetEntry(const std::string& path) const {
+    GameEntry entry;
+    entry.path = path;
+    entry.scan_time = static_cast<u64>(std::time(nullptr));
+    entry.size = FileUtil::GetSize(path);
+    entry.modification_time = FileUtil::GetModificationTime(path);
+
+    const auto it = cached_entries.find(path);
+    if (it != cached_entries.end() && it->second.size == entry.size &&
+        it->second.modification_time == entry.modification_time &&
+        it->second.modification_time < it->second.scan_time &&
+        (!it->second.is_game ||
+         (it->second.update_modification_time < it->second.scan_time &&
+          it->second.update_modification_time ==
+              GetUpdateModificationTime(it->second.program_id)))) {
+        return it->second;
+    }
+
+    ReadMetadata(entry);
+    return entry;
+}
+
+void GameScanner::LoadCache() {
+    if (cache_path.empty()) {
+        return;
+    }
+
+    FileUtil::IOFile file(cache_path, "rb");
+    if (!file.IsOpen()) {
+        LOG_INFO(Loader, "No game list cache found at {}", cache_path);
+        return;
+    }
+
+    std::vector<u8> compressed(file.GetSize());
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(Loader, "Failed to read game list cache {}", cache_path);
+        return;
+    }
+    const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(compressed);
+
+    try {
+        std::istringstream sstream{
+            std::string{reinterpret_cast<const char*>(decompressed.data()), decompressed.size()},
+            std::ios_base::binary};
+        iarchive ia{sstream};
+        u32 version;
+        ia >> version;
+        if (version != CacheVersion) {
+            LOG_INFO(Loader, "Game list cache is from another version of the emulator");
+            return;
+        }
+        ia >> cached_entries;
+    } catch (const std::exception& e) {
+        LOG_ERROR(Loader, "Failed to load game list cache {}: {}", cache_path, e.what());
+        cached_entries.clear();
+    }
+}
+
+void GameScanner::SaveCache() const {
+    if (cache_path.empty()) {
+        return;
+    }
+
+    std::ostringstream sstream{std::ios_base::binary};
+    {
+        oarchive oa{sstream};
+        oa << CacheVersion;
+        oa << scanned_entries;
+    }
+
+    const std::string& str{sstream.str()};
+    const std::vector<u8> compressed = Common::Compression::CompressDataZSTDDefault(
+        reinterpret_cast<const u8*>(str.data()), str.size());
+
+    if (!FileUtil::CreateFullPath(cache_path)) {
+        LOG_ERROR(Loader, "Failed to create the path of game list cache {}", cache_path);
+        return;
+    }
+    FileUtil::IOFile file(cache_path, "wb");
+    if (!file.IsOpen() ||
+        file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_ERROR(Loader, "Failed to write game list cache {}", cache_path);
+    }
+}
+
+} // namespace Loader
@@ -0,0 +1,100 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/serialization/access.hpp>
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+namespace Loader {
+
+/// Metadata of a game file, as shown by game lists
+struct GameEntry {
+    std::string path;
+    u64 size = 0;
+    u64 modification_time = 0;
+    /// When the file was read. Modification times only have a resolution of a second, so a file
+    /// modified in the second it was read in could change again without its time changing.
+    u64 scan_time = 0;
+    /// Modification time of the installed update the SMDH was read from, 0 if there was none
+    u64 update_modification_time = 0;
+
+    /// Whether the file can be launched. Other files are cached too, so they are not reopened.
+    bool is_game = false;
+    FileType file_type = FileType::Unknown;
+    u64 program_id = 0;
+    u64 extdata_id = 0;
+    /// SMDH of the installed update if it has a valid one, or of the game otherwise
+    std::vector<u8> smdh;
+
+private:
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& path;
+        ar& size;
+        ar& modification_time;
+        ar& scan_time;
+        ar& update_modification_time;
+        ar& is_game;
+        ar& file_type;
+        ar& program_id;
+        ar& extdata_id;
+        ar& smdh;
+    }
+    friend class boost::serialization::access;
+};
+
+/**
+ * Reads the metadata of game files on a pool of threads. The metadata is kept in a cache file
+ * keyed by path, size and modification time, so files that did not change are not opened again.
+ * Files modified in the same second they were read in are opened again, as their modification
+ * time would not show a later change within that second.
+ */
+class GameScanner {
+public:
+    using Callback = std::function<void(const GameEntry& entry)>;
+
+    /**
+     * @param cache_path Path of the cache file, or empty to not use one
+     * @param num_threads Number of scanning threads, 0 for one per host thread
+     */
+    explicit GameScanner(std::string cache_path, std::size_t num_threads = 0);
+    ~GameScanner();
+
+    /**
+     * Reads the metadata of files. The callback is called on the calling thread for each game
+     * found, in the order of the paths given.
+     */
+    void Scan(const std::vector<std::string>& paths, const Callback& callback);
+
+    /// Stops the scan in progress. Thread-safe.
+    void Cancel();
+
+    /// Writes the entries of the files scanned so far to the cache file, dropping the others
+    void SaveCache() const;
+
+private:
+    void LoadCache();
+
+    /// Returns the cached entry of a file if it is still up to date, or reads it otherwise
+    GameEntry GetEntry(const std::string& path) const;
+
+    std::string cache_path;
+    std::size_t num_threads;
+    std::atomic_bool stop_processing = false;
+
+    /// Entries read from the cache file, loaded by the first scan
+    std::unordered_map<std::string, GameEntry> cached_entries;
+    bool cache_loaded = false;
+    /// Entries of the files scanned, which are written back to the cache file
+    std::unordered_map<std::string, GameEntry> scanned_entries;
+};
+
+} // namespace Loader
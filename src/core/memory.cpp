@@ -429,6 +429,10 @@ const u8* MemorySystem::GetPointer(const VAddr vaddr) const {
     return nullptr;
 }
 
+u8* MemorySystem::GetPagePointer(const VAddr vaddr) {
+    return impl->current_page_table->pointers[vaddr >> PAGE_BITS];
+}
+
 std::string MemorySystem::ReadCString(VAddr vaddr, std::size_t max_length) {
     std::string string;
     string.reserve(max_length);
@@ -665,55 +669,137 @@ u64 MemorySystem::Read64(const VAddr addr) {
     return Read<u64_le>(addr);
 }
 
+/// A run of consecutive pages that can be serviced by a single host operation.
+struct BlockRun {
+    PageType type;
+    /// Virtual address of the first byte in the run.
+    VAddr vaddr;
+    /// Host pointer backing the run, only valid for Memory and RasterizerCachedMemory runs.
+    u8* pointer;
+    /// MMIO handler backing the run, only valid for Special runs.
+    MMIORegionPointer handler;
+    /// Size of the run in bytes.
+    std::size_t size;
+    /// Offset of the run from the start of the walked range.
+    std::size_t offset;
+};
+
+/**
+ * Returns the end of the rasterizer-cacheable region containing `addr`. Inside such a region,
+ * GetPointerForRasterizerCache maps virtual addresses linearly onto host memory.
+ */
+static VAddr GetRasterizerCacheRegionEnd(VAddr addr) {
+    if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
+        return LINEAR_HEAP_VADDR_END;
+    }
+    if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END) {
+        return NEW_LINEAR_HEAP_VADDR_END;
+    }
+    if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
+        return VRAM_VADDR_END;
+    }
+    UNREACHABLE();
+}
+
+template <typename Func>
+void MemorySystem::WalkBlock(PageTable& page_table, const VAddr start_addr, const std::size_t size,
+                             Func&& func) const {
+    std::size_t offset = 0;
+    std::size_t page_index = start_addr >> PAGE_BITS;
+    std::size_t page_offset = start_addr & PAGE_MASK;
+
+    while (offset < size) {
+        BlockRun run{};
+        run.type = page_table.attributes[page_index];
+        run.vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+        run.offset = offset;
+
+        VAddr cache_region_end = 0;
+        switch (run.type) {
+        case PageType::Memory:
+            DEBUG_ASSERT(page_table.pointers[page_index]);
+            run.pointer = page_table.pointers[page_index] + page_offset;
+            break;
+        case PageType::RasterizerCachedMemory:
+            run.pointer = GetPointerForRasterizerCache(run.vaddr);
+            cache_region_end = GetRasterizerCacheRegionEnd(run.vaddr);
+            break;
+        case PageType::Special:
+            run.handler = GetMMIOHandler(page_table, run.vaddr);
+            DEBUG_ASSERT(run.handler);
+            break;
+        default:
+            break;
+        }
+
+        run.size = std::min<std::size_t>(PAGE_SIZE - page_offset, size - offset);
+        page_index++;
+
+        // Extend the run for as long as the following pages continue it on the host side
+        while (run.offset + run.size < size && page_table.attributes[page_index] == run.type) {
+            const VAddr page_vaddr = static_cast<VAddr>(page_index << PAGE_BITS);
+            bool contiguous = true;
+            switch (run.type) {
+            case PageType::Memory:
+                contiguous = static_cast<u8*>(page_table.pointers[page_index]) ==
+                             run.pointer + run.size;
+                break;
+            case PageType::RasterizerCachedMemory:
+                contiguous = page_vaddr < cache_region_end;
+                break;
+            case PageType::Special:
+                contiguous = GetMMIOHandler(page_table, page_vaddr) == run.handler;
+                break;
+            default:
+                break;
+            }
+            if (!contiguous) {
+                break;
+            }
+
+            run.size += std::min<std::size_t>(PAGE_SIZE, size - run.offset - run.size);
+            page_index++;
+        }
+
+        func(run);
+
+        offset += run.size;
+        page_offset = 0;
+    }
+}
+
 void MemorySystem::ReadBlock(const Kernel::Process& process, const VAddr src_addr,
                              void* dest_buffer, const std::size_t size) {
     auto& page_table = *process.vm_manager.page_table;
+    u8* const dest = static_cast<u8*>(dest_buffer);
 
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
+    WalkBlock(page_table, src_addr, size, [&](const BlockRun& run) {
+        switch (run.type) {
         case PageType::Unmapped: {
             LOG_ERROR(HW_Memory,
                       "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
                       "0x{:08X}",
-                      current_vaddr, src_addr, size, Core::GetRunningCore().GetPC());
-            std::memset(dest_buffer, 0, copy_amount);
+                      run.vaddr, src_addr, size, Core::GetRunningCore().GetPC());
+            std::memset(dest + run.offset, 0, run.size);
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_buffer, src_ptr, copy_amount);
+            std::memcpy(dest + run.offset, run.pointer, run.size);
             break;
         }
         case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->ReadBlock(current_vaddr, dest_buffer, copy_amount);
+            run.handler->ReadBlock(run.vaddr, dest + run.offset, run.size);
             break;
         }
         case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
+            RasterizerFlushVirtualRegion(run.vaddr, static_cast<u32>(run.size), FlushMode::Flush);
+            std::memcpy(dest + run.offset, run.pointer, run.size);
             break;
         }
         default:
             UNREACHABLE();
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemorySystem::Write8(const VAddr addr, const u8 data) {
@@ -735,100 +821,74 @@ void MemorySystem::Write64(const VAddr addr, const u64 data) {
 void MemorySystem::WriteBlock(const Kernel::Process& process, const VAddr dest_addr,
                               const void* src_buffer, const std::size_t size) {
     auto& page_table = *process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+    const u8* const src = static_cast<const u8*>(src_buffer);
 
-        switch (page_table.attributes[page_index]) {
+    WalkBlock(page_table, dest_addr, size, [&](const BlockRun& run) {
+        switch (run.type) {
         case PageType::Unmapped: {
             LOG_ERROR(HW_Memory,
                       "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
                       "0x{:08X}",
-                      current_vaddr, dest_addr, size, Core::GetRunningCore().GetPC());
+                      run.vaddr, dest_addr, size, Core::GetRunningCore().GetPC());
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memcpy(dest_ptr, src_buffer, copy_amount);
+            std::memcpy(run.pointer, src + run.offset, run.size);
             break;
         }
         case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, src_buffer, copy_amount);
+            run.handler->WriteBlock(run.vaddr, src + run.offset, run.size);
             break;
         }
         case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+            RasterizerFlushVirtualRegion(run.vaddr, static_cast<u32>(run.size),
                                          FlushMode::Invalidate);
-            std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
+            std::memcpy(run.pointer, src + run.offset, run.size);
             break;
         }
         default:
             UNREACHABLE();
         }
-
-        page_index++;
-        page_offset = 0;
-        src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
     auto& page_table = *process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> PAGE_BITS;
-    std::size_t page_offset = dest_addr & PAGE_MASK;
 
     static const std::array<u8, PAGE_SIZE> zeros = {};
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
+    WalkBlock(page_table, dest_addr, size, [&](const BlockRun& run) {
+        switch (run.type) {
         case PageType::Unmapped: {
             LOG_ERROR(HW_Memory,
                       "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
                       "0x{:08X}",
-                      current_vaddr, dest_addr, size, Core::GetRunningCore().GetPC());
+                      run.vaddr, dest_addr, size, Core::GetRunningCore().GetPC());
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
+            std::memset(run.pointer, 0, run.size);
             break;
         }
         case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            handler->WriteBlock(current_vaddr, zeros.data(), copy_amount);
+            for (std::size_t written = 0; written < run.size; written += zeros.size()) {
+                const std::size_t chunk = std::min(zeros.size(), run.size - written);
+                run.handler->WriteBlock(run.vaddr + static_cast<VAddr>(written), zeros.data(),
+                                        chunk);
+            }
             break;
         }
         case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+            RasterizerFlushVirtualRegion(run.vaddr, static_cast<u32>(run.size),
                                          FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
+            std::memset(run.pointer, 0, run.size);
             break;
         }
         default:
             UNREACHABLE();
         }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
@@ -840,54 +900,37 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
     auto& page_table = *src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> PAGE_BITS;
-    std::size_t page_offset = src_addr & PAGE_MASK;
 
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
+    WalkBlock(page_table, src_addr, size, [&](const BlockRun& run) {
+        const VAddr run_dest_addr = dest_addr + static_cast<VAddr>(run.offset);
+        switch (run.type) {
         case PageType::Unmapped: {
             LOG_ERROR(HW_Memory,
                       "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
                       "0x{:08X}",
-                      current_vaddr, src_addr, size, Core::GetRunningCore().GetPC());
-            ZeroBlock(dest_process, dest_addr, copy_amount);
+                      run.vaddr, src_addr, size, Core::GetRunningCore().GetPC());
+            ZeroBlock(dest_process, run_dest_addr, run.size);
             break;
         }
         case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
+            WriteBlock(dest_process, run_dest_addr, run.pointer, run.size);
             break;
         }
         case PageType::Special: {
-            MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
-            DEBUG_ASSERT(handler);
-            std::vector<u8> buffer(copy_amount);
-            handler->ReadBlock(current_vaddr, buffer.data(), buffer.size());
-            WriteBlock(dest_process, dest_addr, buffer.data(), buffer.size());
+            std::vector<u8> buffer(run.size);
+            run.handler->ReadBlock(run.vaddr, buffer.data(), buffer.size());
+            WriteBlock(dest_process, run_dest_addr, buffer.data(), buffer.size());
             break;
         }
         case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
+            RasterizerFlushVirtualRegion(run.vaddr, static_cast<u32>(run.size), FlushMode::Flush);
+            WriteBlock(dest_process, run_dest_addr, run.pointer, run.size);
             break;
         }
         default:
             UNREACHABLE();
         }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    });
 }
 
 template <>
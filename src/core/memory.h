@@ -348,8 +348,15 @@ public:
     MemoryRef GetPhysicalRef(PAddr address) const;
 
     u8* GetPointer(VAddr vaddr);
+
     const u8* GetPointer(VAddr vaddr) const;
 
+    /**
+     * Gets the host pointer of the page containing an address if it is memory that can be accessed
+     * directly, or nullptr if it is unmapped, MMIO or cached by the rasterizer.
+     */
+    u8* GetPagePointer(VAddr vaddr);
+
     bool IsValidPhysicalAddress(PAddr paddr) const;
 
     /// Gets offset in FCRAM from a pointer inside FCRAM range
@@ -392,6 +399,14 @@ private:
      */
     MemoryRef GetPointerForRasterizerCache(VAddr addr) const;
 
+    /**
+     * Splits a virtual address range into maximal runs of pages that can each be serviced with a
+     * single host operation (one memcpy, one rasterizer flush or one MMIO block access) and
+     * invokes `func` once per run.
+     */
+    template <typename Func>
+    void WalkBlock(PageTable& page_table, VAddr start_addr, std::size_t size, Func&& func) const;
+
     void MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef memory, PageType type);
 
     class Impl;
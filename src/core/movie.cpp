@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 #include <boost/optional.hpp>
 #include <cryptopp/hex.h>
@@ -12,9 +15,11 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/scope_exit.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "common/timer.h"
+#include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/hle/service/ir/extra_hid.h"
@@ -33,7 +38,8 @@ enum class ControllerStateType : u8 {
     Accelerometer,
     Gyroscope,
     IrRst,
-    ExtraHidResponse
+    ExtraHidResponse,
+    Count,
 };
 
 #pragma pack(push, 1)
@@ -111,18 +117,62 @@ static_assert(sizeof(ControllerState) == 7, "ControllerState should be 7 bytes")
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'T', 'M', 0x1B}};
 
+/**
+ * Movie file versions. Version 0 movies are the header followed by the input records. Version 1
+ * movies are the header, the delta-encoded input compressed with zstd, a table of keyframes and
+ * the compressed savestates of the keyframes.
+ */
+constexpr u32 MovieVersionRawInput = 0;
+constexpr u32 MovieVersionIndexed = 1;
+
 #pragma pack(push, 1)
 struct CTMHeader {
     std::array<u8, 4> filetype;  /// Unique Identifier to check the file type (always "CTM"0x1B)
     u64_le program_id;           /// ID of the ROM being executed. Also called title_id
     std::array<u8, 20> revision; /// Git hash of the revision this movie was created with
     u64_le clock_init_time;      /// The init time of the system clock
+    u32_le version;              /// Format of the rest of the file, 0 in older movies
+    u32_le keyframe_count;       /// Number of entries in the keyframe table
+    u64_le input_size;           /// Size of the input records once decompressed
+    u64_le compressed_input_size;
 
-    std::array<u8, 216> reserved; /// Make heading 256 bytes so it has consistent size
+    std::array<u8, 192> reserved; /// Make heading 256 bytes so it has consistent size
 };
 static_assert(sizeof(CTMHeader) == 256, "CTMHeader should be 256 bytes");
+
+struct CTMKeyframeEntry {
+    u64_le frame;        /// Number of frames played before the keyframe
+    u64_le input_offset; /// Offset of the next input record in the decompressed input
+    u64_le state_offset; /// Offset of the compressed savestate in the file
+    u64_le state_size;   /// Size of the compressed savestate
+};
+static_assert(sizeof(CTMKeyframeEntry) == 32, "CTMKeyframeEntry should be 32 bytes");
 #pragma pack(pop)
 
+/**
+ * Replaces each input record by its XOR with the previous record of the same type, or reverts
+ * that. Input rarely changes between updates, so this leaves mostly zeroes, which compress well.
+ */
+static std::vector<u8> DeltaCodeInput(const std::vector<u8>& input, bool decode) {
+    constexpr std::size_t record_size = sizeof(ControllerState);
+    std::array<std::array<u8, record_size>, static_cast<std::size_t>(ControllerStateType::Count)>
+        previous{};
+
+    std::vector<u8> output(input);
+    for (std::size_t offset = 0; offset + record_size <= input.size(); offset += record_size) {
+        const u8 type = input[offset];
+        if (type >= previous.size()) {
+            continue;
+        }
+        auto& last = previous[type];
+        for (std::size_t i = 1; i < record_size; ++i) {
+            output[offset + i] = input[offset + i] ^ last[i];
+        }
+        std::memcpy(last.data(), decode ? &output[offset] : &input[offset], record_size);
+    }
+    return output;
+}
+
 bool Movie::IsPlayingInput() const {
     return play_mode == PlayMode::Playing;
 }
@@ -130,8 +180,47 @@ bool Movie::IsRecordingInput() const {
     return play_mode == PlayMode::Recording;
 }
 
+/// Counts the frames, which start with a pad state record, in the first input_end bytes of input
+static u64 CountFrames(const std::vector<u8>& input, std::size_t input_end) {
+    u64 frames = 0;
+    for (std::size_t offset = 0;
+         offset + sizeof(ControllerState) <= std::min(input_end, input.size());
+         offset += sizeof(ControllerState)) {
+        if (input[offset] == static_cast<u8>(ControllerStateType::PadAndCircle)) {
+            ++frames;
+        }
+    }
+    return frames;
+}
+
+u64 Movie::GetCurrentFrame() const {
+    return current_frame;
+}
+
+u64 Movie::GetFrameCount() const {
+    return IsRecordingInput() ? current_frame : frame_count;
+}
+
+void Movie::UpdateAfterStateLoad() {
+    current_frame = CountFrames(recorded_input, current_byte);
+    if (IsRecordingInput()) {
+        DropKeyframesAhead();
+    }
+}
+
+void Movie::DropKeyframesAhead() {
+    keyframes.erase(std::find_if(keyframes.begin(), keyframes.end(),
+                                 [this](const Keyframe& keyframe) {
+                                     return keyframe.input_offset > current_byte;
+                                 }),
+                    keyframes.end());
+}
+
 void Movie::CheckInputEnd() {
     if (current_byte + sizeof(ControllerState) > recorded_input.size()) {
+        if (seek_target) {
+            FinishSeek();
+        }
         LOG_INFO(Movie, "Playback finished");
         play_mode = PlayMode::None;
         init_time = 0;
@@ -150,6 +239,7 @@ void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circ
                   static_cast<int>(ControllerStateType::PadAndCircle), s.type);
         return;
     }
+    ++current_frame;
 
     pad_state.a.Assign(s.pad_and_circle.a);
     pad_state.b.Assign(s.pad_and_circle.b);
@@ -266,6 +356,13 @@ void Movie::Record(const ControllerState& controller_state) {
     recorded_input.resize(current_byte + sizeof(ControllerState));
     std::memcpy(&recorded_input[current_byte], &controller_state, sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
+
+    if (controller_state.type == ControllerStateType::PadAndCircle) {
+        ++current_frame;
+        if (keyframe_interval != 0 && current_frame % keyframe_interval == 0) {
+            keyframe_requested = true;
+        }
+    }
 }
 
 void Movie::Record(const Service::HID::PadState& pad_state, const s16& circle_pad_x,
@@ -354,6 +451,16 @@ void Movie::Record(const Service::IR::ExtraHIDResponse& extra_hid_response) {
     Record(s);
 }
 
+/// Returns the program id of the running application, or 0 when there is none
+static u64 GetRunningProgramId() {
+    u64 program_id = 0;
+    auto& system = Core::System::GetInstance();
+    if (system.IsPoweredOn()) {
+        system.GetAppLoader().ReadProgramId(program_id);
+    }
+    return program_id;
+}
+
 u64 Movie::GetOverrideInitTime() const {
     return init_time;
 }
@@ -367,7 +474,7 @@ Movie::ValidationResult Movie::ValidateHeader(const CTMHeader& header, u64 progr
     std::string revision = fmt::format("{:02x}", fmt::join(header.revision, ""));
 
     if (!program_id)
-        Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id);
+        program_id = GetRunningProgramId();
     if (program_id != header.program_id) {
         LOG_WARNING(Movie, "This movie was recorded using a ROM with a different program id");
         return ValidationResult::GameDismatch;
@@ -394,22 +501,94 @@ void Movie::SaveMovie() {
     CTMHeader header = {};
     header.filetype = header_magic_bytes;
     header.clock_init_time = init_time;
-
-    Core::System::GetInstance().GetAppLoader().ReadProgramId(header.program_id);
+    header.program_id = GetRunningProgramId();
 
     std::string rev_bytes;
     CryptoPP::StringSource(Common::g_scm_rev, true,
                            new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
     std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(CTMHeader::revision));
 
+    const std::vector<u8> encoded_input = DeltaCodeInput(recorded_input, false);
+    const std::vector<u8> compressed_input =
+        Common::Compression::CompressDataZSTDDefault(encoded_input.data(), encoded_input.size());
+    header.version = MovieVersionIndexed;
+    header.keyframe_count = static_cast<u32>(keyframes.size());
+    header.input_size = recorded_input.size();
+    header.compressed_input_size = compressed_input.size();
+
+    std::vector<CTMKeyframeEntry> keyframe_table(keyframes.size());
+    u64 state_offset = sizeof(CTMHeader) + compressed_input.size() +
+                       keyframe_table.size() * sizeof(CTMKeyframeEntry);
+    for (std::size_t i = 0; i < keyframes.size(); ++i) {
+        keyframe_table[i].frame = keyframes[i].frame;
+        keyframe_table[i].input_offset = keyframes[i].input_offset;
+        keyframe_table[i].state_offset = state_offset;
+        keyframe_table[i].state_size = keyframes[i].state.size();
+        state_offset += keyframes[i].state.size();
+    }
+
     save_record.WriteBytes(&header, sizeof(CTMHeader));
-    save_record.WriteBytes(recorded_input.data(), recorded_input.size());
+    save_record.WriteBytes(compressed_input.data(), compressed_input.size());
+    save_record.WriteArray(keyframe_table.data(), keyframe_table.size());
+    for (const Keyframe& keyframe : keyframes) {
+        save_record.WriteBytes(keyframe.state.data(), keyframe.state.size());
+    }
 
     if (!save_record.IsGood()) {
         LOG_ERROR(Movie, "Error saving movie");
     }
 }
 
+bool Movie::LoadMovie(FileUtil::IOFile& file, const CTMHeader& header) {
+    const u64 size = file.GetSize();
+    keyframes.clear();
+
+    if (header.version == MovieVersionRawInput) {
+        recorded_input.resize(size - sizeof(CTMHeader));
+        return file.ReadArray(recorded_input.data(), recorded_input.size()) ==
+               recorded_input.size();
+    }
+    if (header.version != MovieVersionIndexed) {
+        LOG_ERROR(Movie, "Unsupported movie version {}", static_cast<u32>(header.version));
+        return false;
+    }
+
+    const u64 table_size = static_cast<u64>(header.keyframe_count) * sizeof(CTMKeyframeEntry);
+    if (header.compressed_input_size > size - sizeof(CTMHeader) ||
+        table_size > size - sizeof(CTMHeader) - header.compressed_input_size) {
+        LOG_ERROR(Movie, "Movie file is truncated");
+        return false;
+    }
+
+    std::vector<u8> compressed_input(header.compressed_input_size);
+    if (file.ReadBytes(compressed_input.data(), compressed_input.size()) !=
+        compressed_input.size()) {
+        return false;
+    }
+    const std::vector<u8> encoded_input = Common::Compression::DecompressDataZSTD(compressed_input);
+    if (encoded_input.size() != header.input_size) {
+        LOG_ERROR(Movie, "Movie input is corrupted");
+        return false;
+    }
+    recorded_input = DeltaCodeInput(encoded_input, true);
+
+    std::vector<CTMKeyframeEntry> keyframe_table(header.keyframe_count);
+    if (file.ReadArray(keyframe_table.data(), keyframe_table.size()) != keyframe_table.size()) {
+        return false;
+    }
+    for (const CTMKeyframeEntry& entry : keyframe_table) {
+        if (entry.input_offset > recorded_input.size() || entry.state_offset > size ||
+            entry.state_size > size - entry.state_offset) {
+            LOG_ERROR(Movie, "Movie keyframe table is corrupted");
+            return false;
+        }
+        // The savestates are only read when seeking, to keep long movies out of memory
+        keyframes.push_back({entry.frame, entry.input_offset, {}, entry.state_offset,
+                             entry.state_size});
+    }
+    return true;
+}
+
 void Movie::StartPlayback(const std::string& movie_file,
                           std::function<void()> completion_callback) {
     LOG_INFO(Movie, "Loading Movie for playback");
@@ -420,10 +599,17 @@ void Movie::StartPlayback(const std::string& movie_file,
         CTMHeader header;
         save_record.ReadArray(&header, 1);
         if (ValidateHeader(header) != ValidationResult::Invalid) {
+            if (!LoadMovie(save_record, header)) {
+                LOG_ERROR(Movie, "Failed to playback movie: Unable to read '{}'", movie_file);
+                recorded_input.clear();
+                keyframes.clear();
+                return;
+            }
             play_mode = PlayMode::Playing;
-            recorded_input.resize(size - sizeof(CTMHeader));
-            save_record.ReadArray(recorded_input.data(), recorded_input.size());
+            playback_movie_file = movie_file;
             current_byte = 0;
+            current_frame = 0;
+            frame_count = CountFrames(recorded_input, recorded_input.size());
             playback_completion_callback = completion_callback;
         }
     } else {
@@ -431,10 +617,15 @@ void Movie::StartPlayback(const std::string& movie_file,
     }
 }
 
-void Movie::StartRecording(const std::string& movie_file) {
+void Movie::StartRecording(const std::string& movie_file, u32 keyframe_interval_) {
     LOG_INFO(Movie, "Enabling Movie recording");
     play_mode = PlayMode::Recording;
     record_movie_file = movie_file;
+    keyframe_interval = keyframe_interval_;
+    keyframes.clear();
+    current_frame = 0;
+    // Taken before the first slice, so any frame of the movie can be sought to
+    keyframe_requested = keyframe_interval != 0;
 }
 
 static boost::optional<CTMHeader> ReadHeader(const std::string& movie_file) {
@@ -494,12 +685,154 @@ void Movie::Shutdown() {
     play_mode = PlayMode::None;
     recorded_input.resize(0);
     record_movie_file.clear();
+    playback_movie_file.clear();
     current_byte = 0;
     init_time = 0;
+    current_frame = 0;
+    frame_count = 0;
+    keyframe_interval = 0;
+    keyframes.clear();
+    keyframe_requested = false;
+    {
+        std::lock_guard lock{seek_mutex};
+        seek_frame.reset();
+        requested_seek_callback = nullptr;
+        seek_requested = false;
+    }
+    if (seek_target) {
+        seek_target.reset();
+        seek_completion_callback = nullptr;
+        Core::System::GetInstance().frame_limiter.SetFastForwarding(false);
+    }
+}
+
+void Movie::SeekToFrame(u64 frame, std::function<void()> completion_callback) {
+    std::lock_guard lock{seek_mutex};
+    seek_frame = frame;
+    requested_seek_callback = std::move(completion_callback);
+    seek_requested = true;
+}
+
+void Movie::SetKeyframeStateHandlers(SaveStateHandler save_state, LoadStateHandler load_state) {
+    save_state_handler = std::move(save_state);
+    load_state_handler = std::move(load_state);
+}
+
+void Movie::HandleKeyframeRequests() {
+    if (keyframe_requested) {
+        keyframe_requested = false;
+        if (IsRecordingInput()) {
+            CaptureKeyframe();
+        }
+    }
+
+    if (!seek_requested.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::optional<u64> frame;
+    std::function<void()> callback;
+    {
+        std::lock_guard lock{seek_mutex};
+        frame = std::exchange(seek_frame, std::nullopt);
+        callback = std::exchange(requested_seek_callback, nullptr);
+        seek_requested = false;
+    }
+    if (frame && (IsPlayingInput() || IsRecordingInput())) {
+        LoadKeyframe(*frame, std::move(callback));
+    }
+}
+
+void Movie::CaptureKeyframe() {
+    serializing_keyframe = true;
+    SCOPE_EXIT({ serializing_keyframe = false; });
+
+    try {
+        std::vector<u8> state;
+        if (save_state_handler) {
+            state = save_state_handler();
+        } else if (auto& system = Core::System::GetInstance(); system.IsPoweredOn()) {
+            state = system.SaveStateToBuffer();
+        }
+        // Without an emulated system to save, the keyframe only holds the position in the input
+        keyframes.push_back({current_frame, current_byte, std::move(state), 0, 0});
+    } catch (const std::exception& e) {
+        LOG_ERROR(Movie, "Could not save keyframe at frame {}: {}", current_frame, e.what());
+    }
+}
+
+void Movie::LoadKeyframe(u64 frame, std::function<void()> completion_callback) {
+    // The input is only known up to the last frame played or recorded
+    frame = std::min(frame, IsRecordingInput() ? CountFrames(recorded_input, recorded_input.size())
+                                               : frame_count);
+    auto itr = std::upper_bound(
+        keyframes.begin(), keyframes.end(), frame,
+        [](u64 value, const Keyframe& keyframe) { return value < keyframe.frame; });
+    if (itr == keyframes.begin()) {
+        LOG_ERROR(Movie, "No keyframe at or before frame {}", frame);
+        return;
+    }
+    --itr;
+
+    std::vector<u8> state = itr->state;
+    if (state.empty() && itr->state_size != 0) {
+        FileUtil::IOFile file(playback_movie_file, "rb");
+        state.resize(itr->state_size);
+        if (!file.Seek(itr->file_offset, SEEK_SET) ||
+            file.ReadBytes(state.data(), state.size()) != state.size()) {
+            throw std::runtime_error("Could not read keyframe from " + playback_movie_file);
+        }
+    }
+
+    if (!state.empty()) {
+        serializing_keyframe = true;
+        SCOPE_EXIT({ serializing_keyframe = false; });
+        if (load_state_handler) {
+            load_state_handler(state);
+        } else {
+            Core::System::GetInstance().LoadStateFromBuffer(state);
+        }
+    }
+    current_byte = static_cast<std::size_t>(itr->input_offset);
+    current_frame = itr->frame;
+    LOG_INFO(Movie, "Continuing from the keyframe at frame {}", current_frame);
+
+    seek_target = frame;
+    seek_completion_callback = std::move(completion_callback);
+    if (current_frame < frame) {
+        Core::System::GetInstance().frame_limiter.SetFastForwarding(true);
+    } else {
+        FinishSeek();
+    }
+}
+
+void Movie::FinishSeek() {
+    seek_target.reset();
+    if (IsRecordingInput()) {
+        // Rerecording from here, the input and keyframes after this point are replaced
+        recorded_input.resize(current_byte);
+        DropKeyframesAhead();
+    }
+
+    auto& frame_limiter = Core::System::GetInstance().frame_limiter;
+    frame_limiter.SetFastForwarding(false);
+    frame_limiter.SetFrameAdvancing(true);
+    LOG_INFO(Movie, "Paused at frame {}", current_frame);
+    if (const auto callback = std::exchange(seek_completion_callback, nullptr)) {
+        callback();
+    }
 }
 
 template <typename... Targs>
 void Movie::Handle(Targs&... Fargs) {
+    if (IsRecordingInput() && seek_target) {
+        // The input recorded after the keyframe is played up to the frame sought to
+        if (current_byte + sizeof(ControllerState) <= recorded_input.size()) {
+            Play(Fargs...);
+            return;
+        }
+        FinishSeek();
+    }
+
     if (IsPlayingInput()) {
         ASSERT(current_byte + sizeof(ControllerState) <= recorded_input.size());
         Play(Fargs...);
@@ -511,6 +844,10 @@ void Movie::Handle(Targs&... Fargs) {
 
 void Movie::HandlePadAndCircleStatus(Service::HID::PadState& pad_state, s16& circle_pad_x,
                                      s16& circle_pad_y) {
+    // The pad state is the first input of a frame
+    if (seek_target && current_frame >= *seek_target) {
+        FinishSeek();
+    }
     Handle(pad_state, circle_pad_x, circle_pad_y);
 }
 
@@ -4,10 +4,19 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
 
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Service {
 namespace HID {
 struct AccelerometerDataEntry;
@@ -42,9 +51,26 @@ public:
         return s_instance;
     }
 
+    /**
+     * Default number of frames between the savestate keyframes of a recording, a minute of
+     * emulated time. A frame is an update of the HID pad state, which happens 234 times a second.
+     */
+    static constexpr u32 DefaultKeyframeInterval = 234 * 60;
+
+    /// Saves the emulated system into a keyframe
+    using SaveStateHandler = std::function<std::vector<u8>()>;
+    /// Restores the emulated system from a keyframe
+    using LoadStateHandler = std::function<void(const std::vector<u8>&)>;
+
     void StartPlayback(
         const std::string& movie_file, std::function<void()> completion_callback = [] {});
-    void StartRecording(const std::string& movie_file);
+
+    /**
+     * Starts recording input. A savestate keyframe is embedded in the movie when recording starts
+     * and then every keyframe_interval frames, to allow seeking. 0 disables keyframes.
+     */
+    void StartRecording(const std::string& movie_file,
+                        u32 keyframe_interval = DefaultKeyframeInterval);
 
     /// Prepare to override the clock before playing back movies
     void PrepareForPlayback(const std::string& movie_file);
@@ -99,11 +125,59 @@ public:
     bool IsPlayingInput() const;
     bool IsRecordingInput() const;
 
+    /// Returns the number of frames played or recorded so far
+    u64 GetCurrentFrame() const;
+
+    /// Returns the number of frames of the movie being played, or recorded so far
+    u64 GetFrameCount() const;
+
+    /**
+     * Continues playing or recording from a frame. The emulation thread loads the last keyframe at
+     * or before it before its next slice, then plays the movie without frame limiting up to the
+     * frame, where it enables frame advancing and calls the callback. When recording, the input
+     * and keyframes after the frame are discarded.
+     */
+    void SeekToFrame(u64 frame, std::function<void()> completion_callback = [] {});
+
+    /**
+     * Takes and loads the keyframes requested since the last call. Like other savestates, these
+     * can only be handled between slices, so this is called by the emulation thread.
+     * @throws std::runtime_error if a keyframe could not be loaded.
+     */
+    void HandleKeyframeRequests();
+
+    /**
+     * Replaces how keyframes save and restore the emulated system. By default, the running system
+     * is saved, and nothing is saved when no system is running.
+     */
+    void SetKeyframeStateHandlers(SaveStateHandler save_state, LoadStateHandler load_state);
+
 private:
     static Movie s_instance;
 
+    /// Savestate embedded in a movie, from which playback or recording can continue
+    struct Keyframe {
+        u64 frame;             ///< Number of frames played or recorded before the savestate
+        u64 input_offset;      ///< Offset of the next input record in recorded_input
+        std::vector<u8> state; ///< Compressed savestate. Read from the file on use when playing
+        u64 file_offset;       ///< Offset of the savestate in the file of the movie played
+        u64 state_size;
+    };
+
     void CheckInputEnd();
 
+    void CaptureKeyframe();
+    void LoadKeyframe(u64 frame, std::function<void()> completion_callback);
+
+    /// Pauses emulation at the frame sought to, from which recording continues
+    void FinishSeek();
+
+    /// Drops the keyframes that are ahead of the input, as it will be recorded again
+    void DropKeyframesAhead();
+
+    /// Updates the frame counter and drops the keyframes that are ahead after loading a savestate
+    void UpdateAfterStateLoad();
+
     template <typename... Targs>
     void Handle(Targs&... Fargs);
 
@@ -126,22 +200,48 @@ private:
     ValidationResult ValidateHeader(const CTMHeader& header, u64 program_id = 0) const;
 
     void SaveMovie();
+    bool LoadMovie(FileUtil::IOFile& file, const CTMHeader& header);
 
     PlayMode play_mode;
     std::string record_movie_file;
+    std::string playback_movie_file;
     std::vector<u8> recorded_input;
     u64 init_time;
     std::function<void()> playback_completion_callback;
     std::size_t current_byte = 0;
 
+    u64 current_frame = 0;
+    u64 frame_count = 0; ///< Frames in the movie played
+    u32 keyframe_interval = 0;
+    std::vector<Keyframe> keyframes;
+    bool keyframe_requested = false;
+    /// Set while a keyframe is saved or loaded, to leave the movie itself out of the savestate
+    bool serializing_keyframe = false;
+
+    SaveStateHandler save_state_handler;
+    LoadStateHandler load_state_handler;
+
+    std::mutex seek_mutex;
+    std::optional<u64> seek_frame;
+    std::function<void()> requested_seek_callback;
+    std::atomic_bool seek_requested = false;
+    /// Frame the movie is played up to after loading a keyframe, while seeking
+    std::optional<u64> seek_target;
+    std::function<void()> seek_completion_callback;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         // Only serialize what's needed to make savestates useful for TAS:
         u64 _current_byte = static_cast<u64>(current_byte);
         ar& _current_byte;
         current_byte = static_cast<std::size_t>(_current_byte);
-        ar& recorded_input;
+        if (!serializing_keyframe) {
+            ar& recorded_input;
+        }
         ar& init_time;
+        if (Archive::is_loading::value && !serializing_keyframe) {
+            UpdateAfterStateLoad();
+        }
     }
     friend class boost::serialization::access;
 };
@@ -127,6 +127,14 @@ void FrameLimiter::WaitOnce() {
 }
 
 void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
+    if (fast_forwarding) {
+        // Limiting starts over once fast forwarding ends, instead of waiting for the time skipped
+        previous_system_time_us = current_system_time_us;
+        previous_walltime = Clock::now();
+        frame_limiting_delta_err = microseconds::zero();
+        return;
+    }
+
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
         frame_advance_event.Wait();
@@ -181,4 +189,8 @@ void FrameLimiter::AdvanceFrame() {
     frame_advance_event.Set();
 }
 
+void FrameLimiter::SetFastForwarding(bool value) {
+    fast_forwarding = value;
+}
+
 } // namespace Core
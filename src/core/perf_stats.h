@@ -99,6 +99,9 @@ public:
     void AdvanceFrame();
     void WaitOnce();
 
+    /// Sets whether frames are run as fast as possible, ahead of frame advancing. Thread-safe.
+    void SetFastForwarding(bool value);
+
 private:
     /// Emulated system time (in microseconds) at the last limiter invocation
     std::chrono::microseconds previous_system_time_us{0};
@@ -113,6 +116,9 @@ private:
 
     /// Event to advance the frame when frame advancing is enabled
     Common::Event frame_advance_event;
+
+    /// Whether to skip frame limiting and frame advancing, such as while seeking in a movie
+    std::atomic_bool fast_forwarding = false;
 };
 
 } // namespace Core
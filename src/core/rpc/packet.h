@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <array>
 #include <functional>
+#include <vector>
 #include "common/common_types.h"
 
 namespace RPC {
@@ -14,6 +14,14 @@ enum class PacketType {
     Undefined = 0,
     ReadMemory,
     WriteMemory,
+    /// Reads a list of address/size pairs at the next frame boundary, replying with their data
+    ReadMemoryBatch,
+    /// Writes a list of address/size/data entries at the next frame boundary
+    WriteMemoryBatch,
+    /// Like ReadMemoryBatch, but replies again at every frame until unsubscribed
+    SubscribeMemory,
+    /// Stops the subscription whose request id is given as the only u32 of the data
+    UnsubscribeMemory,
 };
 
 struct PacketHeader {
@@ -23,10 +31,11 @@ struct PacketHeader {
     u32 packet_size;
 };
 
-constexpr u32 CURRENT_VERSION = 1;
+constexpr u32 CURRENT_VERSION = 2;
 constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
-constexpr u32 MAX_PACKET_DATA_SIZE = 32;
-constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
+/// Largest payload of a UDP datagram over IPv4
+constexpr u32 MAX_PACKET_SIZE = 65507;
+constexpr u32 MAX_PACKET_DATA_SIZE = MAX_PACKET_SIZE - MIN_PACKET_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
 
 class Packet {
@@ -53,12 +62,13 @@ public:
         return header;
     }
 
-    std::array<u8, MAX_PACKET_DATA_SIZE>& GetPacketData() {
+    std::vector<u8>& GetPacketData() {
         return packet_data;
     }
 
     void SetPacketDataSize(u32 size) {
         header.packet_size = size;
+        packet_data.resize(size);
     }
 
     void SendReply() {
@@ -70,7 +80,7 @@ private:
     void HandleWriteMemory(u32 address, const u8* data, u32 data_size);
 
     struct PacketHeader header;
-    std::array<u8, MAX_PACKET_DATA_SIZE> packet_data;
+    std::vector<u8> packet_data;
 
     std::function<void(Packet&)> send_reply_callback;
 };
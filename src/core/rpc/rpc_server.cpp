@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cstring>
+#include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
@@ -8,6 +11,9 @@
 
 namespace RPC {
 
+/// Maximum number of memory subscriptions replied to at every frame
+constexpr std::size_t MAX_SUBSCRIPTIONS = 32;
+
 RPCServer::RPCServer() : server(*this) {
     LOG_INFO(RPC_Server, "Starting RPC server ...");
 
@@ -24,24 +30,28 @@ RPCServer::~RPCServer() {
     LOG_INFO(RPC_Server, "RPC stopped.");
 }
 
+/// Only allow writing to certain memory regions
+static bool IsWritableAddress(u32 address) {
+    return (address >= Memory::PROCESS_IMAGE_VADDR && address <= Memory::PROCESS_IMAGE_VADDR_END) ||
+           (address >= Memory::HEAP_VADDR && address <= Memory::HEAP_VADDR_END) ||
+           (address >= Memory::N3DS_EXTRA_RAM_VADDR && address <= Memory::N3DS_EXTRA_RAM_VADDR_END);
+}
+
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
     if (data_size > MAX_READ_SIZE) {
         return;
     }
 
+    packet.SetPacketDataSize(data_size);
     // Note: Memory read occurs asynchronously from the state of the emulator
     Core::System::GetInstance().Memory().ReadBlock(
         *Core::System::GetInstance().Kernel().GetCurrentProcess(), address,
         packet.GetPacketData().data(), data_size);
-    packet.SetPacketDataSize(data_size);
     packet.SendReply();
 }
 
 void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size) {
-    // Only allow writing to certain memory regions
-    if ((address >= Memory::PROCESS_IMAGE_VADDR && address <= Memory::PROCESS_IMAGE_VADDR_END) ||
-        (address >= Memory::HEAP_VADDR && address <= Memory::HEAP_VADDR_END) ||
-        (address >= Memory::N3DS_EXTRA_RAM_VADDR && address <= Memory::N3DS_EXTRA_RAM_VADDR_END)) {
+    if (IsWritableAddress(address)) {
         // Note: Memory write occurs asynchronously from the state of the emulator
         Core::System::GetInstance().Memory().WriteBlock(
             *Core::System::GetInstance().Kernel().GetCurrentProcess(), address, data, data_size);
@@ -54,15 +64,55 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u
     packet.SendReply();
 }
 
+void RPCServer::HandleReadMemoryBatch(Packet& packet, const std::vector<MemoryRange>& ranges) {
+    u32 reply_size = 0;
+    for (const MemoryRange& range : ranges) {
+        reply_size += range.size;
+    }
+    packet.SetPacketDataSize(reply_size);
+
+    Core::System& system = Core::System::GetInstance();
+    const Kernel::Process& process = *system.Kernel().GetCurrentProcess();
+    u8* data = packet.GetPacketData().data();
+    for (const MemoryRange& range : ranges) {
+        system.Memory().ReadBlock(process, range.address, data, range.size);
+        data += range.size;
+    }
+    packet.SendReply();
+}
+
+void RPCServer::HandleWriteMemoryBatch(Packet& packet, const std::vector<MemoryRange>& ranges) {
+    Core::System& system = Core::System::GetInstance();
+    const Kernel::Process& process = *system.Kernel().GetCurrentProcess();
+    for (const MemoryRange& range : ranges) {
+        if (!IsWritableAddress(range.address)) {
+            continue;
+        }
+        system.Memory().WriteBlock(process, range.address,
+                                   packet.GetPacketData().data() + range.data_offset, range.size);
+        system.InvalidateCacheRange(range.address, range.size);
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
         case PacketType::ReadMemory:
         case PacketType::WriteMemory:
+        case PacketType::ReadMemoryBatch:
+        case PacketType::WriteMemoryBatch:
+        case PacketType::SubscribeMemory:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
             break;
+        case PacketType::UnsubscribeMemory:
+            if (packet_header.packet_size == sizeof(u32)) {
+                return true;
+            }
+            break;
         default:
             break;
         }
@@ -70,31 +120,87 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     return false;
 }
 
+bool RPCServer::ParseMemoryRanges(Packet& packet, std::vector<MemoryRange>& ranges) {
+    const u8* const data = packet.GetPacketData().data();
+    const u32 data_size = packet.GetPacketDataSize();
+    const bool has_write_data = packet.GetPacketType() == PacketType::WriteMemoryBatch;
+
+    u64 read_size = 0;
+    u32 offset = 0;
+    while (offset < data_size) {
+        MemoryRange range;
+        if (data_size - offset < sizeof(u32) * 2) {
+            return false;
+        }
+        std::memcpy(&range.address, data + offset, sizeof(u32));
+        std::memcpy(&range.size, data + offset + sizeof(u32), sizeof(u32));
+        offset += sizeof(u32) * 2;
+        range.data_offset = offset;
+
+        if (range.size == 0) {
+            return false;
+        }
+        if (has_write_data) {
+            if (range.size > data_size - offset) {
+                return false;
+            }
+            offset += range.size;
+        } else {
+            read_size += range.size;
+            if (read_size > MAX_READ_SIZE) {
+                return false;
+            }
+        }
+        ranges.push_back(range);
+    }
+    return true;
+}
+
+/// Reads the address and data_size fields of single reads and writes
+static void ReadAddressAndSize(Packet& packet, u32& address, u32& data_size) {
+    std::memcpy(&address, packet.GetPacketData().data(), sizeof(address));
+    std::memcpy(&data_size, packet.GetPacketData().data() + sizeof(address), sizeof(data_size));
+}
+
 void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
     bool success = false;
 
     if (ValidatePacket(request_packet->GetHeader())) {
-        // Currently, all request types use the address/data_size wire format
         u32 address = 0;
         u32 data_size = 0;
-        std::memcpy(&address, request_packet->GetPacketData().data(), sizeof(address));
-        std::memcpy(&data_size, request_packet->GetPacketData().data() + sizeof(address),
-                    sizeof(data_size));
 
         switch (request_packet->GetPacketType()) {
         case PacketType::ReadMemory:
+            ReadAddressAndSize(*request_packet, address, data_size);
             if (data_size > 0 && data_size <= MAX_READ_SIZE) {
                 HandleReadMemory(*request_packet, address, data_size);
                 success = true;
             }
             break;
         case PacketType::WriteMemory:
-            if (data_size > 0 && data_size <= MAX_PACKET_DATA_SIZE - (sizeof(u32) * 2)) {
+            ReadAddressAndSize(*request_packet, address, data_size);
+            if (data_size > 0 &&
+                data_size <= request_packet->GetPacketDataSize() - (sizeof(u32) * 2)) {
                 const u8* data = request_packet->GetPacketData().data() + (sizeof(u32) * 2);
                 HandleWriteMemory(*request_packet, address, data, data_size);
                 success = true;
             }
             break;
+        case PacketType::ReadMemoryBatch:
+        case PacketType::WriteMemoryBatch:
+        case PacketType::SubscribeMemory: {
+            std::vector<MemoryRange> ranges;
+            if (ParseMemoryRanges(*request_packet, ranges)) {
+                QueueFrameRequest({std::move(request_packet), std::move(ranges)});
+                return;
+            }
+            break;
+        }
+        case PacketType::UnsubscribeMemory: {
+            // The packet only holds the subscription id
+            QueueFrameRequest({std::move(request_packet), {}});
+            return;
+        }
         default:
             break;
         }
@@ -107,6 +213,88 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
     }
 }
 
+void RPCServer::QueueFrameRequest(FrameRequest request) {
+    {
+        std::lock_guard lock{frame_requests_mutex};
+        frame_requests.push_back(std::move(request));
+    }
+
+    // Replied to by HandleFrameRequests, unless no frame is coming
+    if (!emulation_running) {
+        std::lock_guard lock{handling_mutex};
+        HandleQueuedRequests();
+    }
+}
+
+void RPCServer::HandleFrameRequests() {
+    std::lock_guard lock{handling_mutex};
+    HandleQueuedRequests();
+
+    for (FrameRequest& subscription : subscriptions) {
+        HandleReadMemoryBatch(*subscription.packet, subscription.ranges);
+    }
+}
+
+void RPCServer::SetEmulationRunning(bool running) {
+    const bool was_running = emulation_running.exchange(running);
+    if (running || !was_running) {
+        return;
+    }
+
+    // Answer the requests that were waiting for a frame when the emulation stopped
+    std::lock_guard lock{handling_mutex};
+    HandleQueuedRequests();
+}
+
+void RPCServer::HandleQueuedRequests() {
+    std::vector<FrameRequest> requests;
+    {
+        std::lock_guard lock{frame_requests_mutex};
+        requests.swap(frame_requests);
+    }
+
+    for (FrameRequest& request : requests) {
+        Packet& packet = *request.packet;
+        switch (packet.GetPacketType()) {
+        case PacketType::ReadMemoryBatch:
+            HandleReadMemoryBatch(packet, request.ranges);
+            break;
+        case PacketType::WriteMemoryBatch:
+            HandleWriteMemoryBatch(packet, request.ranges);
+            break;
+        case PacketType::SubscribeMemory:
+            if (subscriptions.size() < MAX_SUBSCRIPTIONS) {
+                // Replied to at every frame. While paused, the first reply is sent right away.
+                if (!emulation_running) {
+                    HandleReadMemoryBatch(packet, request.ranges);
+                }
+                subscriptions.push_back(std::move(request));
+            } else {
+                LOG_WARNING(RPC_Server, "Too many memory subscriptions, ignoring id={}",
+                            packet.GetId());
+                packet.SetPacketDataSize(0);
+                packet.SendReply();
+            }
+            break;
+        case PacketType::UnsubscribeMemory: {
+            u32 subscription_id;
+            std::memcpy(&subscription_id, packet.GetPacketData().data(), sizeof(subscription_id));
+            const auto is_unsubscribed = [subscription_id](const FrameRequest& subscription) {
+                return subscription.packet->GetId() == subscription_id;
+            };
+            subscriptions.erase(
+                std::remove_if(subscriptions.begin(), subscriptions.end(), is_unsubscribed),
+                subscriptions.end());
+            packet.SetPacketDataSize(0);
+            packet.SendReply();
+            break;
+        }
+        default:
+            UNREACHABLE();
+        }
+    }
+}
+
 void RPCServer::HandleRequestsLoop() {
     std::unique_ptr<RPC::Packet> request_packet;
 
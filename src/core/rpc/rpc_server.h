@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
+#include "common/common_types.h"
 #include "common/threadsafe_queue.h"
 #include "core/rpc/server.h"
 
@@ -23,18 +26,57 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /**
+     * Runs the batched requests received since the last frame and replies to the memory
+     * subscriptions. Called by the emulation thread between two frames, so that the memory each
+     * request sees or changes is consistent.
+     */
+    void HandleFrameRequests();
+
+    /**
+     * Tells whether the emulation thread is running frames. While it is not, the requests that
+     * wait for a frame boundary are answered as soon as they are received.
+     */
+    void SetEmulationRunning(bool running);
+
 private:
+    /// A range of a batched request. For writes, data_offset locates its data in the packet.
+    struct MemoryRange {
+        u32 address;
+        u32 size;
+        u32 data_offset;
+    };
+
+    /// A request that waits for the next frame boundary to be handled
+    struct FrameRequest {
+        std::unique_ptr<Packet> packet;
+        std::vector<MemoryRange> ranges;
+    };
+
     void Start();
     void Stop();
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size);
+    void HandleReadMemoryBatch(Packet& packet, const std::vector<MemoryRange>& ranges);
+    void HandleWriteMemoryBatch(Packet& packet, const std::vector<MemoryRange>& ranges);
     bool ValidatePacket(const PacketHeader& packet_header);
+    bool ParseMemoryRanges(Packet& packet, std::vector<MemoryRange>& ranges);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
+    void QueueFrameRequest(FrameRequest request);
+    void HandleQueuedRequests();
     void HandleRequestsLoop();
 
     Server server;
     Common::SPSCQueue<std::unique_ptr<Packet>> request_queue;
     std::thread request_handler_thread;
+
+    std::atomic<bool> emulation_running{true};
+
+    std::mutex frame_requests_mutex;
+    std::vector<FrameRequest> frame_requests;
+    /// Held while handling the queued requests and the subscriptions
+    std::mutex handling_mutex;
+    std::vector<FrameRequest> subscriptions;
 };
 
 } // namespace RPC
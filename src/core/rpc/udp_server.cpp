@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <thread>
 #include <boost/asio.hpp>
 #include "common/common_types.h"
@@ -72,9 +73,9 @@ private:
         if (error) {
             LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
         } else {
-            LOG_INFO(RPC_Server, "Sent reply version({}) id=({}) type=({}) size=({})",
-                     reply_packet.GetVersion(), reply_packet.GetId(), reply_packet.GetPacketType(),
-                     reply_packet.GetPacketDataSize());
+            LOG_DEBUG(RPC_Server, "Sent reply version({}) id=({}) type=({}) size=({})",
+                      reply_packet.GetVersion(), reply_packet.GetId(), reply_packet.GetPacketType(),
+                      reply_packet.GetPacketDataSize());
         }
     }
 
@@ -36,6 +36,13 @@ static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
 
+/// Loading a state would desync the other players of a multiplayer room
+static void CheckNotInMultiplayer() {
+    if (Network::GetRoomMember().lock()->IsConnected()) {
+        throw std::runtime_error("Unable to load while connected to multiplayer");
+    }
+}
+
 std::string GetSaveStatePath(u64 program_id, u32 slot) {
     return fmt::format("{}{:016X}.{:02d}.cst", FileUtil::GetUserPath(FileUtil::UserPath::StatesDir),
                        program_id, slot);
@@ -88,15 +95,33 @@ std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
     return result;
 }
 
-void System::SaveState(u32 slot) const {
+std::vector<u8> System::SaveStateToBuffer() const {
     std::ostringstream sstream{std::ios_base::binary};
     // Serialize
     oarchive oa{sstream};
     oa&* this;
 
     const std::string& str{sstream.str()};
-    auto buffer = Common::Compression::CompressDataZSTDDefault(
-        reinterpret_cast<const u8*>(str.data()), str.size());
+    return Common::Compression::CompressDataZSTDDefault(reinterpret_cast<const u8*>(str.data()),
+                                                        str.size());
+}
+
+void System::LoadStateFromBuffer(const std::vector<u8>& buffer) {
+    CheckNotInMultiplayer();
+
+    std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(buffer);
+    std::istringstream sstream{
+        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
+        std::ios_base::binary};
+    decompressed.clear();
+
+    // Deserialize
+    iarchive ia{sstream};
+    ia&* this;
+}
+
+void System::SaveState(u32 slot) const {
+    const auto buffer = SaveStateToBuffer();
 
     const auto path = GetSaveStatePath(title_id, slot);
     if (!FileUtil::CreateFullPath(path)) {
@@ -126,31 +151,19 @@ void System::SaveState(u32 slot) const {
 }
 
 void System::LoadState(u32 slot) {
-    if (Network::GetRoomMember().lock()->IsConnected()) {
-        throw std::runtime_error("Unable to load while connected to multiplayer");
-    }
+    CheckNotInMultiplayer();
 
     const auto path = GetSaveStatePath(title_id, slot);
 
-    std::vector<u8> decompressed;
+    std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
     {
-        std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
-
         FileUtil::IOFile file(path, "rb");
         file.Seek(sizeof(CSTHeader), SEEK_SET); // Skip header
         if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
             throw std::runtime_error("Could not read from file at " + path);
         }
-        decompressed = Common::Compression::DecompressDataZSTD(buffer);
     }
-    std::istringstream sstream{
-        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
-        std::ios_base::binary};
-    decompressed.clear();
-
-    // Deserialize
-    iarchive ia{sstream};
-    ia&* this;
+    LoadStateFromBuffer(buffer);
 }
 
 } // namespace Core
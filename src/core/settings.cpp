@@ -78,6 +78,7 @@ void LogSettings() {
     LOG_INFO(Config, "Citra Configuration:");
     log_setting("Core_UseCpuJit", values.use_cpu_jit);
     log_setting("Core_CPUClockPercentage", values.cpu_clock_percentage);
+    log_setting("Renderer_GraphicsAPI", static_cast<int>(values.graphics_api));
     log_setting("Renderer_UseGLES", values.use_gles);
     log_setting("Renderer_UseHwRenderer", values.use_hw_renderer);
     log_setting("Renderer_UseHwShader", values.use_hw_shader);
@@ -89,6 +90,7 @@ void LogSettings() {
     log_setting("Renderer_UseFrameLimitAlternate", values.use_frame_limit_alternate);
     log_setting("Renderer_FrameLimitAlternate", values.frame_limit_alternate);
     log_setting("Renderer_VSyncNew", values.use_vsync_new);
+    log_setting("Renderer_AsyncShaderCompilation", values.async_shader_compilation);
     log_setting("Renderer_PostProcessingShader", values.pp_shader_name);
     log_setting("Renderer_FilterMode", values.filter_mode);
     log_setting("Renderer_TextureFilterName", values.texture_filter_name);
@@ -118,8 +120,10 @@ void LogSettings() {
     log_setting("Camera_OuterLeftConfig", values.camera_config[OuterLeftCamera]);
     log_setting("Camera_OuterLeftFlip", values.camera_flip[OuterLeftCamera]);
     log_setting("DataStorage_UseVirtualSd", values.use_virtual_sd);
+    log_setting("DataStorage_AsyncFsIo", values.async_fs_io);
     log_setting("System_IsNew3ds", values.is_new_3ds);
     log_setting("System_RegionValue", values.region_value);
+    log_setting("Debugging_LogServiceStats", values.log_service_stats);
     log_setting("Debugging_UseGdbstub", values.use_gdbstub);
     log_setting("Debugging_GdbstubPort", values.gdbstub_port);
 }
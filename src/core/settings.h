@@ -34,6 +34,11 @@ enum class MicInputType {
 
 enum class StereoRenderOption { Off, SideBySide, Anaglyph, Interlaced, ReverseInterlaced };
 
+enum class GraphicsAPI {
+    OpenGL = 0,
+    Null = 1, ///< Presents nothing, for headless runs that only need guest-visible state
+};
+
 namespace NativeButton {
 enum Values {
     A,
@@ -140,6 +145,7 @@ struct Values {
 
     // Data Storage
     bool use_virtual_sd;
+    bool async_fs_io;
 
     // System
     int region_value;
@@ -147,11 +153,13 @@ struct Values {
     u64 init_time;
 
     // Renderer
+    GraphicsAPI graphics_api;
     bool use_gles;
     bool use_hw_renderer;
     bool use_hw_shader;
     bool separable_shader;
     bool use_disk_shader_cache;
+    bool async_shader_compilation;
     bool shaders_accurate_mul;
     bool use_shader_jit;
     u16 resolution_factor;
@@ -206,9 +214,11 @@ struct Values {
 
     // Debugging
     bool record_frame_times;
+    bool log_service_stats;
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string log_filter;
+    bool log_binary;
     std::unordered_map<std::string, bool> lle_modules;
 
     // WebService
@@ -224,6 +234,10 @@ struct Values {
     std::string video_encoder;
     std::string video_encoder_options;
     u64 video_bitrate;
+    u32 video_encoder_threads;    ///< 0 lets the encoder decide
+    u32 video_conversion_threads; ///< Threads converting frames to the encoder pixel format
+    u32 video_frame_queue_size;   ///< Frames that can wait to be converted or encoded
+    bool drop_video_frames;       ///< Drop frames when the queue is full instead of waiting
 
     std::string audio_encoder;
     std::string audio_encoder_options;
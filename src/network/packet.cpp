@@ -25,6 +25,10 @@ u64 ntohll(u64 x) {
 }
 #endif
 
+Packet::Packet(std::vector<char> buffer) : data(std::move(buffer)) {
+    data.clear();
+}
+
 void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
     if (in_data && (size_in_bytes > 0)) {
         std::size_t start = data.size();
@@ -46,6 +50,16 @@ void Packet::Clear() {
     is_valid = true;
 }
 
+void Packet::Reserve(std::size_t size_in_bytes) {
+    data.reserve(size_in_bytes);
+}
+
+std::vector<char> Packet::TakeData() {
+    std::vector<char> taken_data = std::move(data);
+    Clear();
+    return taken_data;
+}
+
 const void* Packet::GetData() const {
     return !data.empty() ? &data[0] : nullptr;
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
@@ -16,6 +17,12 @@ public:
     Packet() = default;
     ~Packet() = default;
 
+    /**
+     * Creates an empty packet that writes into the given buffer, reusing its capacity
+     * @param buffer The buffer, whose contents are discarded
+     */
+    explicit Packet(std::vector<char> buffer);
+
     /**
      * Append data to the end of the packet
      * @param data        Pointer to the sequence of bytes to append
@@ -36,6 +43,19 @@ public:
      */
     void Clear();
 
+    /**
+     * Reserves memory for the given total size, to avoid reallocations while writing
+     * @param size_in_bytes Expected size of the packet
+     */
+    void Reserve(std::size_t size_in_bytes);
+
+    /**
+     * Moves the data out of the packet, to hand it over without copying it.
+     * After calling TakeData, the packet is empty.
+     * @return The data of the packet
+     */
+    std::vector<char> TakeData();
+
     /**
      * Ignores bytes while reading
      * @param length THe number of bytes to ignore
@@ -103,6 +123,11 @@ public:
     Packet& operator<<(const std::array<T, S>& data);
 
 private:
+    /// Whether arrays of T are serialized as is, as they need no endianness conversion
+    template <typename T>
+    static constexpr bool IsByteType =
+        std::is_same_v<T, u8> || std::is_same_v<T, s8> || std::is_same_v<T, char>;
+
     /**
      * Check if the packet can extract a given number of bytes
      * This function updates accordingly the state of the packet.
@@ -122,9 +147,18 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
-    out_data.resize(size);
+
+    if constexpr (IsByteType<T>) {
+        out_data.clear();
+        if (size > 0 && CheckSize(size)) {
+            out_data.resize(size);
+            Read(out_data.data(), size);
+        }
+        return *this;
+    }
 
     // Then extract the data
+    out_data.resize(size);
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -135,6 +169,11 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator>>(std::array<T, S>& out_data) {
+    if constexpr (IsByteType<T>) {
+        Read(out_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -149,6 +188,11 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
     *this << static_cast<u32>(in_data.size());
 
     // Then insert the data
+    if constexpr (IsByteType<T>) {
+        Append(in_data.data(), in_data.size());
+        return *this;
+    }
+
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
@@ -157,6 +201,11 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator<<(const std::array<T, S>& in_data) {
+    if constexpr (IsByteType<T>) {
+        Append(in_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
@@ -4,13 +4,16 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iomanip>
+#include <map>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
 #include "common/logging/log.h"
+#include "common/threadsafe_queue.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
@@ -48,6 +51,24 @@ public:
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
+    /// Peers of the members, to forward wifi packets without locking member_mutex. Like the
+    /// members list, these are only modified by the room thread, and they are only read by it.
+    std::vector<ENetPeer*> member_peers;
+    std::map<MacAddress, ENetPeer*> member_peers_by_mac;
+
+    /// A join request waiting for the verification backend
+    struct PendingJoin {
+        ENetPeer* peer;
+        u32 connect_id; ///< Tells the connection apart from later ones that reuse the peer
+        Member member;  ///< The requested MAC address may be NoPreferredMac
+        std::string verify_UID;
+        std::string token;
+    };
+    /// Join requests sent to the verification thread. nullptr stops the thread.
+    Common::SPSCQueue<std::unique_ptr<PendingJoin>> pending_joins;
+    /// Verified join requests, to be finished by the room thread
+    Common::SPSCQueue<std::unique_ptr<PendingJoin>> verified_joins;
+
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
     mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
@@ -58,6 +79,9 @@ public:
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> room_thread;
 
+    /// Thread that verifies joining users, which may query a web service
+    std::unique_ptr<std::thread> verify_thread;
+
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
@@ -65,13 +89,33 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /// Thread function that will verify the users of join requests until the room is destroyed.
+    void VerifyUserLoop();
+
     /**
-     * Parses and answers a room join request from a client.
-     * Validates the uniqueness of the username and assigns the MAC address
-     * that the client will use for the remainder of the connection.
+     * Parses a room join request from a client.
+     * Rejects the request right away if it is invalid, or else sends it to the verification
+     * thread.
      */
     void HandleJoinRequest(const ENetEvent* event);
 
+    /**
+     * Answers the join requests whose user has been verified.
+     * Validates the uniqueness of the username again and assigns the MAC address that the client
+     * will use for the remainder of the connection.
+     */
+    void FinishJoinRequests();
+    void FinishJoinRequest(PendingJoin& join);
+
+    /**
+     * Returns whether a join request may be accepted given the current members, answering the
+     * client if not.
+     */
+    bool ValidateJoinRequest(const PendingJoin& join);
+
+    /// Updates member_peers and member_peers_by_mac after members was modified.
+    void UpdateMemberPeers();
+
     /**
      * Parses and answers a kick request from a client.
      * Validates the permissions and that the given user exists and then kicks the member.
@@ -223,7 +267,9 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Forwards this packet to its destination member, or to all members except the sender.
+     * The received ENet packet itself is sent, so it must not be destroyed by the caller if it
+     * is still referenced after this.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
@@ -250,6 +296,8 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
+        FinishJoinRequests();
+
         ENetEvent event;
         if (enet_host_service(server, &event, 50) > 0) {
             switch (event.type) {
@@ -281,7 +329,10 @@ void Room::RoomImpl::ServerLoop() {
                     HandleModGetBanListPacket(&event);
                     break;
                 }
-                enet_packet_destroy(event.packet);
+                // Forwarded packets are destroyed by ENet once they have been sent
+                if (event.packet->referenceCount == 0) {
+                    enet_packet_destroy(event.packet);
+                }
                 break;
             case ENET_EVENT_TYPE_DISCONNECT:
                 HandleClientDisconnection(event.peer);
@@ -298,27 +349,29 @@ void Room::RoomImpl::ServerLoop() {
 
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
+    verify_thread = std::make_unique<std::thread>(&Room::RoomImpl::VerifyUserLoop, this);
 }
 
-void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
-    {
-        std::lock_guard lock(member_mutex);
-        if (members.size() >= room_information.member_slots) {
-            SendRoomIsFull(event->peer);
-            return;
-        }
+void Room::RoomImpl::VerifyUserLoop() {
+    while (std::unique_ptr<PendingJoin> join = pending_joins.PopWait()) {
+        join->member.user_data = verify_backend->LoadUserData(join->verify_UID, join->token);
+        verified_joins.Push(std::move(join));
     }
+}
+
+void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     Packet packet;
     packet.Append(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
-    std::string nickname;
-    packet >> nickname;
 
-    std::string console_id_hash;
-    packet >> console_id_hash;
+    auto join = std::make_unique<PendingJoin>();
+    join->peer = event->peer;
+    join->connect_id = event->peer->connectID;
+    join->member.peer = event->peer;
 
-    MacAddress preferred_mac;
-    packet >> preferred_mac;
+    packet >> join->member.nickname;
+    packet >> join->member.console_id_hash;
+    packet >> join->member.mac_address;
 
     u32 client_version;
     packet >> client_version;
@@ -326,53 +379,56 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     std::string pass;
     packet >> pass;
 
-    std::string token;
-    packet >> token;
+    packet >> join->token;
 
     if (pass != password) {
         SendWrongPassword(event->peer);
         return;
     }
 
-    if (!IsValidNickname(nickname)) {
-        SendNameCollision(event->peer);
+    if (!ValidateJoinRequest(*join)) {
         return;
     }
 
-    if (preferred_mac != NoPreferredMac) {
-        // Verify if the preferred mac is available
-        if (!IsValidMacAddress(preferred_mac)) {
-            SendMacCollision(event->peer);
-            return;
-        }
-    } else {
-        // Assign a MAC address of this client automatically
-        preferred_mac = GenerateMacAddress();
+    if (client_version != network_version) {
+        SendVersionMismatch(event->peer);
+        return;
+    }
+
+    {
+        std::lock_guard lock(verify_UID_mutex);
+        join->verify_UID = verify_UID;
     }
+    pending_joins.Push(std::move(join));
+}
+
+void Room::RoomImpl::FinishJoinRequests() {
+    std::unique_ptr<PendingJoin> join;
+    while (verified_joins.Pop(join)) {
+        FinishJoinRequest(*join);
+    }
+}
 
-    if (!IsValidConsoleId(console_id_hash)) {
-        SendConsoleIdCollision(event->peer);
+void Room::RoomImpl::FinishJoinRequest(PendingJoin& join) {
+    ENetPeer* const peer = join.peer;
+    if (peer->state != ENET_PEER_STATE_CONNECTED || peer->connectID != join.connect_id ||
+        std::find(member_peers.begin(), member_peers.end(), peer) != member_peers.end()) {
+        // The client disconnected or joined in the meantime
         return;
     }
 
-    if (client_version != network_version) {
-        SendVersionMismatch(event->peer);
+    // Other members may have joined while the user was being verified
+    if (!ValidateJoinRequest(join)) {
         return;
     }
 
     // At this point the client is ready to be added to the room.
-    Member member{};
-    member.mac_address = preferred_mac;
-    member.console_id_hash = console_id_hash;
-    member.nickname = nickname;
-    member.peer = event->peer;
-
-    std::string uid;
-    {
-        std::lock_guard lock(verify_UID_mutex);
-        uid = verify_UID;
+    Member& member = join.member;
+    if (member.mac_address == NoPreferredMac) {
+        // Assign a MAC address of this client automatically
+        member.mac_address = GenerateMacAddress();
     }
-    member.user_data = verify_backend->LoadUserData(uid, token);
+    const MacAddress mac_address = member.mac_address;
 
     std::string ip;
     {
@@ -383,17 +439,17 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
             std::find(username_ban_list.begin(), username_ban_list.end(),
                       member.user_data.username) != username_ban_list.end()) {
 
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
 
         // Check IP ban
         char ip_raw[256];
-        enet_address_get_host_ip(&event->peer->address, ip_raw, sizeof(ip_raw) - 1);
+        enet_address_get_host_ip(&peer->address, ip_raw, sizeof(ip_raw) - 1);
         ip = ip_raw;
 
         if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) != ip_ban_list.end()) {
-            SendUserBanned(event->peer);
+            SendUserBanned(peer);
             return;
         }
     }
@@ -405,13 +461,50 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         std::lock_guard lock(member_mutex);
         members.push_back(std::move(member));
     }
+    UpdateMemberPeers();
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
-    if (HasModPermission(event->peer)) {
-        SendJoinSuccessAsMod(event->peer, preferred_mac);
+    if (HasModPermission(peer)) {
+        SendJoinSuccessAsMod(peer, mac_address);
     } else {
-        SendJoinSuccess(event->peer, preferred_mac);
+        SendJoinSuccess(peer, mac_address);
+    }
+}
+
+bool Room::RoomImpl::ValidateJoinRequest(const PendingJoin& join) {
+    {
+        std::lock_guard lock(member_mutex);
+        if (members.size() >= room_information.member_slots) {
+            SendRoomIsFull(join.peer);
+            return false;
+        }
+    }
+
+    if (!IsValidNickname(join.member.nickname)) {
+        SendNameCollision(join.peer);
+        return false;
+    }
+
+    // Verify if the preferred mac is available
+    if (join.member.mac_address != NoPreferredMac && !IsValidMacAddress(join.member.mac_address)) {
+        SendMacCollision(join.peer);
+        return false;
+    }
+
+    if (!IsValidConsoleId(join.member.console_id_hash)) {
+        SendConsoleIdCollision(join.peer);
+        return false;
+    }
+    return true;
+}
+
+void Room::RoomImpl::UpdateMemberPeers() {
+    member_peers.clear();
+    member_peers_by_mac.clear();
+    for (const Member& member : members) {
+        member_peers.push_back(member.peer);
+        member_peers_by_mac.emplace(member.mac_address, member.peer);
     }
 }
 
@@ -451,6 +544,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
     }
+    UpdateMemberPeers();
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberKicked, nickname, username, ip);
@@ -494,6 +588,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         enet_peer_disconnect(target_member->peer, 0);
         members.erase(target_member);
     }
+    UpdateMemberPeers();
 
     {
         std::lock_guard lock(ban_list_mutex);
@@ -847,51 +942,41 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    // Message type, WifiPacket type, channel and transmitter address precede the destination
+    constexpr std::size_t DestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+    if (event->packet->dataLength < DestinationOffset + sizeof(MacAddress)) {
+        return;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
+    std::memcpy(destination_address.data(), event->packet->data + DestinationOffset,
+                sizeof(MacAddress));
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // Forward the received packet itself, ENet keeps it alive until every recipient was sent it.
+    // Unreliable and unsequenced packets are released as soon as the flush below sends them, so
+    // hold a reference until then: the server loop destroys the packet if nobody else holds it.
+    ENetPacket* enet_packet = event->packet;
+    ++enet_packet->referenceCount;
 
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+        for (ENetPeer* peer : member_peers) {
+            if (peer != event->peer) {
+                enet_peer_send(peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto itr = member_peers_by_mac.find(destination_address);
+        if (itr != member_peers_by_mac.end()) {
+            enet_peer_send(itr->second, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
     enet_host_flush(server);
+    --enet_packet->referenceCount;
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -996,6 +1081,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             members.erase(member);
         }
     }
+    UpdateMemberPeers();
 
     // Announce the change to all clients.
     enet_peer_disconnect(client, 0);
@@ -1094,6 +1180,10 @@ void Room::Destroy() {
     room_impl->state = State::Closed;
     room_impl->room_thread->join();
     room_impl->room_thread.reset();
+    room_impl->pending_joins.Push(nullptr);
+    room_impl->verify_thread->join();
+    room_impl->verify_thread.reset();
+    room_impl->verified_joins.Clear();
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1104,6 +1194,8 @@ void Room::Destroy() {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
     }
+    room_impl->member_peers.clear();
+    room_impl->member_peers_by_mac.clear();
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
 }
@@ -4,9 +4,11 @@
 
 #include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <vector>
 #include "common/assert.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -16,6 +18,64 @@ namespace Network {
 
 constexpr u32 ConnectionTimeoutMs = 5000;
 
+/// Maximum number of buffers kept by the PacketBufferPool
+constexpr std::size_t MaxPooledPacketBuffers = 64;
+
+namespace {
+
+/**
+ * Data buffers of sent packets, which ENet frees on the network thread once they have been sent.
+ * They are kept to build the next packets without allocating memory.
+ */
+class PacketBufferPool {
+public:
+    std::vector<char> Acquire() {
+        std::lock_guard lock(mutex);
+        if (buffers.empty()) {
+            return {};
+        }
+        std::vector<char> buffer = std::move(buffers.back());
+        buffers.pop_back();
+        return buffer;
+    }
+
+    void Release(std::vector<char> buffer) {
+        std::lock_guard lock(mutex);
+        if (buffers.size() < MaxPooledPacketBuffers) {
+            buffers.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::vector<char>> buffers;
+};
+
+PacketBufferPool& GetPacketBufferPool() {
+    static PacketBufferPool pool;
+    return pool;
+}
+
+void FreePacketBuffer(ENetPacket* enet_packet) {
+    std::unique_ptr<std::vector<char>> buffer{
+        static_cast<std::vector<char>*>(enet_packet->userData)};
+    GetPacketBufferPool().Release(std::move(*buffer));
+}
+
+/// Creates a reliable ENet packet that takes over the data of a packet instead of copying it
+ENetPacket* CreateENetPacket(Packet& packet) {
+    auto buffer = std::make_unique<std::vector<char>>(packet.TakeData());
+    ENetPacket* enet_packet = enet_packet_create(
+        buffer->data(), buffer->size(), ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (enet_packet != nullptr) {
+        enet_packet->userData = buffer.release();
+        enet_packet->freeCallback = FreePacketBuffer;
+    }
+    return enet_packet;
+}
+
+} // Anonymous namespace
+
 class RoomMember::RoomMemberImpl {
 public:
     ENetHost* client = nullptr; ///< ENet network interface.
@@ -253,10 +313,8 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
         }
         {
             std::lock_guard lock(send_list_mutex);
-            for (const auto& packet : send_list) {
-                ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                            ENET_PACKET_FLAG_RELIABLE);
-                enet_peer_send(server, 0, enetPacket);
+            for (auto& packet : send_list) {
+                enet_peer_send(server, 0, CreateENetPacket(packet));
             }
             enet_host_flush(client);
             send_list.clear();
@@ -583,7 +641,9 @@ bool RoomMember::IsConnected() const {
 }
 
 void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
-    Packet packet;
+    Packet packet{GetPacketBufferPool().Acquire()};
+    packet.Reserve(3 * sizeof(u8) + 2 * sizeof(MacAddress) + sizeof(u32) +
+                   wifi_packet.data.size());
     packet << static_cast<u8>(IdWifiPacket);
     packet << static_cast<u8>(wifi_packet.type);
     packet << wifi_packet.channel;
@@ -0,0 +1,87 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/logging/backend.h"
+#include "common/logging/deferred.h"
+#include "tests/common/temporary_directory.h"
+
+namespace Log {
+
+namespace {
+
+Entry MakeEntry(const char* filename, unsigned int line_num, std::string message) {
+    Entry entry;
+    entry.timestamp = std::chrono::microseconds{line_num * 1000};
+    entry.log_class = Class::Service_FS;
+    entry.log_level = Level::Debug;
+    entry.filename = filename;
+    entry.line_num = line_num;
+    entry.function = "Function";
+    entry.message = std::move(message);
+    return entry;
+}
+
+/// Writes a formatted message and a deferred one with the same contents
+void WriteMessages(BinaryFileBackend& backend, int value) {
+    backend.Write(MakeEntry("file.cpp", 1, "Formatted " + std::to_string(value)));
+
+    std::vector<u8> args(GetEncodedArgSize(value));
+    EncodeDeferredArg(args.data(), value);
+    const DeferredEntry deferred{
+        std::chrono::microseconds{2000}, Class::Service_FS, Level::Debug, "file.cpp", 2,
+        "Function", "Deferred {}", 1, args.data(), args.size(), {},
+    };
+    backend.WriteDeferred(deferred);
+}
+
+std::vector<Entry> DecodeMessages(const std::string& path) {
+    std::vector<Entry> entries;
+    REQUIRE(DecodeBinaryLog(path, [&entries](const Entry& entry) {
+        CHECK(std::string(entry.filename) == "file.cpp");
+        // The file name is only valid during the callback
+        Entry& copy = entries.emplace_back();
+        copy = entry;
+        copy.filename = nullptr;
+    }));
+    return entries;
+}
+
+void CheckMessages(const std::vector<Entry>& entries, int value) {
+    REQUIRE(entries.size() == 2);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        CHECK(entries[i].timestamp.count() == static_cast<s64>(i + 1) * 1000);
+        CHECK(entries[i].log_class == Class::Service_FS);
+        CHECK(entries[i].log_level == Level::Debug);
+        CHECK(entries[i].line_num == i + 1);
+        CHECK(entries[i].function == "Function");
+    }
+    CHECK(entries[0].message == "Formatted " + std::to_string(value));
+    CHECK(entries[1].message == "Deferred " + std::to_string(value));
+}
+
+} // Anonymous namespace
+
+TEST_CASE("BinaryFileBackend::Decode", "[common]") {
+    const Tests::TemporaryDirectory directory("binary_log");
+    const std::string path = directory.GetPath() + "citra_log.bin";
+
+    {
+        BinaryFileBackend backend(path);
+        WriteMessages(backend, 1);
+    }
+    CheckMessages(DecodeMessages(path), 1);
+
+    // Opening the log again keeps the previous one aside
+    {
+        BinaryFileBackend backend(path);
+        WriteMessages(backend, 2);
+    }
+    CheckMessages(DecodeMessages(path), 2);
+    CheckMessages(DecodeMessages(path + ".old"), 1);
+}
+
+} // namespace Log
@@ -0,0 +1,49 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "common/logging/deferred.h"
+
+namespace Log {
+
+template <typename... Args>
+static std::string FormatCaptured(const char* format, const Args&... args) {
+    static_assert(AreDeferrableArgs<Args...>());
+    std::vector<u8> data((GetEncodedArgSize(args) + ... + std::size_t{0}));
+    u8* end = data.data();
+    ((end = EncodeDeferredArg(end, args)), ...);
+    REQUIRE(end == data.data() + data.size());
+    return FormatDeferredMessage(format, sizeof...(Args), data.data(), data.size());
+}
+
+TEST_CASE("DeferredLog::MatchesFmt", "[common]") {
+    const std::string str = "string";
+    const std::string_view view = "view";
+    const void* pointer = reinterpret_cast<const void*>(0x1000);
+
+    REQUIRE(FormatCaptured("no arguments") == "no arguments");
+    REQUIRE(FormatCaptured("{} {} {} {}", u8{255}, s8{-1}, u64{0xFFFFFFFFFFFFFFFF}, -5) ==
+            fmt::format("{} {} {} {}", u8{255}, s8{-1}, u64{0xFFFFFFFFFFFFFFFF}, -5));
+    REQUIRE(FormatCaptured("{:08X} {:#x} {:>6}|{:<4}|", u32{0xBEEF}, u16{12}, 42, 7) ==
+            fmt::format("{:08X} {:#x} {:>6}|{:<4}|", u32{0xBEEF}, u16{12}, 42, 7));
+    REQUIRE(FormatCaptured("{} {:.2f} {}", 0.1f, 1.005, 2.5) ==
+            fmt::format("{} {:.2f} {}", 0.1f, 1.005, 2.5));
+    REQUIRE(FormatCaptured("{} {} {}", true, 'c', pointer) ==
+            fmt::format("{} {} {}", true, 'c', pointer));
+    REQUIRE(FormatCaptured("{} {} {} {:>8}", "literal", str, view, str) ==
+            fmt::format("{} {} {} {:>8}", "literal", str, view, str));
+    REQUIRE(FormatCaptured("{1} {0}", 1, 2) == "2 1");
+}
+
+TEST_CASE("DeferredLog::InvalidData", "[common]") {
+    const u8 truncated[] = {static_cast<u8>(DeferredArgType::UInt), 1, 2};
+    REQUIRE(FormatDeferredMessage("{}", 1, truncated, sizeof(truncated)) ==
+            "<invalid log message> {}");
+    REQUIRE(FormatCaptured("{} {}", 1).find("<log format error") == 0);
+}
+
+} // namespace Log
@@ -0,0 +1,24 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <filesystem>
+#include <random>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "tests/common/temporary_directory.h"
+
+namespace Tests {
+
+TemporaryDirectory::TemporaryDirectory(const std::string& name) {
+    std::random_device random;
+    path = fmt::format("{}/citra_{}_{:08x}/", std::filesystem::temp_directory_path().string(), name,
+                       random());
+    FileUtil::CreateFullPath(path);
+}
+
+TemporaryDirectory::~TemporaryDirectory() {
+    FileUtil::DeleteDirRecursively(path);
+}
+
+} // namespace Tests
@@ -0,0 +1,30 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+namespace Tests {
+
+/// Uniquely named directory in the system temporary directory, deleted along with its contents
+/// when this object is destroyed
+class TemporaryDirectory final {
+public:
+    explicit TemporaryDirectory(const std::string& name);
+    ~TemporaryDirectory();
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    /// Returns the path of the directory, with a trailing separator
+    const std::string& GetPath() const {
+        return path;
+    }
+
+private:
+    std::string path;
+};
+
+} // namespace Tests
@@ -0,0 +1,42 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/zstd_compression.h"
+#include "tests/common/temporary_directory.h"
+
+namespace Common::Compression {
+
+TEST_CASE("DecompressDataZSTD from a file", "[common]") {
+    const Tests::TemporaryDirectory directory("zstd_compression");
+    const std::string path = directory.GetPath() + "compressed.bin";
+    const auto decompress_file = [&path](const std::vector<u8>& contents, std::size_t size) {
+        {
+            FileUtil::IOFile file(path, "wb");
+            file.WriteBytes(contents.data(), size);
+        }
+        FileUtil::IOFile file(path, "rb");
+        return DecompressDataZSTD(file);
+    };
+
+    // Sizes around the decoder output chunk size, and one spanning many chunks
+    const std::initializer_list<std::size_t> sizes{1, 0x20000, 0x20001, 0x500000};
+    for (const std::size_t size : sizes) {
+        std::vector<u8> data(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<u8>((i * 7) % 13);
+        }
+        const std::vector<u8> compressed = CompressDataZSTDDefault(data.data(), data.size());
+
+        REQUIRE(decompress_file(compressed, compressed.size()) == data);
+        // Data cut in the middle of the frame is rejected
+        REQUIRE(decompress_file(compressed, compressed.size() - 1).empty());
+    }
+}
+
+} // namespace Common::Compression
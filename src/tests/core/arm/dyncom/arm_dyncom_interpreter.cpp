@@ -0,0 +1,201 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+namespace {
+
+constexpr VAddr CodeAddress = Memory::HEAP_VADDR;
+constexpr VAddr DataAddress = CodeAddress + Memory::PAGE_SIZE;
+constexpr std::size_t RegionSize = Memory::PAGE_SIZE * 3;
+constexpr u32 DoneAddress = CodeAddress + 0x30;
+
+/**
+ * Sums an array of words at r0 with r1 elements, writing the prefix sums back in place and
+ * counting the odd elements, then loads back some of what it wrote.
+ */
+constexpr std::array<u32, 13> TestProgram{
+    0xE3A03000, // mov r3, #0
+    0xE3A04000, // mov r4, #0
+    0xE4902004, // loop: ldr r2, [r0], #4
+    0xE0833002, // add r3, r3, r2
+    0xE3120001, // tst r2, #1
+    0x12844001, // addne r4, r4, #1
+    0xE5003004, // str r3, [r0, #-4]
+    0xE2511001, // subs r1, r1, #1
+    0x1AFFFFF8, // bne loop
+    0xE8800018, // stmia r0, {r3, r4}
+    0xE9100060, // ldmdb r0, {r5, r6}
+    0xE5507004, // ldrb r7, [r0, #-4]
+    0xEAFFFFFE, // done: b done
+};
+
+/**
+ * Memory and CPU running TestProgram, with the program and its data in plain memory pages. Unlike
+ * the MMIO of TestEnvironment, these are accessed through the page pointer cache of the CPU.
+ */
+class TestCPU {
+public:
+    TestCPU() : kernel(memory, timing, [] {}, 0, 1, 0) {
+        auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+        MemoryRef block{backing};
+        process->vm_manager.MapBackingMemory(CodeAddress, block, block.GetSize(),
+                                             Kernel::MemoryState::Private);
+        kernel.SetCurrentProcess(process);
+
+        cpu = std::make_unique<ARM_DynCom>(&Core::System::GetInstance(), memory, USER32MODE, 0,
+                                           timing.GetTimer(0));
+        for (std::size_t i = 0; i < TestProgram.size(); ++i) {
+            memory.Write32(CodeAddress + static_cast<VAddr>(i * 4), TestProgram[i]);
+        }
+    }
+
+    /// Fills count words of data and points the program at them
+    void Reset(u32 count) {
+        for (u32 i = 0; i < count; ++i) {
+            memory.Write32(DataAddress + i * 4, i * 3 + 1);
+        }
+        cpu->SetPC(CodeAddress);
+        cpu->SetReg(0, DataAddress);
+        cpu->SetReg(1, count);
+    }
+
+    /// Runs the program for up to num_instructions instructions
+    void Run(s64 num_instructions) {
+        timing.GetTimer(0)->SetNextSlice(num_instructions);
+        cpu->Run();
+    }
+
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel;
+    std::shared_ptr<BufferMem> backing = std::make_shared<BufferMem>(RegionSize);
+    std::unique_ptr<ARM_DynCom> cpu;
+};
+
+/// Writes TestProgram and count words of data to the test environment and points cpu at them
+void LoadTestProgram(TestEnvironment& test_env, ARM_DynCom& cpu, u32 count) {
+    for (std::size_t i = 0; i < TestProgram.size(); ++i) {
+        test_env.SetMemory32(CodeAddress + static_cast<VAddr>(i * 4), TestProgram[i]);
+    }
+    for (u32 i = 0; i < count; ++i) {
+        test_env.SetMemory32(DataAddress + i * 4, i * 3 + 1);
+    }
+    cpu.SetPC(CodeAddress);
+    cpu.SetReg(0, DataAddress);
+    cpu.SetReg(1, count);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ARM_DynCom::Run", "[arm_dyncom]") {
+    TestCPU test_cpu;
+    auto& cpu = *test_cpu.cpu;
+    constexpr u32 count = 64;
+
+    u32 sum = 0;
+    u32 odd_count = 0;
+    for (u32 i = 0; i < count; ++i) {
+        sum += i * 3 + 1;
+        odd_count += (i * 3 + 1) & 1;
+    }
+    const u32 previous_sum = sum - ((count - 1) * 3 + 1);
+
+    SECTION("loads, stores and conditional instructions") {
+        test_cpu.Reset(count);
+        test_cpu.Run(10000);
+        REQUIRE(cpu.GetPC() == DoneAddress);
+        REQUIRE(cpu.GetReg(0) == DataAddress + count * 4);
+        REQUIRE(cpu.GetReg(3) == sum);
+        REQUIRE(cpu.GetReg(4) == odd_count);
+        REQUIRE(cpu.GetReg(5) == previous_sum);
+        REQUIRE(cpu.GetReg(6) == sum);
+        REQUIRE(cpu.GetReg(7) == (sum & 0xFF));
+        REQUIRE(test_cpu.memory.Read32(DataAddress) == 1);
+        REQUIRE(test_cpu.memory.Read32(DataAddress + (count - 1) * 4) == sum);
+        REQUIRE(test_cpu.memory.Read32(DataAddress + count * 4) == sum);
+        REQUIRE(test_cpu.memory.Read32(DataAddress + count * 4 + 4) == odd_count);
+    }
+
+    SECTION("the instruction budget is respected") {
+        // mov, mov and the first iteration of the loop, stopping before the bne
+        test_cpu.Reset(count);
+        test_cpu.Run(8);
+        REQUIRE(cpu.GetPC() == CodeAddress + 0x20);
+        REQUIRE(cpu.GetReg(1) == count - 1);
+        REQUIRE(cpu.GetReg(3) == 1);
+    }
+
+    SECTION("modified code runs once the cache is invalidated") {
+        test_cpu.Reset(count);
+        test_cpu.Run(10000);
+        REQUIRE(cpu.GetReg(3) == sum);
+
+        test_cpu.memory.Write32(CodeAddress, 0xE3A03005); // mov r3, #5
+        cpu.InvalidateCacheRange(CodeAddress, 4);
+        test_cpu.Reset(count);
+        test_cpu.Run(10000);
+        REQUIRE(cpu.GetPC() == DoneAddress);
+        REQUIRE(cpu.GetReg(3) == sum + 5);
+    }
+}
+
+TEST_CASE("ARM_DynCom::Run (MMIO)", "[arm_dyncom]") {
+    TestEnvironment test_env(true);
+    Core::Timing timing(1, 100);
+    ARM_DynCom cpu(&Core::System::GetInstance(), test_env.GetMemory(), USER32MODE, 0,
+                   timing.GetTimer(0));
+    constexpr u32 count = 4;
+    LoadTestProgram(test_env, cpu, count);
+
+    // Accesses to MMIO skip the page pointer cache
+    timing.GetTimer(0)->SetNextSlice(1000);
+    cpu.Run();
+    REQUIRE(cpu.GetPC() == DoneAddress);
+    REQUIRE(cpu.GetReg(3) == 22);
+    REQUIRE(cpu.GetReg(4) == 2);
+    REQUIRE(cpu.GetReg(5) == 12);
+    REQUIRE(cpu.GetReg(6) == 22);
+    REQUIRE(cpu.GetReg(7) == 22);
+    // The prefix sums, then the stmia
+    const std::vector<WriteRecord> expected{
+        {32, DataAddress, 1},       {32, DataAddress + 4, 5},  {32, DataAddress + 8, 12},
+        {32, DataAddress + 12, 22}, {32, DataAddress + 16, 22}, {32, DataAddress + 20, 2},
+    };
+    REQUIRE(test_env.GetWriteRecords() == expected);
+}
+
+TEST_CASE("ARM_DynCom", "[.benchmark]") {
+    TestEnvironment test_env(true);
+    Core::Timing timing(1, 100);
+    ARM_DynCom cpu(&Core::System::GetInstance(), test_env.GetMemory(), USER32MODE, 0,
+                   timing.GetTimer(0));
+    constexpr u32 count = 1024;
+    // The loop takes 7 instructions per word, the rest of the program 5
+    constexpr s64 num_instructions = count * 7 + 5;
+    LoadTestProgram(test_env, cpu, count);
+
+    BENCHMARK("Run") {
+        cpu.SetPC(CodeAddress);
+        cpu.SetReg(0, DataAddress);
+        cpu.SetReg(1, count);
+        timing.GetTimer(0)->SetNextSlice(num_instructions);
+        cpu.Run();
+        test_env.ClearWriteRecords();
+    };
+}
+
+} // namespace ArmTests
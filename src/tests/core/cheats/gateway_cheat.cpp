@@ -0,0 +1,250 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/cheats/gateway_cheat.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+using Cheats::GatewayCheat;
+
+namespace {
+
+constexpr VAddr CheatRegionAddress = Memory::HEAP_VADDR;
+constexpr std::size_t CheatRegionSize = Memory::PAGE_SIZE;
+
+/// Memory region mapped at CheatRegionAddress that the cheats in this file read and write
+class CheatMemory {
+public:
+    CheatMemory() : kernel(memory, timing, [] {}, 0, 1, 0) {
+        auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+        MemoryRef block{backing};
+        process->vm_manager.MapBackingMemory(CheatRegionAddress, block, block.GetSize(),
+                                             Kernel::MemoryState::Private);
+        kernel.SetCurrentProcess(process);
+    }
+
+    void Reset() {
+        for (std::size_t i = 0; i < CheatRegionSize; ++i) {
+            backing->GetPtr()[i] = static_cast<u8>(i * 7);
+        }
+        invalidated.clear();
+    }
+
+    std::vector<u8> GetContents() const {
+        return {backing->GetPtr(), backing->GetPtr() + CheatRegionSize};
+    }
+
+    GatewayCheat::ExecutionContext GetContext(u32 pad_state) {
+        return {
+            memory,
+            [this](VAddr address, std::size_t size) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    invalidated.insert(static_cast<VAddr>(address + i));
+                }
+            },
+            [pad_state] { return pad_state; },
+        };
+    }
+
+    /// Bytes whose CPU caches have been invalidated since the last reset
+    std::set<VAddr> invalidated;
+
+private:
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel;
+    std::shared_ptr<BufferMem> backing = std::make_shared<BufferMem>(CheatRegionSize);
+};
+
+/// Checks that the compiled cheat leaves memory as the line interpreter does
+std::vector<u8> RunAndCompare(CheatMemory& cheat_memory, const std::string& code,
+                              u32 pad_state = 0) {
+    const GatewayCheat cheat("Test", code, "");
+
+    cheat_memory.Reset();
+    cheat.RunInterpreted(cheat_memory.GetContext(pad_state));
+    const std::vector<u8> expected = cheat_memory.GetContents();
+    const std::set<VAddr> expected_invalidated = cheat_memory.invalidated;
+
+    cheat_memory.Reset();
+    cheat.Run(cheat_memory.GetContext(pad_state));
+    REQUIRE(cheat_memory.GetContents() == expected);
+    REQUIRE(cheat_memory.invalidated == expected_invalidated);
+    return expected;
+}
+
+u32 ReadWord(const std::vector<u8>& contents, std::size_t offset) {
+    return contents[offset] | contents[offset + 1] << 8 | contents[offset + 2] << 16 |
+           contents[offset + 3] << 24;
+}
+
+const std::vector<std::string> TestCheats = {
+    // Writes
+    "08000000 11111111\n"
+    "18000004 0000BEEF\n"
+    "28000006 000000AA\n",
+    // Conditional blocks
+    "08000000 11111111\n"
+    "38000000 00000000\n"
+    "08000004 22222222\n"
+    "D0000000 00000000\n"
+    "58000000 11111111\n"
+    "08000008 33333333\n"
+    "D0000000 00000000\n"
+    "D2000000 00000000\n",
+    // Nested conditional blocks
+    "08000000 11111111\n"
+    "68000000 11111111\n"
+    "58000000 11111111\n"
+    "0800000C 44444444\n"
+    "D0000000 00000000\n"
+    "08000010 55555555\n"
+    "D0000000 00000000\n"
+    "08000014 66666666\n",
+    // Masked 16 bit conditions
+    "18000020 00001234\n"
+    "98000020 00FF0034\n"
+    "18000022 00005678\n"
+    "D0000000 00000000\n"
+    "A8000020 00001234\n"
+    "18000024 00009ABC\n"
+    "D0000000 00000000\n",
+    // Loop with incrementive writes
+    "D3000000 08000100\n"
+    "D5000000 00000000\n"
+    "C0000000 00000007\n"
+    "D4000000 00000001\n"
+    "D6000000 00000000\n"
+    "D7000000 00000000\n"
+    "D8000000 00000000\n"
+    "D1000000 00000000\n"
+    "D2000000 00000000\n",
+    // Block skipped up to a FullTerminator
+    "D3000000 00000200\n"
+    "58000000 00000000\n"
+    "08000000 77777777\n"
+    "D2000000 00000000\n"
+    "08000300 88888888\n",
+    // Loads and offsets
+    "08000040 08000080\n"
+    "B8000040 00000000\n"
+    "D9000000 00000000\n"
+    "DC000000 00000010\n"
+    "D6000000 00000000\n"
+    "D2000000 00000000\n"
+    "DB000000 08000041\n"
+    "DA000000 08000042\n"
+    "D8000000 08000050\n",
+    // Patches, one of them skipped
+    "E8000400 0000000B\n"
+    "01234567 89ABCDEF\n"
+    "FEDCBA98 76543210\n"
+    "38000000 00000000\n"
+    "E8000500 00000010\n"
+    "11111111 22222222\n"
+    "33333333 44444444\n"
+    "D0000000 00000000\n"
+    "E8000600 00000003\n"
+    "AABBCCDD 00000000\n",
+    // Joker
+    "DD000000 00000003\n"
+    "08000000 99999999\n"
+    "D0000000 00000000\n",
+};
+
+} // Anonymous namespace
+
+TEST_CASE("GatewayCheat::Run", "[core][cheats]") {
+    CheatMemory cheat_memory;
+
+    SECTION("writes") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[0]);
+        REQUIRE(ReadWord(contents, 0) == 0x11111111);
+        REQUIRE(contents[4] == 0xEF);
+        REQUIRE(contents[5] == 0xBE);
+        REQUIRE(contents[6] == 0xAA);
+    }
+
+    SECTION("conditional blocks") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[1]);
+        REQUIRE(ReadWord(contents, 4) != 0x22222222);
+        REQUIRE(ReadWord(contents, 8) == 0x33333333);
+    }
+
+    SECTION("nested conditional blocks") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[2]);
+        REQUIRE(ReadWord(contents, 0xC) != 0x44444444);
+        REQUIRE(ReadWord(contents, 0x10) != 0x55555555);
+        REQUIRE(ReadWord(contents, 0x14) == 0x66666666);
+    }
+
+    SECTION("masked conditions") {
+        RunAndCompare(cheat_memory, TestCheats[3]);
+    }
+
+    SECTION("loops") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[4]);
+        REQUIRE(ReadWord(contents, 0x100) == 1);
+        REQUIRE(ReadWord(contents, 0x107) == 2);
+    }
+
+    SECTION("blocks skipped up to a FullTerminator") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[5]);
+        REQUIRE(ReadWord(contents, 0x200) != 0x77777777);
+        REQUIRE(ReadWord(contents, 0x300) == 0x88888888);
+    }
+
+    SECTION("loads and offsets") {
+        RunAndCompare(cheat_memory, TestCheats[6]);
+    }
+
+    SECTION("patches") {
+        const auto contents = RunAndCompare(cheat_memory, TestCheats[7]);
+        REQUIRE(ReadWord(contents, 0x400) == 0x01234567);
+        REQUIRE(ReadWord(contents, 0x404) == 0x89ABCDEF);
+        REQUIRE(contents[0x408] == 0x98);
+        REQUIRE(contents[0x40A] == 0xDC);
+        REQUIRE(ReadWord(contents, 0x500) != 0x11111111);
+        REQUIRE(contents[0x600] == 0xDD);
+        REQUIRE(contents[0x602] == 0xBB);
+    }
+
+    SECTION("joker") {
+        REQUIRE(ReadWord(RunAndCompare(cheat_memory, TestCheats[8], 0x1), 0) != 0x99999999);
+        REQUIRE(ReadWord(RunAndCompare(cheat_memory, TestCheats[8], 0x7), 0) == 0x99999999);
+    }
+}
+
+TEST_CASE("GatewayCheat", "[.benchmark]") {
+    CheatMemory cheat_memory;
+    cheat_memory.Reset();
+    const auto context = cheat_memory.GetContext(0x3);
+
+    std::vector<std::unique_ptr<GatewayCheat>> cheats;
+    for (int i = 0; i < 4; ++i) {
+        for (const auto& code : TestCheats) {
+            cheats.push_back(std::make_unique<GatewayCheat>("Test", code, ""));
+        }
+    }
+
+    BENCHMARK("RunInterpreted") {
+        for (const auto& cheat : cheats) {
+            cheat->RunInterpreted(context);
+        }
+    };
+
+    BENCHMARK("Run") {
+        for (const auto& cheat : cheats) {
+            cheat->Run(context);
+        }
+    };
+}
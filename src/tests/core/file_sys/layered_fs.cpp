@@ -0,0 +1,339 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/crc.hpp>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/string_util.h"
+#include "core/file_sys/layered_fs.h"
+#include "tests/common/temporary_directory.h"
+
+namespace FileSys {
+
+namespace {
+
+/// RomFS reader backed by a buffer in memory
+class MemoryRomFSReader : public RomFSReader {
+public:
+    explicit MemoryRomFSReader(std::vector<u8> data) : data(std::move(data)) {}
+
+    std::size_t GetSize() const override {
+        return data.size();
+    }
+
+    std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override {
+        if (offset >= data.size()) {
+            return 0;
+        }
+        length = std::min(length, data.size() - offset);
+        std::memcpy(buffer, data.data() + offset, length);
+        return length;
+    }
+
+private:
+    std::vector<u8> data;
+};
+
+struct FileMetadata {
+    u32_le parent_directory_offset;
+    u32_le next_sibling_offset;
+    u64_le file_data_offset;
+    u64_le file_data_length;
+    u32_le hash_bucket_next;
+    u32_le name_length;
+};
+static_assert(sizeof(FileMetadata) == 0x20);
+
+/// Builds a RomFS image that only contains an empty root directory
+std::vector<u8> MakeEmptyRomFS() {
+    constexpr u32 hash_table_size = 3 * sizeof(u32_le);
+    constexpr u32 root_metadata_size = 0x18;
+
+    RomFSHeader header{};
+    header.header_length = sizeof(RomFSHeader);
+    header.directory_hash_table = {sizeof(RomFSHeader), hash_table_size};
+    header.directory_metadata_table = {header.directory_hash_table.offset + hash_table_size,
+                                       root_metadata_size};
+    header.file_hash_table = {header.directory_metadata_table.offset + root_metadata_size,
+                              hash_table_size};
+    header.file_metadata_table = {header.file_hash_table.offset + hash_table_size, 0};
+    header.file_data_offset = 0x60;
+
+    std::vector<u8> image(header.file_data_offset, 0xFF);
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    // The root directory is its own parent and has no siblings, children or name
+    u8* root = image.data() + header.directory_metadata_table.offset;
+    std::memset(root, 0, sizeof(u32_le));
+    std::memset(root + root_metadata_size - sizeof(u32_le), 0, sizeof(u32_le));
+    return image;
+}
+
+std::vector<u8> MakeFileContents(const std::string& name) {
+    std::vector<u8> contents(1 + (name.size() * 977) % 5000);
+    for (std::size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<u8>(name[i % name.size()] + i);
+    }
+    return contents;
+}
+
+std::string GetFileName(std::size_t directory, std::size_t file) {
+    return fmt::format("d{}_{}.bin", directory, std::string(file % 13 + 1, 'f') +
+                                                    std::to_string(file));
+}
+
+/// Synthetic mod tree with a number of directories containing replacement files
+class SyntheticModTree {
+public:
+    SyntheticModTree(std::size_t num_directories, std::size_t files_per_directory)
+        : directory("layered_fs"), root(directory.GetPath()) {
+        for (std::size_t d = 0; d < num_directories; ++d) {
+            const auto directory = fmt::format("{}romfs/dir{}/", root, d);
+            FileUtil::CreateFullPath(directory);
+            for (std::size_t f = 0; f < files_per_directory; ++f) {
+                const auto name = GetFileName(d, f);
+                const auto contents = MakeFileContents(name);
+                FileUtil::IOFile file(directory + name, "wb");
+                file.WriteBytes(contents.data(), contents.size());
+            }
+        }
+    }
+
+    void WriteFile(const std::string& path, const std::vector<u8>& contents) const {
+        FileUtil::CreateFullPath(root + path);
+        FileUtil::IOFile file(root + path, "wb");
+        file.WriteBytes(contents.data(), contents.size());
+    }
+
+    std::string PatchPath() const {
+        return root + "romfs/";
+    }
+
+    std::string PatchExtPath() const {
+        return root + "romfs_ext/";
+    }
+
+private:
+    Tests::TemporaryDirectory directory;
+    std::string root;
+};
+
+/// Reads back the entire image of a RomFS reader
+std::vector<u8> ReadImage(RomFSReader& reader) {
+    std::vector<u8> image(reader.GetSize());
+    REQUIRE(reader.ReadFile(0, image.size(), image.data()) == image.size());
+    return image;
+}
+
+/// Walks the file metadata table of an image and invokes func(name, data_offset, data_length)
+template <typename Func>
+void ForEachFile(const std::vector<u8>& image, Func&& func) {
+    RomFSHeader header;
+    std::memcpy(&header, image.data(), sizeof(header));
+
+    std::size_t offset = header.file_metadata_table.offset;
+    const std::size_t end = offset + header.file_metadata_table.length;
+    while (offset < end) {
+        FileMetadata metadata;
+        std::memcpy(&metadata, image.data() + offset, sizeof(metadata));
+        offset += sizeof(metadata);
+
+        std::u16string name(metadata.name_length / 2, u'\0');
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            u16_le character;
+            std::memcpy(&character, image.data() + offset + i * 2, sizeof(character));
+            name[i] = static_cast<char16_t>(static_cast<u16>(character));
+        }
+        offset += (metadata.name_length + 3) & ~3u;
+
+        func(Common::UTF16ToUTF8(name), header.file_data_offset + metadata.file_data_offset,
+             static_cast<std::size_t>(metadata.file_data_length));
+    }
+}
+
+/// Builds an IPS patch with one plain record and one RLE record
+std::vector<u8> MakeIpsPatch(u32 offset, const std::vector<u8>& data, u32 rle_offset,
+                             u16 rle_length, u8 rle_value) {
+    std::vector<u8> patch{'P', 'A', 'T', 'C', 'H'};
+    const auto push_offset = [&patch](u32 value) {
+        patch.insert(patch.end(), {static_cast<u8>(value >> 16), static_cast<u8>(value >> 8),
+                                   static_cast<u8>(value)});
+    };
+    push_offset(offset);
+    patch.insert(patch.end(), {static_cast<u8>(data.size() >> 8), static_cast<u8>(data.size())});
+    patch.insert(patch.end(), data.begin(), data.end());
+    push_offset(rle_offset);
+    patch.insert(patch.end(), {0, 0, static_cast<u8>(rle_length >> 8),
+                               static_cast<u8>(rle_length), rle_value});
+    patch.insert(patch.end(), {'E', 'O', 'F'});
+    return patch;
+}
+
+u32 Crc32(const std::vector<u8>& data) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data.data(), data.size());
+    return crc.checksum();
+}
+
+/// Builds a BPS patch that keeps the first half of source and stores the rest of target verbatim
+std::vector<u8> MakeBpsPatch(const std::vector<u8>& source, const std::vector<u8>& target) {
+    std::vector<u8> patch{'B', 'P', 'S', '1'};
+    const auto push_number = [&patch](u32 value) {
+        while (true) {
+            const u8 x = value & 0x7F;
+            value >>= 7;
+            if (value == 0) {
+                patch.push_back(0x80 | x);
+                break;
+            }
+            patch.push_back(x);
+            --value;
+        }
+    };
+    const auto push_u32 = [&patch](u32 value) {
+        for (int i = 0; i < 4; ++i) {
+            patch.push_back(static_cast<u8>(value >> (i * 8)));
+        }
+    };
+
+    const u32 kept = static_cast<u32>(source.size() / 2);
+    push_number(static_cast<u32>(source.size()));
+    push_number(static_cast<u32>(target.size()));
+    push_number(0); // Metadata size
+    push_number((kept - 1) << 2 | 0); // SourceRead
+    push_number((static_cast<u32>(target.size()) - kept - 1) << 2 | 1); // TargetRead
+    patch.insert(patch.end(), target.begin() + kept, target.end());
+    push_u32(Crc32(source));
+    push_u32(Crc32(target));
+    push_u32(Crc32(patch));
+    return patch;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("LayeredFS replaces and relays files", "[core][file_sys]") {
+    constexpr std::size_t num_directories = 4;
+    constexpr std::size_t files_per_directory = 20;
+    SyntheticModTree tree(num_directories, files_per_directory);
+
+    auto base = std::make_shared<MemoryRomFSReader>(MakeEmptyRomFS());
+    LayeredFS layered(base, tree.PatchPath(), tree.PatchExtPath());
+    const auto image = ReadImage(layered);
+
+    std::size_t num_files = 0;
+    ForEachFile(image, [&](const std::string& name, std::size_t offset, std::size_t length) {
+        const auto expected = MakeFileContents(name);
+        REQUIRE(length == expected.size());
+        CHECK(std::memcmp(image.data() + offset, expected.data(), length) == 0);
+
+        // Small reads go through the cached replacement file handles
+        std::vector<u8> buffer(length);
+        CHECK(layered.ReadFile(offset, length, buffer.data()) == length);
+        CHECK(buffer == expected);
+        ++num_files;
+    });
+    CHECK(num_files == num_directories * files_per_directory);
+
+    SECTION("unmodified files read back identically") {
+        // Without relocations every file keeps its original layout, so reads are merged
+        auto relayed_base = std::make_shared<MemoryRomFSReader>(image);
+        LayeredFS relayed(relayed_base, "", "", false);
+        CHECK(ReadImage(relayed) == image);
+
+        ForEachFile(image, [&](const std::string& name, std::size_t offset, std::size_t length) {
+            std::vector<u8> buffer(length + 7);
+            const std::size_t to_read = std::min(buffer.size(), image.size() - offset);
+            CHECK(relayed.ReadFile(offset, to_read, buffer.data()) == to_read);
+            CHECK(std::memcmp(buffer.data(), image.data() + offset, to_read) == 0);
+        });
+    }
+}
+
+TEST_CASE("LayeredFS applies IPS and BPS patches", "[core][file_sys]") {
+    SyntheticModTree tree(0, 0);
+    const auto ips_original = MakeFileContents("ips_target.bin");
+    const auto bps_original = MakeFileContents("bps_target.bin");
+    const auto invalid_original = MakeFileContents("invalid_target.bin");
+    tree.WriteFile("romfs/ips_target.bin", ips_original);
+    tree.WriteFile("romfs/bps_target.bin", bps_original);
+    tree.WriteFile("romfs/invalid_target.bin", invalid_original);
+
+    // Patches are applied against files of the original RomFS, so build one containing the targets
+    auto empty_base = std::make_shared<MemoryRomFSReader>(MakeEmptyRomFS());
+    LayeredFS original(empty_base, tree.PatchPath(), "");
+    auto base = std::make_shared<MemoryRomFSReader>(ReadImage(original));
+
+    auto ips_expected = ips_original;
+    const std::vector<u8> ips_data{0xDE, 0xAD, 0xBE, 0xEF};
+    std::copy(ips_data.begin(), ips_data.end(), ips_expected.begin() + 3);
+    std::fill_n(ips_expected.begin() + 10, 5, u8{0x5A});
+    tree.WriteFile("romfs_ext/ips_target.bin.ips", MakeIpsPatch(3, ips_data, 10, 5, 0x5A));
+
+    auto bps_expected = bps_original;
+    for (std::size_t i = bps_expected.size() / 2; i < bps_expected.size(); ++i) {
+        bps_expected[i] = static_cast<u8>(~bps_expected[i]);
+    }
+    tree.WriteFile("romfs_ext/bps_target.bin.bps", MakeBpsPatch(bps_original, bps_expected));
+
+    tree.WriteFile("romfs_ext/invalid_target.bin.ips", {'N', 'O', 'T', 'I', 'P', 'S', 0, 0});
+
+    LayeredFS patched(base, "", tree.PatchExtPath());
+    const auto image = ReadImage(patched);
+
+    std::size_t num_files = 0;
+    ForEachFile(image, [&](const std::string& name, std::size_t offset, std::size_t length) {
+        const std::vector<u8> contents(image.begin() + offset, image.begin() + offset + length);
+        if (name == "ips_target.bin") {
+            CHECK(contents == ips_expected);
+        } else if (name == "bps_target.bin") {
+            CHECK(contents == bps_expected);
+        } else {
+            // A patch that fails to apply leaves the original file in place
+            CHECK(name == "invalid_target.bin");
+            CHECK(contents == invalid_original);
+        }
+        ++num_files;
+    });
+    CHECK(num_files == 3);
+}
+
+TEST_CASE("LayeredFS throughput on a synthetic mod tree", "[.benchmark][core][file_sys]") {
+    SyntheticModTree tree(16, 64);
+    auto base = std::make_shared<MemoryRomFSReader>(MakeEmptyRomFS());
+
+    BENCHMARK("Load 1024 replacement files") {
+        return LayeredFS(base, tree.PatchPath(), tree.PatchExtPath()).GetSize();
+    };
+
+    LayeredFS layered(base, tree.PatchPath(), tree.PatchExtPath());
+    const auto image = ReadImage(layered);
+    std::vector<std::pair<std::size_t, std::size_t>> files;
+    ForEachFile(image, [&](const std::string&, std::size_t offset, std::size_t length) {
+        files.emplace_back(offset, length);
+    });
+    std::vector<u8> buffer(image.size());
+
+    BENCHMARK("Read every replaced file") {
+        std::size_t total = 0;
+        for (const auto& [offset, length] : files) {
+            total += layered.ReadFile(offset, length, buffer.data());
+        }
+        return total;
+    };
+
+    auto relayed_base = std::make_shared<MemoryRomFSReader>(image);
+    LayeredFS relayed(relayed_base, "", "", false);
+
+    BENCHMARK("Read whole image of unmodified files") {
+        return relayed.ReadFile(0, buffer.size(), buffer.data());
+    };
+}
+
+} // namespace FileSys
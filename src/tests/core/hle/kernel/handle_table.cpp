@@ -0,0 +1,82 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/mutex.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+namespace Kernel {
+
+TEST_CASE("HandleTable::GetPointer", "[core][kernel]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    HandleTable handle_table(kernel);
+
+    auto event = kernel.CreateEvent(ResetType::OneShot);
+    const Handle handle = handle_table.Create(event).Unwrap();
+
+    SECTION("finds the same objects as Get") {
+        REQUIRE(handle_table.GetPointer<Event>(handle) == event.get());
+        REQUIRE(handle_table.GetPointer<WaitObject>(handle) == event.get());
+        REQUIRE(handle_table.GetGenericPointer(handle) == handle_table.GetGeneric(handle).get());
+    }
+
+    SECTION("checks the object type") {
+        REQUIRE(handle_table.GetPointer<Mutex>(handle) == nullptr);
+        REQUIRE(handle_table.Get<Mutex>(handle) == nullptr);
+    }
+
+    SECTION("checks the handle generation") {
+        REQUIRE(handle_table.Close(handle) == RESULT_SUCCESS);
+        REQUIRE(handle_table.GetPointer<Event>(handle) == nullptr);
+
+        // The slot is reused by the next handle, with another generation
+        auto other_event = kernel.CreateEvent(ResetType::OneShot);
+        const Handle other_handle = handle_table.Create(other_event).Unwrap();
+        REQUIRE(other_handle != handle);
+        REQUIRE(handle_table.GetPointer<Event>(handle) == nullptr);
+        REQUIRE(handle_table.GetPointer<Event>(other_handle) == other_event.get());
+    }
+}
+
+TEST_CASE("HandleTable", "[.benchmark]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    HandleTable handle_table(kernel);
+
+    // What svcSignalEvent followed by a svcWaitSynchronization1 that does not block do with the
+    // handle table
+    const Handle handle = handle_table.Create(kernel.CreateEvent(ResetType::OneShot)).Unwrap();
+    constexpr int iterations = 1000;
+
+    BENCHMARK("Get") {
+        for (int i = 0; i < iterations; ++i) {
+            handle_table.Get<Event>(handle)->Signal();
+            auto object = handle_table.Get<WaitObject>(handle);
+            if (!object->ShouldWait(nullptr)) {
+                object->Acquire(nullptr);
+            }
+        }
+    };
+
+    BENCHMARK("GetPointer") {
+        for (int i = 0; i < iterations; ++i) {
+            handle_table.GetPointer<Event>(handle)->Signal();
+            auto object = handle_table.GetPointer<WaitObject>(handle);
+            if (!object->ShouldWait(nullptr)) {
+                object->Acquire(nullptr);
+            }
+        }
+    };
+}
+
+} // namespace Kernel
@@ -0,0 +1,58 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <catch2/catch.hpp>
+#include "core/hle/service/call_stats.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("CallStats::Command::Record", "[core][service]") {
+    Service::CallStats call_stats;
+    auto& command = call_stats.GetCommand("srv:", "Initialize", 0x00010002);
+    REQUIRE(&call_stats.GetCommand("srv:", "Initialize", 0x00010002) == &command);
+
+    command.Record(500ns);
+    command.Record(1us);
+    command.Record(3us);
+    command.Record(10s);
+
+    const auto results = call_stats.GetResults();
+    REQUIRE(results.size() == 1);
+    const auto& result = results[0];
+    REQUIRE(result.service_name == "srv:");
+    REQUIRE(result.function_name == "Initialize");
+    REQUIRE(result.header_code == 0x00010002);
+    REQUIRE(result.calls == 4);
+    REQUIRE(result.total_time == 10s + 4us + 500ns);
+    REQUIRE(result.max_time == 10s);
+    REQUIRE(result.histogram[0] == 1);
+    REQUIRE(result.histogram[1] == 1);
+    REQUIRE(result.histogram[2] == 1);
+    REQUIRE(result.histogram[Service::CallStats::NumBuckets - 1] == 1);
+    REQUIRE(result.GetPercentile(50) == 4us);
+}
+
+TEST_CASE("CallStats::GetResults", "[core][service]") {
+    Service::CallStats call_stats;
+    auto& fast = call_stats.GetCommand("fs:USER", "ReadFile", 0x080200C2);
+    auto& slow = call_stats.GetCommand("fs:USER", "OpenFile", 0x080201C2);
+    call_stats.GetCommand("fs:USER", "CloseFile", 0x08080000);
+
+    fast.Record(1us);
+    fast.Record(1us);
+    slow.Record(1ms);
+
+    auto results = call_stats.GetResults();
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].function_name == "OpenFile");
+    REQUIRE(results[1].function_name == "ReadFile");
+
+    call_stats.Reset();
+    REQUIRE(call_stats.GetResults().empty());
+    fast.Record(1us);
+    results = call_stats.GetResults();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].calls == 1);
+}
@@ -0,0 +1,305 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/alignment.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/service/ldr_ro/cro_helper.h"
+#include "core/memory.h"
+
+using Service::LDR::CROHelper;
+
+namespace {
+
+constexpr VAddr CRSAddress = Memory::PROCESS_IMAGE_VADDR;
+constexpr VAddr CROAddress = CRSAddress + 0x1000;
+constexpr VAddr OtherCROAddress = CRSAddress + 0x2000;
+constexpr VAddr DataBufferAddress = CRSAddress + 0x3000;
+constexpr VAddr OtherDataBufferAddress = CRSAddress + 0x4000;
+constexpr u32 MemorySize = 0x5000;
+
+constexpr u32 ModuleSize = 0x1000;
+constexpr u32 CodeOffset = 0x140;
+constexpr u32 CodeSize = 0x40;
+constexpr u32 DataOffset = 0x800;
+constexpr u32 DataSize = 0x10;
+
+constexpr u32 CodeSegment = 0;
+constexpr u32 DataSegment = 2;
+
+/// Header fields of the CRO format, in words from the end of the hash
+enum HeaderField : u32 {
+    Magic = 0,
+    FileSize = 4,
+    OnUnresolvedSegmentTag = 11,
+    CodeOffsetField = 12,
+    DataOffsetField = 14,
+    ModuleNameOffset = 16,
+    SegmentTableOffset = 18,
+    ExportNamedSymbolTableOffset = 20,
+    ExportIndexedSymbolTableOffset = 22,
+    ExportStringsOffset = 24,
+    ExportTreeTableOffset = 26,
+    ImportModuleTableOffset = 28,
+    ExternalRelocationTableOffset = 30,
+    ImportNamedSymbolTableOffset = 32,
+    ImportIndexedSymbolTableOffset = 34,
+    ImportAnonymousSymbolTableOffset = 36,
+    ImportStringsOffset = 38,
+    StaticAnonymousSymbolTableOffset = 40,
+    InternalRelocationTableOffset = 42,
+    StaticRelocationTableOffset = 44,
+};
+
+constexpr u32 SegmentTag(u32 segment, u32 offset) {
+    return segment | offset << 4;
+}
+
+/// A module exporting at most one named symbol and importing named symbols from other modules
+struct ModuleInfo {
+    std::string name;
+    std::string export_name; ///< empty if the module exports nothing
+    u32 export_position;
+    std::vector<std::pair<std::string, u32>> imports; ///< names and relocation targets
+};
+
+/**
+ * Builds a CRO file with the code and the data segments and the named symbol tables.
+ * @param segment_base the address the segment offsets are relative to. The segment table of the
+ *                     static module is not rebased, so it holds the final addresses.
+ */
+std::vector<u8> BuildModule(const ModuleInfo& info, VAddr segment_base = 0) {
+    std::vector<u8> file(ModuleSize);
+    const auto write32 = [&file](u32 offset, u32 value) {
+        std::memcpy(file.data() + offset, &value, sizeof(value));
+    };
+    const auto write_string = [&file](u32 offset, const std::string& string) {
+        std::memcpy(file.data() + offset, string.c_str(), string.size() + 1);
+    };
+    const auto write_field = [&write32](HeaderField field, u32 value) {
+        write32(Service::LDR::CRO_HASH_SIZE + field * 4, value);
+    };
+
+    // Tables must be laid out in this order
+    u32 offset = CodeOffset + CodeSize;
+    const auto add_table = [&](HeaderField field, u32 num, u32 entry_size) {
+        const u32 table_offset = offset;
+        write_field(field, table_offset);
+        write_field(static_cast<HeaderField>(field + 1), num);
+        offset = Common::AlignUp(offset + num * entry_size, 4);
+        return table_offset;
+    };
+
+    write_field(Magic, 0x304F5243); // CRO0
+    write_field(FileSize, ModuleSize);
+    write_field(OnUnresolvedSegmentTag, SegmentTag(CodeSegment, 0));
+    write_field(CodeOffsetField, CodeOffset);
+    write_field(static_cast<HeaderField>(CodeOffsetField + 1), CodeSize);
+
+    write_string(add_table(ModuleNameOffset, static_cast<u32>(info.name.size() + 1), 1),
+                 info.name);
+
+    const u32 segment_table = add_table(SegmentTableOffset, 3, 12);
+    const std::array<std::array<u32, 3>, 3> segments{{
+        {segment_base + CodeOffset, CodeSize, 0},
+        {0, 0, 1},
+        {segment_base + DataOffset, DataSize, 2},
+    }};
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        for (std::size_t j = 0; j < segments[i].size(); ++j) {
+            write32(static_cast<u32>(segment_table + i * 12 + j * 4), segments[i][j]);
+        }
+    }
+
+    const u32 export_num = info.export_name.empty() ? 0 : 1;
+    const u32 export_table = add_table(ExportNamedSymbolTableOffset, export_num, 8);
+    // A single leaf, the left child of the root, points to the only export
+    const u32 export_tree = add_table(ExportTreeTableOffset, export_num, 8);
+    add_table(ExportIndexedSymbolTableOffset, 0, 4);
+    const u32 export_strings = add_table(ExportStringsOffset,
+                                         static_cast<u32>(info.export_name.size() + export_num), 1);
+    if (export_num != 0) {
+        write32(export_table, export_strings);
+        write32(export_table + 4, info.export_position);
+        write32(export_tree, 0x80000000);
+        write32(export_tree + 4, 0x00008000);
+        write_string(export_strings, info.export_name);
+    }
+
+    const u32 import_num = static_cast<u32>(info.imports.size());
+    u32 import_strings_size = 0;
+    for (const auto& [name, target] : info.imports) {
+        import_strings_size += static_cast<u32>(name.size() + 1);
+    }
+    add_table(ImportModuleTableOffset, 0, 20);
+    const u32 relocation_table = add_table(ExternalRelocationTableOffset, import_num, 12);
+    const u32 import_table = add_table(ImportNamedSymbolTableOffset, import_num, 8);
+    add_table(ImportIndexedSymbolTableOffset, 0, 8);
+    add_table(ImportAnonymousSymbolTableOffset, 0, 8);
+    u32 import_string = add_table(ImportStringsOffset, import_strings_size, 1);
+    for (u32 i = 0; i < import_num; ++i) {
+        const auto& [name, target] = info.imports[i];
+        // An absolute address relocation ending its batch
+        write32(relocation_table + i * 12, target);
+        write32(relocation_table + i * 12 + 4, 0x00000102);
+        write32(import_table + i * 8, import_string);
+        write32(import_table + i * 8 + 4, relocation_table + i * 12);
+        write_string(import_string, name);
+        import_string += static_cast<u32>(name.size() + 1);
+    }
+
+    add_table(StaticAnonymousSymbolTableOffset, 0, 8);
+    add_table(InternalRelocationTableOffset, 0, 12);
+    add_table(StaticRelocationTableOffset, 0, 12);
+    REQUIRE(offset <= DataOffset);
+    write_field(DataOffsetField, DataOffset);
+    write_field(static_cast<HeaderField>(DataOffsetField + 1), DataSize);
+
+    return file;
+}
+
+/// Process image region of a process that the modules in this file are loaded into
+class ModuleMemory {
+public:
+    ModuleMemory() : kernel(memory, timing, [] {}, 0, 1, 0) {
+        process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+        MemoryRef block{backing};
+        process->vm_manager.MapBackingMemory(CRSAddress, block, block.GetSize(),
+                                             Kernel::MemoryState::Private);
+        kernel.SetCurrentProcess(process);
+    }
+
+    void Write(VAddr address, const std::vector<u8>& data) {
+        std::memcpy(backing->GetPtr() + (address - CRSAddress), data.data(), data.size());
+    }
+
+    u32 Read32(VAddr address) {
+        return memory.Read32(address);
+    }
+
+    CROHelper GetModule(VAddr address) {
+        return CROHelper(address, *process, memory, Core::System::GetInstance(), symbol_cache);
+    }
+
+private:
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel;
+    std::shared_ptr<BufferMem> backing = std::make_shared<BufferMem>(MemorySize);
+    std::shared_ptr<Kernel::Process> process;
+    Service::LDR::CROSymbolCache symbol_cache;
+};
+
+/// Loads a CRO the way LoadCRO does
+void LoadCRO(CROHelper& cro, VAddr data_buffer_address, bool link_on_load_bug_fix,
+             u32 fix_level = 0) {
+    REQUIRE(cro.Rebase(CRSAddress, ModuleSize, data_buffer_address, DataSize, 0, 0, false)
+                .IsSuccess());
+    REQUIRE(cro.Link(CRSAddress, link_on_load_bug_fix).IsSuccess());
+    cro.Register(CRSAddress, true);
+    cro.Fix(fix_level);
+}
+
+/// Unloads a CRO the way UnloadCRO does
+void UnloadCRO(CROHelper& cro) {
+    cro.Unregister(CRSAddress);
+    REQUIRE(cro.Unlink(CRSAddress).IsSuccess());
+    if (!cro.IsFixed()) {
+        REQUIRE(cro.ClearRelocations().IsSuccess());
+    }
+    cro.Unrebase(false);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("CROHelper resolves named symbols", "[core][ldr_ro]") {
+    ModuleMemory memory;
+
+    const ModuleInfo crs_info{
+        "static", "static_symbol", SegmentTag(CodeSegment, 0x10),
+        {{"missing_symbol", SegmentTag(CodeSegment, 0x20)}},
+    };
+    // Exports from its .data segment, and imports to it
+    const ModuleInfo cro_info{
+        "cro",
+        "cro_data",
+        SegmentTag(DataSegment, 0x4),
+        {{"static_symbol", SegmentTag(DataSegment, 0)}, {"other_code", SegmentTag(CodeSegment, 8)}},
+    };
+    const ModuleInfo other_info{
+        "other",
+        "other_code",
+        SegmentTag(CodeSegment, 0x10),
+        {{"cro_data", SegmentTag(DataSegment, 0)}, {"static_symbol", SegmentTag(CodeSegment, 8)}},
+    };
+
+    const VAddr static_symbol = CRSAddress + CodeOffset + 0x10;
+    const VAddr cro_unresolved = CROAddress + CodeOffset;
+    const VAddr other_unresolved = OtherCROAddress + CodeOffset;
+    const VAddr other_code = OtherCROAddress + CodeOffset + 0x10;
+
+    memory.Write(CRSAddress, BuildModule(crs_info, CRSAddress));
+    CROHelper crs = memory.GetModule(CRSAddress);
+    crs.InitCRS();
+    REQUIRE(crs.Rebase(0, ModuleSize, 0, 0, 0, 0, true).IsSuccess());
+
+    memory.Write(CROAddress, BuildModule(cro_info));
+    CROHelper cro = memory.GetModule(CROAddress);
+    LoadCRO(cro, DataBufferAddress, true);
+    // Imports to .data are applied to the .data of the file when linking on load
+    REQUIRE(memory.Read32(CROAddress + DataOffset) == static_symbol);
+    REQUIRE(memory.Read32(DataBufferAddress) == cro_unresolved);
+    REQUIRE(memory.Read32(CROAddress + CodeOffset + 8) == cro_unresolved);
+
+    memory.Write(OtherCROAddress, BuildModule(other_info));
+    CROHelper other = memory.GetModule(OtherCROAddress);
+    LoadCRO(other, OtherDataBufferAddress, false);
+    // The .data of the first module is at its buffer once it is loaded
+    REQUIRE(memory.Read32(OtherDataBufferAddress) == DataBufferAddress + 0x4);
+    REQUIRE(memory.Read32(OtherCROAddress + CodeOffset + 8) == static_symbol);
+    // Loading a module exports its symbols to the modules loaded before
+    REQUIRE(memory.Read32(CROAddress + CodeOffset + 8) == other_code);
+
+    UnloadCRO(other);
+    REQUIRE(memory.Read32(CROAddress + CodeOffset + 8) == cro_unresolved);
+
+    SECTION("symbols of a module loaded at the address of an unloaded one") {
+        UnloadCRO(cro);
+        ModuleInfo moved_info = cro_info;
+        moved_info.name = "moved";
+        moved_info.export_position = SegmentTag(CodeSegment, 0x30);
+        memory.Write(CROAddress, BuildModule(moved_info));
+        LoadCRO(cro, DataBufferAddress, false);
+
+        memory.Write(OtherCROAddress, BuildModule(other_info));
+        LoadCRO(other, OtherDataBufferAddress, true);
+        REQUIRE(memory.Read32(OtherCROAddress + DataOffset) == CROAddress + CodeOffset + 0x30);
+        REQUIRE(memory.Read32(CROAddress + CodeOffset + 8) == other_code);
+    }
+
+    SECTION("symbols of a fixed module") {
+        // Fixing at level 3 drops the symbol tables of the module
+        UnloadCRO(cro);
+        memory.Write(CROAddress, BuildModule(cro_info));
+        LoadCRO(cro, DataBufferAddress, false, 3);
+        REQUIRE(cro.IsFixed());
+
+        memory.Write(OtherCROAddress, BuildModule(other_info));
+        LoadCRO(other, OtherDataBufferAddress, false);
+        REQUIRE(memory.Read32(OtherDataBufferAddress) == other_unresolved);
+        REQUIRE(memory.Read32(CROAddress + CodeOffset + 8) == cro_unresolved);
+
+        UnloadCRO(other);
+        UnloadCRO(cro);
+    }
+}
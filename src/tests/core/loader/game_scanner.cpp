@@ -0,0 +1,107 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "core/loader/game_scanner.h"
+#include "tests/common/temporary_directory.h"
+
+namespace Loader {
+
+namespace {
+
+void WriteFile(const std::string& path, std::vector<u8> contents) {
+    FileUtil::IOFile file(path, "wb");
+    REQUIRE(file.WriteBytes(contents.data(), contents.size()) == contents.size());
+}
+
+/// Overwrites a file with contents of the same size, keeping its modification time
+void RewriteFileKeepingTime(const std::string& path, std::vector<u8> contents) {
+    const auto modification_time = std::filesystem::last_write_time(path);
+    WriteFile(path, std::move(contents));
+    std::filesystem::last_write_time(path, modification_time);
+}
+
+/// Minimal ELF file, which is enough to be listed as a game
+std::vector<u8> MakeElf(std::size_t size) {
+    std::vector<u8> contents(size);
+    contents[0] = 0x7F;
+    contents[1] = 'E';
+    contents[2] = 'L';
+    contents[3] = 'F';
+    return contents;
+}
+
+std::vector<GameEntry> ScanGames(const std::string& cache_path,
+                                 const std::vector<std::string>& paths) {
+    std::vector<GameEntry> games;
+    GameScanner scanner(cache_path, 2);
+    scanner.Scan(paths, [&games](const GameEntry& entry) { games.push_back(entry); });
+    scanner.SaveCache();
+    return games;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GameScanner", "[core][loader]") {
+    const Tests::TemporaryDirectory directory("game_scanner");
+    const std::string& root = directory.GetPath();
+
+    const std::string cache_path = root + "cache/game_list.bin";
+    std::vector<std::string> paths;
+    for (int i = 0; i < 8; ++i) {
+        paths.push_back(root + "game" + std::to_string(i) + ".elf");
+        WriteFile(paths.back(), MakeElf(0x40 + i));
+        paths.push_back(root + "other" + std::to_string(i) + ".3ds");
+        WriteFile(paths.back(), std::vector<u8>(0x40, static_cast<u8>(i)));
+    }
+    // Files modified in the second they are scanned in are never served from the cache
+    for (const auto& path : paths) {
+        std::filesystem::last_write_time(
+            path, std::filesystem::last_write_time(path) - std::chrono::hours(1));
+    }
+
+    SECTION("games are reported in order") {
+        const auto games = ScanGames("", paths);
+        REQUIRE(games.size() == 8);
+        for (std::size_t i = 0; i < games.size(); ++i) {
+            REQUIRE(games[i].path == paths[i * 2]);
+            REQUIRE(games[i].size == 0x40 + i);
+            REQUIRE(games[i].file_type == FileType::ELF);
+        }
+    }
+
+    SECTION("cached entries are reused until the file changes") {
+        const auto games = ScanGames(cache_path, paths);
+        REQUIRE(FileUtil::Exists(cache_path));
+
+        // The files are not opened again, so a game that is no longer an ELF file is still listed
+        RewriteFileKeepingTime(paths[0], std::vector<u8>(0x40));
+        const auto cached_games = ScanGames(cache_path, paths);
+        REQUIRE(cached_games.size() == games.size());
+        for (std::size_t i = 0; i < games.size(); ++i) {
+            REQUIRE(cached_games[i].path == games[i].path);
+            REQUIRE(cached_games[i].modification_time == games[i].modification_time);
+            REQUIRE(cached_games[i].file_type == games[i].file_type);
+        }
+
+        // A game overwritten with a file of another size is read again
+        WriteFile(paths[2], std::vector<u8>(0x80));
+        REQUIRE(ScanGames(cache_path, paths).size() == 7);
+    }
+
+    SECTION("files modified in the second they are scanned in are read again") {
+        // Whether or not the second changes in between, the file is not served from the cache
+        WriteFile(paths[0], MakeElf(0x40));
+        REQUIRE(ScanGames(cache_path, paths).size() == 8);
+        WriteFile(paths[0], std::vector<u8>(0x40));
+        REQUIRE(ScanGames(cache_path, paths).size() == 7);
+    }
+}
+
+} // namespace Loader
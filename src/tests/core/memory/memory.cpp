@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <vector>
 #include <catch2/catch.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -55,3 +57,98 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
         CHECK(Memory::IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("Memory::MemorySystem block operations", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    // Map the second heap page in front of the first one on the host side, so that the block
+    // operations have to split the range even though the pages are mapped back to back.
+    constexpr u32 size = Memory::PAGE_SIZE * 4;
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR, memory.GetFCRAMRef(Memory::PAGE_SIZE),
+                                  Memory::PAGE_SIZE, Kernel::MemoryState::Private)
+                .Succeeded());
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR + Memory::PAGE_SIZE, memory.GetFCRAMRef(0),
+                                  Memory::PAGE_SIZE, Kernel::MemoryState::Private)
+                .Succeeded());
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR + Memory::PAGE_SIZE * 2,
+                                  memory.GetFCRAMRef(Memory::PAGE_SIZE * 2), Memory::PAGE_SIZE * 2,
+                                  Kernel::MemoryState::Private)
+                .Succeeded());
+
+    std::vector<u8> pattern(size);
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<u8>(i * 7 + i / Memory::PAGE_SIZE);
+    }
+
+    SECTION("WriteBlock and ReadBlock round trip across discontiguous pages") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR + 3, pattern.data(), size - 3);
+        CHECK(memory.GetFCRAMPointer(Memory::PAGE_SIZE)[3] == pattern[0]);
+        CHECK(memory.GetFCRAMPointer(0)[0] == pattern[Memory::PAGE_SIZE - 3]);
+
+        std::vector<u8> result(size - 3);
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + 3, result.data(), result.size());
+        CHECK(std::equal(result.begin(), result.end(), pattern.begin()));
+    }
+
+    SECTION("ZeroBlock clears only the requested range") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR, pattern.data(), size);
+        memory.ZeroBlock(*process, Memory::HEAP_VADDR + 1, size - 2);
+
+        std::vector<u8> result(size);
+        memory.ReadBlock(*process, Memory::HEAP_VADDR, result.data(), result.size());
+        CHECK(result.front() == pattern.front());
+        CHECK(result.back() == pattern.back());
+        CHECK(std::all_of(result.begin() + 1, result.end() - 1, [](u8 b) { return b == 0; }));
+    }
+
+    SECTION("CopyBlock copies across discontiguous pages") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR, pattern.data(), Memory::PAGE_SIZE * 2);
+        memory.CopyBlock(*process, Memory::HEAP_VADDR + Memory::PAGE_SIZE * 2, Memory::HEAP_VADDR,
+                         Memory::PAGE_SIZE * 2);
+
+        std::vector<u8> result(Memory::PAGE_SIZE * 2);
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + Memory::PAGE_SIZE * 2, result.data(),
+                         result.size());
+        CHECK(std::equal(result.begin(), result.end(), pattern.begin()));
+    }
+}
+
+TEST_CASE("Memory::MemorySystem block operation throughput", "[.benchmark][core][memory]") {
+    Core::Timing timing(1, 100);
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, 0, 1, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    constexpr u32 size = 0x100000;
+    REQUIRE(process->vm_manager
+                .MapBackingMemory(Memory::HEAP_VADDR, memory.GetFCRAMRef(0), size,
+                                  Kernel::MemoryState::Private)
+                .Succeeded());
+
+    std::vector<u8> buffer(size);
+
+    BENCHMARK("ReadBlock 1MiB") {
+        memory.ReadBlock(*process, Memory::HEAP_VADDR, buffer.data(), buffer.size());
+        return buffer[0];
+    };
+
+    BENCHMARK("WriteBlock 1MiB") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR, buffer.data(), buffer.size());
+    };
+
+    BENCHMARK("ZeroBlock 1MiB") {
+        memory.ZeroBlock(*process, Memory::HEAP_VADDR, size);
+    };
+
+    BENCHMARK("CopyBlock 512KiB") {
+        memory.CopyBlock(*process, Memory::HEAP_VADDR + size / 2, Memory::HEAP_VADDR, size / 2);
+    };
+}
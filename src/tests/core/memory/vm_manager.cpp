@@ -138,3 +138,87 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         REQUIRE(code == RESULT_SUCCESS);
     }
 }
+
+TEST_CASE("Memory Splitting", "[kernel][memory]") {
+    constexpr u32 num_pages = 8;
+    auto mem = std::make_shared<BufferMem>(Memory::PAGE_SIZE * num_pages);
+    MemoryRef block{mem};
+    Memory::MemorySystem memory;
+    // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+    auto manager = std::make_unique<Kernel::VMManager>(memory);
+    auto result = manager->MapBackingMemory(Memory::HEAP_VADDR, block, block.GetSize(),
+                                            Kernel::MemoryState::Private);
+    REQUIRE(result.Code() == RESULT_SUCCESS);
+    const std::size_t num_vmas = manager->vma_map.size();
+
+    // Protects every other page, then restores them in the reverse order
+    for (u32 page = 1; page < num_pages; page += 2) {
+        ResultCode code = manager->ReprotectRange(Memory::HEAP_VADDR + page * Memory::PAGE_SIZE,
+                                                  Memory::PAGE_SIZE, Kernel::VMAPermission::Read);
+        REQUIRE(code == RESULT_SUCCESS);
+    }
+    CHECK(manager->vma_map.size() == num_vmas + num_pages - 1);
+
+    for (u32 page = 0; page < num_pages; ++page) {
+        const VAddr address = Memory::HEAP_VADDR + page * Memory::PAGE_SIZE;
+        auto vma = manager->FindVMA(address + 4);
+        CHECK(vma->second.base == address);
+        CHECK(vma->second.size == Memory::PAGE_SIZE);
+        CHECK(vma->second.backing_memory.GetPtr() == block.GetPtr() + page * Memory::PAGE_SIZE);
+        CHECK(vma->second.permissions ==
+              (page % 2 ? Kernel::VMAPermission::Read : Kernel::VMAPermission::ReadWrite));
+    }
+
+    for (u32 i = 0; i < num_pages / 2; ++i) {
+        const u32 page = num_pages - 1 - i * 2;
+        ResultCode code =
+            manager->ReprotectRange(Memory::HEAP_VADDR + page * Memory::PAGE_SIZE,
+                                    Memory::PAGE_SIZE, Kernel::VMAPermission::ReadWrite);
+        REQUIRE(code == RESULT_SUCCESS);
+    }
+    CHECK(manager->vma_map.size() == num_vmas);
+
+    auto vma = manager->FindVMA(Memory::HEAP_VADDR + block.GetSize() - 4);
+    CHECK(vma->second.base == Memory::HEAP_VADDR);
+    CHECK(vma->second.size == block.GetSize());
+
+    ResultCode code = manager->UnmapRange(Memory::HEAP_VADDR, block.GetSize());
+    REQUIRE(code == RESULT_SUCCESS);
+    CHECK(manager->vma_map.size() == 1);
+}
+
+TEST_CASE("VMManager", "[.benchmark]") {
+    // A heap carved in many small mappings, like the ones of titles with their own allocator
+    constexpr u32 num_blocks = 64;
+    constexpr u32 block_size = Memory::PAGE_SIZE * 4;
+    auto mem = std::make_shared<BufferMem>(block_size * num_blocks);
+    MemoryRef block{mem};
+    Memory::MemorySystem memory;
+    auto manager = std::make_unique<Kernel::VMManager>(memory);
+
+    BENCHMARK("Map, reprotect and unmap") {
+        for (u32 i = 0; i < num_blocks; ++i) {
+            manager->MapBackingMemory(Memory::HEAP_VADDR + i * block_size, block + i * block_size,
+                                      block_size, Kernel::MemoryState::Private);
+            manager->ReprotectRange(Memory::HEAP_VADDR + i * block_size, Memory::PAGE_SIZE,
+                                    Kernel::VMAPermission::Read);
+        }
+        return manager->UnmapRange(Memory::HEAP_VADDR, block_size * num_blocks);
+    };
+
+    for (u32 i = 0; i < num_blocks; ++i) {
+        manager->MapBackingMemory(Memory::HEAP_VADDR + i * block_size, block + i * block_size,
+                                  block_size, Kernel::MemoryState::Private);
+        manager->ReprotectRange(Memory::HEAP_VADDR + i * block_size, Memory::PAGE_SIZE,
+                                Kernel::VMAPermission::Read);
+    }
+
+    BENCHMARK("FindVMA") {
+        u32 total = 0;
+        for (VAddr address = Memory::HEAP_VADDR; address < Memory::HEAP_VADDR + mem->GetSize();
+             address += 0x100) {
+            total += manager->FindVMA(address)->second.size;
+        }
+        return total;
+    };
+}
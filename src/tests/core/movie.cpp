@@ -0,0 +1,277 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/scope_exit.h"
+#include "core/hle/service/hid/hid.h"
+#include "core/movie.h"
+#include "tests/common/temporary_directory.h"
+
+namespace Core {
+
+namespace {
+
+/// Input of the given frame, which differs from the input of the neighbouring frames
+struct FrameInput {
+    explicit FrameInput(u64 frame, s16 offset = 0)
+        : circle_pad_x(static_cast<s16>(frame * 10 + offset)),
+          circle_pad_y(static_cast<s16>(-static_cast<s16>(frame))) {
+        pad_state.a.Assign(static_cast<u32>(frame & 1));
+        pad_state.up.Assign(static_cast<u32>((frame >> 1) & 1));
+        touch.x = static_cast<u16>(frame + 100);
+        touch.y = static_cast<u16>(offset);
+        touch.valid.Assign(1);
+    }
+
+    Service::HID::PadState pad_state;
+    s16 circle_pad_x;
+    s16 circle_pad_y;
+    Service::HID::TouchDataEntry touch{};
+};
+
+/// Records a frame, after handling keyframe requests as the emulation thread does between slices
+void RecordFrame(Movie& movie, FrameInput input) {
+    movie.HandleKeyframeRequests();
+    movie.HandlePadAndCircleStatus(input.pad_state, input.circle_pad_x, input.circle_pad_y);
+    movie.HandleTouchStatus(input.touch);
+}
+
+/// Plays back a frame and checks that it matches the expected input
+void CheckFrame(Movie& movie, const FrameInput& expected) {
+    movie.HandleKeyframeRequests();
+
+    Service::HID::PadState pad_state;
+    s16 circle_pad_x = 0;
+    s16 circle_pad_y = 0;
+    movie.HandlePadAndCircleStatus(pad_state, circle_pad_x, circle_pad_y);
+    CHECK(pad_state.hex == expected.pad_state.hex);
+    CHECK(circle_pad_x == expected.circle_pad_x);
+    CHECK(circle_pad_y == expected.circle_pad_y);
+
+    Service::HID::TouchDataEntry touch{};
+    movie.HandleTouchStatus(touch);
+    CHECK(touch.x == expected.touch.x);
+    CHECK(touch.y == expected.touch.y);
+    CHECK(touch.valid.Value() == expected.touch.valid.Value());
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Movie plays back recorded input", "[core]") {
+    const Tests::TemporaryDirectory directory("movie");
+    const std::string path = directory.GetPath() + "recorded.ctm";
+    auto& movie = Movie::GetInstance();
+
+    constexpr u64 num_frames = 50;
+    movie.StartRecording(path);
+    REQUIRE(movie.IsRecordingInput());
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        RecordFrame(movie, FrameInput(frame));
+    }
+    CHECK(movie.GetFrameCount() == num_frames);
+    movie.Shutdown();
+    REQUIRE(FileUtil::Exists(path));
+
+    bool completed = false;
+    movie.StartPlayback(path, [&completed] { completed = true; });
+    REQUIRE(movie.IsPlayingInput());
+    CHECK(movie.GetFrameCount() == num_frames);
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        CHECK(movie.GetCurrentFrame() == frame);
+        CheckFrame(movie, FrameInput(frame));
+    }
+    CHECK(completed);
+    CHECK(!movie.IsPlayingInput());
+    movie.Shutdown();
+}
+
+TEST_CASE("Movie plays back version 0 files", "[core]") {
+    const Tests::TemporaryDirectory directory("movie");
+    const std::string path = directory.GetPath() + "version0.ctm";
+    auto& movie = Movie::GetInstance();
+
+    // Older movies are a header, whose version field is still zero, followed by raw input records
+    std::vector<u8> contents(256);
+    contents[0] = 'C';
+    contents[1] = 'T';
+    contents[2] = 'M';
+    contents[3] = 0x1B;
+    constexpr u64 num_frames = 3;
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        const FrameInput input(frame);
+        const u16 buttons = static_cast<u16>(input.pad_state.hex);
+        const std::array<u8, 7> pad_record{
+            0, // PadAndCircle
+            static_cast<u8>(buttons),
+            static_cast<u8>(buttons >> 8),
+            static_cast<u8>(input.circle_pad_x),
+            static_cast<u8>(input.circle_pad_x >> 8),
+            static_cast<u8>(input.circle_pad_y),
+            static_cast<u8>(input.circle_pad_y >> 8),
+        };
+        const std::array<u8, 7> touch_record{
+            1, // Touch
+            static_cast<u8>(input.touch.x),
+            static_cast<u8>(input.touch.x >> 8),
+            static_cast<u8>(input.touch.y),
+            static_cast<u8>(input.touch.y >> 8),
+            1, // Valid
+            0,
+        };
+        contents.insert(contents.end(), pad_record.begin(), pad_record.end());
+        contents.insert(contents.end(), touch_record.begin(), touch_record.end());
+    }
+    {
+        FileUtil::IOFile file(path, "wb");
+        REQUIRE(file.WriteBytes(contents.data(), contents.size()) == contents.size());
+    }
+
+    movie.StartPlayback(path);
+    REQUIRE(movie.IsPlayingInput());
+    CHECK(movie.GetFrameCount() == num_frames);
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        CheckFrame(movie, FrameInput(frame));
+    }
+    CHECK(!movie.IsPlayingInput());
+    movie.Shutdown();
+}
+
+TEST_CASE("Movie seeks to keyframes", "[core]") {
+    const Tests::TemporaryDirectory directory("movie");
+    const std::string path = directory.GetPath() + "keyframes.ctm";
+    auto& movie = Movie::GetInstance();
+
+    // Keyframes are taken at frames 0, 4, 8, ...
+    constexpr u32 keyframe_interval = 4;
+    constexpr u64 num_frames = 20;
+    movie.StartRecording(path, keyframe_interval);
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        RecordFrame(movie, FrameInput(frame));
+    }
+
+    SECTION("while playing") {
+        movie.Shutdown();
+        movie.StartPlayback(path);
+        REQUIRE(movie.IsPlayingInput());
+        for (u64 frame = 0; frame < 15; ++frame) {
+            CheckFrame(movie, FrameInput(frame));
+        }
+
+        // Seeking backwards continues from the last keyframe at or before the frame, and plays
+        // the movie up to the frame
+        bool paused = false;
+        movie.SeekToFrame(10, [&paused] { paused = true; });
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == 8);
+        for (u64 frame = 8; frame < 10; ++frame) {
+            CheckFrame(movie, FrameInput(frame));
+        }
+        CHECK(!paused);
+        CheckFrame(movie, FrameInput(10));
+        CHECK(paused);
+
+        // Seeking to a keyframe pauses there right away
+        paused = false;
+        movie.SeekToFrame(12, [&paused] { paused = true; });
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == 12);
+        CHECK(paused);
+
+        // As does seeking forwards
+        paused = false;
+        movie.SeekToFrame(17, [&paused] { paused = true; });
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == 16);
+        CheckFrame(movie, FrameInput(16));
+        CHECK(!paused);
+        for (u64 frame = 17; frame < num_frames; ++frame) {
+            CheckFrame(movie, FrameInput(frame));
+        }
+        CHECK(paused);
+        CHECK(!movie.IsPlayingInput());
+    }
+
+    SECTION("while recording") {
+        // The input recorded after the keyframe is played up to the frame, and recorded again
+        // after it
+        bool paused = false;
+        movie.SeekToFrame(6, [&paused] { paused = true; });
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == 4);
+        for (u64 frame = 4; frame < 6; ++frame) {
+            CheckFrame(movie, FrameInput(frame));
+        }
+        CHECK(!paused);
+        for (u64 frame = 6; frame < 10; ++frame) {
+            RecordFrame(movie, FrameInput(frame, 1));
+        }
+        CHECK(paused);
+        CHECK(movie.GetFrameCount() == 10);
+        movie.Shutdown();
+
+        movie.StartPlayback(path);
+        REQUIRE(movie.IsPlayingInput());
+        CHECK(movie.GetFrameCount() == 10);
+        for (u64 frame = 0; frame < 10; ++frame) {
+            CheckFrame(movie, FrameInput(frame, frame < 6 ? 0 : 1));
+        }
+
+        // The keyframe at frame 8 was recorded again along with the input
+        movie.StartPlayback(path);
+        movie.SeekToFrame(9);
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == 8);
+        CheckFrame(movie, FrameInput(8, 1));
+    }
+
+    movie.Shutdown();
+}
+
+TEST_CASE("Movie restores the state of keyframes", "[core]") {
+    const Tests::TemporaryDirectory directory("movie");
+    const std::string path = directory.GetPath() + "states.ctm";
+    auto& movie = Movie::GetInstance();
+
+    // Stands in for the emulated system, whose state is the frame it is at. The states have
+    // different sizes, so each is read from its own place in the file.
+    u64 emulated_frame = 0;
+    movie.SetKeyframeStateHandlers(
+        [&emulated_frame] {
+            return std::vector<u8>(16 + emulated_frame, static_cast<u8>(emulated_frame));
+        },
+        [&emulated_frame](const std::vector<u8>& state) {
+            REQUIRE(state.size() >= 16);
+            emulated_frame = state.size() - 16;
+            CHECK(std::all_of(state.begin(), state.end(), [&emulated_frame](u8 value) {
+                return value == static_cast<u8>(emulated_frame);
+            }));
+        });
+    SCOPE_EXIT({ movie.SetKeyframeStateHandlers(nullptr, nullptr); });
+
+    constexpr u64 num_frames = 20;
+    movie.StartRecording(path, 4);
+    for (u64 frame = 0; frame < num_frames; ++frame) {
+        emulated_frame = frame;
+        RecordFrame(movie, FrameInput(frame));
+    }
+    movie.Shutdown();
+
+    movie.StartPlayback(path);
+    REQUIRE(movie.IsPlayingInput());
+    for (const u64 frame : {13, 5, 19, 0}) {
+        emulated_frame = num_frames;
+        movie.SeekToFrame(frame);
+        movie.HandleKeyframeRequests();
+        CHECK(movie.GetCurrentFrame() == frame / 4 * 4);
+        CHECK(emulated_frame == frame / 4 * 4);
+    }
+    movie.Shutdown();
+}
+
+} // namespace Core
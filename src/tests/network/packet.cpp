@@ -0,0 +1,124 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "network/packet.h"
+
+namespace {
+
+/// Writes a packet laid out like the local wireless frames relayed by rooms
+void WriteWifiPacket(Network::Packet& packet, const std::vector<u8>& frame) {
+    const std::array<u8, 6> transmitter_address{0x00, 0x1F, 0x32, 0x01, 0x02, 0x03};
+    const std::array<u8, 6> destination_address{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    packet << static_cast<u8>(7);
+    packet << static_cast<u8>(1);
+    packet << static_cast<u8>(11);
+    packet << transmitter_address;
+    packet << destination_address;
+    packet << frame;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Network::Packet round trip", "[network]") {
+    const std::vector<u8> bytes{0x00, 0x7F, 0x80, 0xFF};
+    const std::vector<u16> halves{0x1234, 0xABCD};
+    const std::array<u8, 3> byte_array{1, 2, 3};
+    const std::array<u32, 2> word_array{0xDEADBEEF, 0x01020304};
+
+    Network::Packet packet;
+    packet << bytes << halves << byte_array << word_array << std::string("citra")
+           << static_cast<u64>(0x0123456789ABCDEF);
+
+    Network::Packet read_packet;
+    read_packet.Append(packet.GetData(), packet.GetDataSize());
+
+    std::vector<u8> read_bytes;
+    std::vector<u16> read_halves;
+    std::array<u8, 3> read_byte_array;
+    std::array<u32, 2> read_word_array;
+    std::string read_string;
+    u64 read_u64;
+    read_packet >> read_bytes >> read_halves >> read_byte_array >> read_word_array >>
+        read_string >> read_u64;
+
+    REQUIRE(read_packet);
+    REQUIRE(read_packet.EndOfPacket());
+    REQUIRE(read_bytes == bytes);
+    REQUIRE(read_halves == halves);
+    REQUIRE(read_byte_array == byte_array);
+    REQUIRE(read_word_array == word_array);
+    REQUIRE(read_string == "citra");
+    REQUIRE(read_u64 == 0x0123456789ABCDEF);
+}
+
+TEST_CASE("Network::Packet byte vectors are stored in network byte order", "[network]") {
+    Network::Packet packet;
+    packet << std::vector<u8>{0xAA, 0xBB};
+
+    const auto* data = static_cast<const u8*>(packet.GetData());
+    REQUIRE(packet.GetDataSize() == 6);
+    REQUIRE(std::vector<u8>(data, data + 6) == std::vector<u8>{0, 0, 0, 2, 0xAA, 0xBB});
+}
+
+TEST_CASE("Network::Packet truncated byte vector", "[network]") {
+    Network::Packet packet;
+    packet << static_cast<u32>(1000);
+    packet << static_cast<u8>(1);
+
+    std::vector<u8> bytes{1, 2, 3};
+    packet >> bytes;
+    REQUIRE(!packet);
+    REQUIRE(bytes.empty());
+}
+
+TEST_CASE("Network::Packet reuses buffers", "[network]") {
+    std::vector<char> buffer;
+    buffer.reserve(2048);
+    buffer.push_back('x');
+    const char* const storage = buffer.data();
+
+    Network::Packet packet{std::move(buffer)};
+    REQUIRE(packet.GetDataSize() == 0);
+    WriteWifiPacket(packet, std::vector<u8>(1500));
+    REQUIRE(packet.GetData() == storage);
+
+    const std::vector<char> data = packet.TakeData();
+    REQUIRE(data.data() == storage);
+    REQUIRE(packet.GetDataSize() == 0);
+}
+
+TEST_CASE("Network::Packet throughput of wifi frames", "[.benchmark][network]") {
+    const std::vector<u8> frame(1500, 0x5A);
+    Network::Packet written_packet;
+    WriteWifiPacket(written_packet, frame);
+
+    BENCHMARK("Write a 1500 byte frame") {
+        Network::Packet packet;
+        WriteWifiPacket(packet, frame);
+        return packet.GetDataSize();
+    };
+
+    std::vector<char> buffer;
+    BENCHMARK("Write a 1500 byte frame into a reused buffer") {
+        Network::Packet packet{std::move(buffer)};
+        packet.Reserve(3 + 2 * 6 + 4 + frame.size());
+        WriteWifiPacket(packet, frame);
+        const std::size_t size = packet.GetDataSize();
+        buffer = packet.TakeData();
+        return size;
+    };
+
+    BENCHMARK("Read a 1500 byte frame") {
+        Network::Packet packet;
+        packet.Append(written_packet.GetData(), written_packet.GetDataSize());
+        packet.IgnoreBytes(3 + 2 * 6);
+        std::vector<u8> read_frame;
+        packet >> read_frame;
+        return read_frame.size();
+    };
+}
@@ -0,0 +1,101 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <enet/enet.h>
+#include "network/packet.h"
+#include "network/room.h"
+#include "network/room_member.h"
+
+namespace {
+
+constexpr u16 TestRoomPort = Network::DefaultRoomPort + 100;
+
+/// Polls condition until it holds or a few seconds passed, returning whether it held
+bool WaitFor(const std::function<bool()>& condition) {
+    for (int i = 0; i < 500; ++i) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Room forwards unreliable wifi packets", "[network]") {
+    REQUIRE(enet_initialize() == 0);
+    {
+        Network::Room room;
+        REQUIRE(room.Create("Test room", "", "127.0.0.1", TestRoomPort));
+
+        // A member receiving the forwarded packet
+        Network::RoomMember member;
+        std::mutex received_mutex;
+        std::vector<Network::WifiPacket> received;
+        auto callback = member.BindOnWifiPacketReceived([&](const Network::WifiPacket& packet) {
+            std::lock_guard lock(received_mutex);
+            received.push_back(packet);
+        });
+        member.Join("Receiver", "receiver_console", "127.0.0.1", TestRoomPort);
+        REQUIRE(WaitFor([&] { return member.GetState() == Network::RoomMember::State::Joined; }));
+
+        // A plain ENet client sending an unreliable packet, which the room frees when flushing it
+        ENetHost* client = enet_host_create(nullptr, 1, Network::NumChannels, 0, 0);
+        REQUIRE(client != nullptr);
+        ENetAddress address;
+        enet_address_set_host(&address, "127.0.0.1");
+        address.port = TestRoomPort;
+        ENetPeer* peer = enet_host_connect(client, &address, Network::NumChannels, 0);
+        REQUIRE(peer != nullptr);
+        ENetEvent event;
+        REQUIRE(enet_host_service(client, &event, 5000) > 0);
+        REQUIRE(event.type == ENET_EVENT_TYPE_CONNECT);
+
+        const std::vector<u8> frame{0x08, 0x02, 0xDE, 0xAD, 0xBE, 0xEF};
+        const Network::MacAddress transmitter_address{0x00, 0x1F, 0x32, 0x01, 0x02, 0x03};
+        Network::Packet packet;
+        packet << static_cast<u8>(Network::IdWifiPacket);
+        packet << static_cast<u8>(Network::WifiPacket::PacketType::Data);
+        packet << static_cast<u8>(1);
+        packet << transmitter_address;
+        packet << Network::BroadcastMac;
+        packet << frame;
+        for (const u32 flags : {0u, static_cast<u32>(ENET_PACKET_FLAG_UNSEQUENCED)}) {
+            enet_peer_send(peer, 0,
+                           enet_packet_create(packet.GetData(), packet.GetDataSize(), flags));
+        }
+        enet_host_flush(client);
+
+        const bool received_all = WaitFor([&] {
+            enet_host_service(client, &event, 0);
+            std::lock_guard lock(received_mutex);
+            return received.size() == 2;
+        });
+        CHECK(received_all);
+        {
+            std::lock_guard lock(received_mutex);
+            for (const auto& wifi_packet : received) {
+                CHECK(wifi_packet.transmitter_address == transmitter_address);
+                CHECK(wifi_packet.destination_address == Network::BroadcastMac);
+                CHECK(wifi_packet.data == frame);
+            }
+        }
+
+        enet_peer_disconnect_now(peer, 0);
+        enet_host_destroy(client);
+        member.Unbind(callback);
+        member.Leave();
+        room.Destroy();
+    }
+    enet_deinitialize();
+}
@@ -0,0 +1,470 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <nihstro/inline_assembly.h>
+#include "video_core/shader/shader_interpreter.h"
+#include "video_core/shader/shader_interpreter_compiler.h"
+
+using float24 = Pica::float24;
+using CompiledShader = Pica::Shader::CompiledShader;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+namespace {
+
+std::unique_ptr<CompiledShader> CompileShader(std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    std::array<u32, Pica::Shader::MAX_PROGRAM_CODE_LENGTH> program_code{};
+    std::array<u32, Pica::Shader::MAX_SWIZZLE_DATA_LENGTH> swizzle_data{};
+
+    std::transform(shbin.program.begin(), shbin.program.end(), program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(), swizzle_data.begin(),
+                   [](const auto& x) { return x.hex; });
+
+    auto shader = std::make_unique<CompiledShader>();
+    shader->Compile(&program_code, &swizzle_data);
+
+    return shader;
+}
+
+class ShaderTest {
+public:
+    explicit ShaderTest(std::initializer_list<nihstro::InlineAsm> code)
+        : shader(CompileShader(code)) {}
+
+    float Run(float input) {
+        Pica::Shader::ShaderSetup shader_setup;
+        Pica::Shader::UnitState shader_unit;
+
+        shader_unit.registers.input[0].x = float24::FromFloat32(input);
+        shader->Run(shader_setup, shader_unit, 0);
+        return shader_unit.registers.output[0].x.ToFloat32();
+    }
+
+public:
+    std::unique_ptr<CompiledShader> shader;
+};
+
+/// Which kinds of instructions a generated program may contain, besides plain arithmetic
+enum Feature : u32 {
+    MultiplyAdd = 1 << 0,
+    Compare = 1 << 1,
+    RelativeAddressing = 1 << 2,
+    FlowControl = 1 << 3,
+    AllFeatures = MultiplyAdd | Compare | RelativeAddressing | FlowControl,
+};
+
+/**
+ * Generates random programs, which are built from nested blocks so that they always terminate and
+ * only ever read registers inside the register file. Both engines are expected to leave exactly the
+ * same state behind when running them.
+ */
+class ProgramGenerator {
+public:
+    ProgramGenerator(u32 seed, u32 features) : rng(seed), features(features) {}
+
+    void Generate(Pica::Shader::ShaderSetup& setup) {
+        code.clear();
+        patches.clear();
+        subroutines.assign(features & FlowControl ? Random(MaxSubroutines + 1) : 0, {});
+
+        // The main program is followed by its subroutines, which may only call the ones after them
+        GenerateBlock(0, NoSubroutine);
+        code.push_back(static_cast<u32>(OpCode::Id::END) << 26);
+        for (u32 i = 0; i < subroutines.size(); ++i) {
+            subroutines[i].offset = static_cast<u32>(code.size());
+            GenerateBlock(MaxDepth - MaxSubroutineDepth, i);
+            subroutines[i].num_instructions = static_cast<u32>(code.size()) - subroutines[i].offset;
+        }
+        for (const auto& [address, subroutine] : patches) {
+            code[address] |= subroutines[subroutine].offset << 10 |
+                             subroutines[subroutine].num_instructions;
+        }
+
+        setup.program_code.fill(static_cast<u32>(OpCode::Id::END) << 26);
+        std::copy(code.begin(), code.end(), setup.program_code.begin());
+        for (auto& pattern : setup.swizzle_data) {
+            pattern = static_cast<u32>(rng());
+        }
+
+        // The first few float uniforms hold small integers, which MOVA loads into the address
+        // registers. This keeps relatively addressed registers within SafeUniforms.
+        for (std::size_t i = 0; i < std::size(setup.uniforms.f); ++i) {
+            for (u32 component = 0; component < 4; ++component) {
+                const float fraction = i < AddressUniforms ? 0.0f : Random(4) * 0.25f;
+                setup.uniforms.f[i][component] =
+                    float24::FromFloat32(static_cast<int>(Random(9)) - 4 + fraction);
+            }
+        }
+        for (auto& b : setup.uniforms.b) {
+            b = Random(2) != 0;
+        }
+        for (auto& i : setup.uniforms.i) {
+            i = Common::Vec4<u8>(static_cast<u8>(Random(4)), static_cast<u8>(Random(8)),
+                                 static_cast<u8>(Random(3)), 0);
+        }
+    }
+
+    void GenerateInput(Pica::Shader::UnitState& state) {
+        std::memset(&state.registers, 0, sizeof(state.registers));
+        for (auto& input : state.registers.input) {
+            for (u32 component = 0; component < 4; ++component) {
+                input[component] = float24::FromFloat32(static_cast<int>(Random(9)) - 4.0f);
+            }
+        }
+        std::fill(std::begin(state.address_registers), std::end(state.address_registers), 0);
+        std::fill(std::begin(state.conditional_code), std::end(state.conditional_code), false);
+    }
+
+private:
+    static constexpr u32 NoSubroutine = ~0u;
+    static constexpr u32 MaxSubroutines = 3;
+    // Every nested block and call takes a call stack entry. With at most three nested blocks in the
+    // main program, and a call and one nested block for each subroutine, at most 9 of the 16 call
+    // stack entries are used.
+    static constexpr u32 MaxDepth = 4;
+    static constexpr u32 MaxSubroutineDepth = 2;
+    static constexpr u32 AddressUniforms = 4;
+    // a0 and a1 are in [-4, 4]. The loop counter starts in [0, 7], and each iteration adds at most
+    // 2 to it. With at most 4 iterations of at most 6 nested loops, it stays below 40.
+    static constexpr u32 SafeUniforms = 0x20 + 8;
+    static constexpr u32 SafeUniformsEnd = 0x80 - 40;
+
+    u32 Random(u32 n) {
+        return static_cast<u32>(rng() % n);
+    }
+
+    /// Picks a 7-bit source register, which is the one relative addressing applies to
+    u32 RandomSource7(u32 address_index) {
+        if (address_index != 0) {
+            return SafeUniforms + Random(SafeUniformsEnd - SafeUniforms);
+        }
+        return Random(0x80);
+    }
+
+    /// Picks a 5-bit source register, which is always an input or temporary register
+    u32 RandomSource5() {
+        return Random(0x20);
+    }
+
+    u32 RandomAddressIndex() {
+        return features & RelativeAddressing ? Random(4) : 0;
+    }
+
+    void GenerateArithmetic() {
+        static constexpr OpCode::Id ops[] = {
+            OpCode::Id::ADD,  OpCode::Id::DP3,  OpCode::Id::DP4, OpCode::Id::DPH,
+            OpCode::Id::DPHI, OpCode::Id::EX2,  OpCode::Id::LG2, OpCode::Id::MUL,
+            OpCode::Id::SGE,  OpCode::Id::SGEI, OpCode::Id::SLT, OpCode::Id::SLTI,
+            OpCode::Id::FLR,  OpCode::Id::MAX,  OpCode::Id::MIN, OpCode::Id::RCP,
+            OpCode::Id::RSQ,  OpCode::Id::MOV,
+        };
+        const OpCode::Id op = ops[Random(std::size(ops))];
+        const u32 address_index = RandomAddressIndex();
+        const u32 source7 = RandomSource7(address_index);
+        const u32 source5 = RandomSource5();
+        u32 word = static_cast<u32>(op) << 26 | Random(0x20) << 21 | address_index << 19 |
+                   Random(0x80);
+        if (op == OpCode::Id::DPHI || op == OpCode::Id::SGEI || op == OpCode::Id::SLTI) {
+            word |= source5 << 14 | source7 << 7;
+        } else {
+            word |= source7 << 12 | source5 << 7;
+        }
+        code.push_back(word);
+    }
+
+    void GenerateMova() {
+        const u32 source = 0x20 + Random(AddressUniforms);
+        code.push_back(static_cast<u32>(OpCode::Id::MOVA) << 26 | source << 12 | Random(0x80));
+    }
+
+    void GenerateCompare() {
+        // Compare operations 6 and 7 are not valid
+        const u32 address_index = RandomAddressIndex();
+        code.push_back(static_cast<u32>(OpCode::Id::CMP) << 26 | Random(6) << 24 | Random(6) << 21 |
+                       address_index << 19 | RandomSource7(address_index) << 12 |
+                       RandomSource5() << 7 | Random(0x80));
+    }
+
+    void GenerateMultiplyAdd() {
+        const bool inverted = Random(2) != 0;
+        const u32 address_index = RandomAddressIndex();
+        const u32 source7 = RandomSource7(address_index);
+        const u32 source5 = RandomSource5();
+        const OpCode::Id op = inverted ? OpCode::Id::MADI : OpCode::Id::MAD;
+        u32 word = (static_cast<u32>(op) + Random(8)) << 26 | Random(0x20) << 24 |
+                   address_index << 22 | RandomSource5() << 17 | Random(0x20);
+        if (inverted) {
+            word |= source5 << 12 | source7 << 5;
+        } else {
+            word |= source7 << 10 | source5 << 5;
+        }
+        code.push_back(word);
+    }
+
+    /// Emits the flow control fields that compare against the conditional code or a uniform
+    u32 RandomCondition(OpCode::Id conditional, OpCode::Id uniform) {
+        if (Random(2) != 0) {
+            return static_cast<u32>(conditional) << 26 | Random(2) << 25 | Random(2) << 24 |
+                   Random(4) << 22;
+        }
+        return static_cast<u32>(uniform) << 26 | Random(16) << 22;
+    }
+
+    void GenerateIf(u32 depth, u32 subroutine) {
+        const std::size_t address = code.size();
+        code.push_back(RandomCondition(OpCode::Id::IFC, OpCode::Id::IFU));
+        GenerateBlock(depth + 1, subroutine);
+        const u32 else_address = static_cast<u32>(code.size());
+        if (Random(2) != 0) {
+            GenerateBlock(depth + 1, subroutine);
+        }
+        code[address] |= else_address << 10 | (static_cast<u32>(code.size()) - else_address);
+    }
+
+    void GenerateLoop(u32 depth, u32 subroutine) {
+        const std::size_t address = code.size();
+        code.push_back(static_cast<u32>(OpCode::Id::LOOP) << 26 | Random(4) << 22);
+        GenerateBlock(depth + 1, subroutine);
+        code[address] |= (static_cast<u32>(code.size()) - 1) << 10;
+    }
+
+    void GenerateCall(u32 subroutine) {
+        // Subroutines only call the ones after them, so that there is no recursion
+        const u32 first = subroutine == NoSubroutine ? 0 : subroutine + 1;
+        const u32 target = first + Random(static_cast<u32>(subroutines.size()) - first);
+        patches.emplace_back(code.size(), target);
+        if (Random(3) == 0) {
+            code.push_back(static_cast<u32>(OpCode::Id::CALL) << 26);
+        } else {
+            code.push_back(RandomCondition(OpCode::Id::CALLC, OpCode::Id::CALLU));
+        }
+    }
+
+    /**
+     * Emits a block of statements. Jumps stay within the block and only go forward, up to the end
+     * of the block, where the enclosing IF, LOOP or CALL takes over.
+     */
+    void GenerateBlock(u32 depth, u32 subroutine) {
+        std::vector<std::size_t> jumps;
+        const u32 num_statements = 1 + Random(depth == 0 ? 8 : 4);
+        for (u32 i = 0; i < num_statements; ++i) {
+            const bool can_nest = (features & FlowControl) && depth + 1 < MaxDepth;
+            const u32 first_callable = subroutine == NoSubroutine ? 0 : subroutine + 1;
+            const bool can_call = (features & FlowControl) && first_callable < subroutines.size();
+            switch (Random(12)) {
+            case 0:
+                if (features & MultiplyAdd) {
+                    GenerateMultiplyAdd();
+                    break;
+                }
+                [[fallthrough]];
+            case 1:
+                if (features & Compare) {
+                    GenerateCompare();
+                    break;
+                }
+                [[fallthrough]];
+            case 2:
+                if (features & RelativeAddressing) {
+                    GenerateMova();
+                    break;
+                }
+                [[fallthrough]];
+            case 3:
+                if (can_nest) {
+                    GenerateIf(depth, subroutine);
+                    break;
+                }
+                [[fallthrough]];
+            case 4:
+                if (can_nest) {
+                    GenerateLoop(depth, subroutine);
+                    break;
+                }
+                [[fallthrough]];
+            case 5:
+                if (can_call) {
+                    GenerateCall(subroutine);
+                    break;
+                }
+                [[fallthrough]];
+            case 6:
+                if (features & FlowControl) {
+                    jumps.push_back(code.size());
+                    code.push_back(RandomCondition(OpCode::Id::JMPC, OpCode::Id::JMPU) |
+                                   Random(2));
+                    break;
+                }
+                [[fallthrough]];
+            default:
+                GenerateArithmetic();
+                break;
+            }
+        }
+
+        const u32 end = static_cast<u32>(code.size());
+        for (const std::size_t address : jumps) {
+            const u32 next = static_cast<u32>(address) + 1;
+            code[address] |= (next + Random(end + 1 - next)) << 10;
+        }
+    }
+
+    struct Subroutine {
+        u32 offset = 0;
+        u32 num_instructions = 0;
+    };
+
+    std::mt19937 rng;
+    u32 features;
+    std::vector<u32> code;
+    std::vector<Subroutine> subroutines;
+    /// Addresses of calls, along with the subroutine they call
+    std::vector<std::pair<std::size_t, u32>> patches;
+};
+
+bool IsSameVector(const Common::Vec4<float24>& a, const Common::Vec4<float24>& b) {
+    for (u32 component = 0; component < 4; ++component) {
+        const float x = a[component].ToFloat32();
+        const float y = b[component].ToFloat32();
+        if (std::isnan(x) && std::isnan(y)) {
+            continue;
+        }
+        if (std::memcmp(&x, &y, sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Runs generated programs through both engines, which must leave the same state behind
+void CheckGeneratedPrograms(u32 features, u32 num_programs) {
+    // Seeding with the features keeps the programs reproducible, but different for each section
+    ProgramGenerator generator(features, features);
+    auto setup = std::make_unique<Pica::Shader::ShaderSetup>();
+    for (u32 program = 0; program < num_programs; ++program) {
+        generator.Generate(*setup);
+
+        Pica::Shader::UnitState expected;
+        generator.GenerateInput(expected);
+        Pica::Shader::UnitState actual = expected;
+
+        Pica::Shader::RunReferenceInterpreter(*setup, expected, 0);
+        CompiledShader shader;
+        shader.Compile(&setup->program_code, &setup->swizzle_data);
+        shader.Run(*setup, actual, 0);
+
+        INFO("Program " << program);
+        for (u32 i = 0; i < 16; ++i) {
+            INFO("Register " << i);
+            CHECK(IsSameVector(expected.registers.output[i], actual.registers.output[i]));
+            CHECK(IsSameVector(expected.registers.temporary[i], actual.registers.temporary[i]));
+        }
+        for (u32 i = 0; i < 3; ++i) {
+            CHECK(expected.address_registers[i] == actual.address_registers[i]);
+        }
+        CHECK(expected.conditional_code[0] == actual.conditional_code[0]);
+        CHECK(expected.conditional_code[1] == actual.conditional_code[1]);
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Interpreter LG2", "[video_core][shader][shader_interpreter]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader = ShaderTest({
+        // clang-format off
+        {OpCode::Id::LG2, sh_output, sh_input},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    REQUIRE(std::isnan(shader.Run(NAN)));
+    REQUIRE(std::isnan(shader.Run(-1.f)));
+    REQUIRE(std::isinf(shader.Run(0.f)));
+    REQUIRE(shader.Run(4.f) == Approx(2.f));
+    REQUIRE(shader.Run(64.f) == Approx(6.f));
+    REQUIRE(shader.Run(1.e24f) == Approx(79.7262742773f));
+}
+
+TEST_CASE("Interpreter EX2", "[video_core][shader][shader_interpreter]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader = ShaderTest({
+        // clang-format off
+        {OpCode::Id::EX2, sh_output, sh_input},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    REQUIRE(std::isnan(shader.Run(NAN)));
+    REQUIRE(shader.Run(-800.f) == Approx(0.f));
+    REQUIRE(shader.Run(0.f) == Approx(1.f));
+    REQUIRE(shader.Run(2.f) == Approx(4.f));
+    REQUIRE(shader.Run(6.f) == Approx(64.f));
+    REQUIRE(shader.Run(79.7262742773f) == Approx(1.e24f));
+    REQUIRE(std::isinf(shader.Run(800.f)));
+}
+
+TEST_CASE("Interpreter matches the reference interpreter",
+          "[video_core][shader][shader_interpreter]") {
+    SECTION("swizzles and negation") {
+        CheckGeneratedPrograms(0, 500);
+    }
+    SECTION("MAD and MADI") {
+        CheckGeneratedPrograms(MultiplyAdd, 500);
+    }
+    SECTION("CMP") {
+        CheckGeneratedPrograms(Compare, 500);
+    }
+    SECTION("relative addressing") {
+        CheckGeneratedPrograms(RelativeAddressing | MultiplyAdd | Compare, 500);
+    }
+    SECTION("CALL, IF, LOOP and JMP") {
+        CheckGeneratedPrograms(FlowControl | Compare, 1000);
+    }
+    SECTION("all instructions") {
+        CheckGeneratedPrograms(AllFeatures, 2000);
+    }
+}
+
+TEST_CASE("Interpreter shader", "[.benchmark]") {
+    const auto sh_input = SourceRegister::MakeInput(0);
+    const auto sh_temp = SourceRegister::MakeTemporary(0);
+    const auto sh_temp_dest = DestRegister::MakeTemporary(0);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader = ShaderTest({
+        // clang-format off
+        {OpCode::Id::MOV, sh_temp_dest, sh_input},
+        {OpCode::Id::EX2, sh_temp_dest, sh_temp},
+        {OpCode::Id::LG2, sh_temp_dest, sh_temp},
+        {OpCode::Id::RCP, sh_temp_dest, sh_temp},
+        {OpCode::Id::RSQ, sh_temp_dest, sh_temp},
+        {OpCode::Id::FLR, sh_temp_dest, sh_temp},
+        {OpCode::Id::MOV, sh_output, sh_temp},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    BENCHMARK("Run") {
+        return shader.Run(0.5f);
+    };
+}
@@ -63,7 +63,8 @@ public:
         return render_window;
     }
 
-    void RefreshRasterizerSetting();
+    /// Recreates the rasterizer if the configured rasterizer type has changed
+    virtual void RefreshRasterizerSetting();
     void Sync();
 
 protected:
@@ -0,0 +1,38 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+#include "video_core/rasterizer_interface.h"
+
+namespace Pica::Shader {
+struct OutputVertex;
+} // namespace Pica::Shader
+
+namespace VideoCore {
+
+/**
+ * Rasterizer that discards all drawing. It keeps no caches, so emulated memory is always up to
+ * date, and memory fills and display transfers fall back to the software implementations that
+ * operate directly on emulated memory.
+ */
+class NullRasterizer : public RasterizerInterface {
+    void AddTriangle(const Pica::Shader::OutputVertex& v0, const Pica::Shader::OutputVertex& v1,
+                     const Pica::Shader::OutputVertex& v2) override {}
+    void DrawTriangles() override {}
+    void NotifyPicaRegisterChanged(u32 id) override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr addr, u32 size) override {}
+    void InvalidateRegion(PAddr addr, u32 size) override {}
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
+    void ClearAll(bool flush) override {}
+
+    /// Claims the batch so that vertices are not shaded only to be discarded
+    bool AccelerateDrawBatch(bool is_indexed) override {
+        return true;
+    }
+};
+
+} // namespace VideoCore
@@ -0,0 +1,165 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <thread>
+#include "common/color.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/dumping/backend.h"
+#include "core/frontend/emu_window.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
+#include "core/tracer/recorder.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/renderer_null/null_rasterizer.h"
+#include "video_core/renderer_null/renderer_null.h"
+#include "video_core/swrasterizer/swrasterizer.h"
+#include "video_core/video_core.h"
+
+namespace VideoCore {
+
+namespace {
+
+Common::Vec4<u8> DecodePixel(GPU::Regs::PixelFormat format, const u8* pixel) {
+    switch (format) {
+    case GPU::Regs::PixelFormat::RGBA8:
+        return Color::DecodeRGBA8(pixel);
+    case GPU::Regs::PixelFormat::RGB8:
+        return Color::DecodeRGB8(pixel);
+    case GPU::Regs::PixelFormat::RGB565:
+        return Color::DecodeRGB565(pixel);
+    case GPU::Regs::PixelFormat::RGB5A1:
+        return Color::DecodeRGB5A1(pixel);
+    case GPU::Regs::PixelFormat::RGBA4:
+        return Color::DecodeRGBA4(pixel);
+    }
+    return {0, 0, 0, 255};
+}
+
+/**
+ * Draws the left eye image of a framebuffer into a BGRA frame, nearest-scaled to fill the given
+ * rectangle. Framebuffers are stored rotated by 90 degrees, so rows in memory are screen columns.
+ */
+void DrawScreen(const GPU::Regs::FramebufferConfig& framebuffer,
+                const Common::Rectangle<u32>& rect, bool is_rotated,
+                VideoDumper::VideoFrame& frame) {
+    const u32 width = rect.GetWidth();
+    const u32 height = rect.GetHeight();
+    const u32 fb_width = framebuffer.width;
+    const u32 fb_height = framebuffer.height;
+    if (width == 0 || height == 0 || fb_width == 0 || fb_height == 0 ||
+        rect.right > frame.width || rect.bottom > frame.height) {
+        return;
+    }
+
+    const PAddr address =
+        framebuffer.active_fb == 0 ? framebuffer.address_left1 : framebuffer.address_left2;
+    Memory::RasterizerFlushRegion(address, framebuffer.stride * fb_height);
+    const u8* data = VideoCore::g_memory->GetPhysicalPointer(address);
+    if (data == nullptr) {
+        return;
+    }
+
+    const GPU::Regs::PixelFormat format = framebuffer.color_format;
+    const u32 bpp = GPU::Regs::BytesPerPixel(format);
+    for (u32 y = 0; y < height; ++y) {
+        u8* out = &frame.data[(rect.top + y) * frame.stride + rect.left * 4];
+        for (u32 x = 0; x < width; ++x) {
+            // Same mapping as the texture coordinates of the OpenGL renderer
+            u32 fb_x, fb_y;
+            if (is_rotated) {
+                fb_x = fb_width - 1 - y * fb_width / height;
+                fb_y = x * fb_height / width;
+            } else {
+                fb_x = fb_width - 1 - x * fb_width / width;
+                fb_y = fb_height - 1 - y * fb_height / height;
+            }
+            const auto color = DecodePixel(format, data + fb_y * framebuffer.stride + fb_x * bpp);
+            out[x * 4 + 0] = color.b();
+            out[x * 4 + 1] = color.g();
+            out[x * 4 + 2] = color.r();
+            out[x * 4 + 3] = 255;
+        }
+    }
+}
+
+} // Anonymous namespace
+
+RendererNull::RendererNull(Frontend::EmuWindow& window) : RendererBase{window} {}
+RendererNull::~RendererNull() = default;
+
+ResultStatus RendererNull::Init() {
+    RefreshRasterizerSetting();
+    return ResultStatus::Success;
+}
+
+void RendererNull::ShutDown() {}
+
+void RendererNull::SwapBuffers() {
+    if (g_renderer_screenshot_requested) {
+        LOG_ERROR(Render, "Screenshots are not supported by the null renderer");
+        g_renderer_screenshot_requested = false;
+    }
+
+    m_current_frame++;
+
+    Core::System& system = Core::System::GetInstance();
+    if (system.VideoDumper().IsDumping()) {
+        DumpFrame(system.VideoDumper());
+    }
+
+    system.perf_stats->EndSystemFrame();
+
+    render_window.PollEvents();
+
+    system.frame_limiter.DoFrameLimiting(system.CoreTiming().GetGlobalTimeUs());
+    system.perf_stats->BeginSystemFrame();
+
+    RefreshRasterizerSetting();
+
+    if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
+        Pica::g_debug_context->recorder->FrameFinished();
+    }
+}
+
+void RendererNull::DumpFrame(VideoDumper::Backend& video_dumper) {
+    const Layout::FramebufferLayout layout = video_dumper.GetLayout();
+    VideoDumper::VideoFrame frame;
+    frame.width = layout.width;
+    frame.height = layout.height;
+    frame.stride = static_cast<u32>(layout.width * 4);
+    frame.data.assign(frame.stride * frame.height, 0);
+
+    const auto& framebuffers = GPU::g_regs.framebuffer_config;
+    if (layout.top_screen_enabled) {
+        DrawScreen(framebuffers[0], layout.top_screen, layout.is_rotated, frame);
+    }
+    if (layout.bottom_screen_enabled) {
+        DrawScreen(framebuffers[1], layout.bottom_screen, layout.is_rotated, frame);
+    }
+
+    video_dumper.AddVideoFrame(std::move(frame));
+}
+
+void RendererNull::TryPresent(int timeout_ms) {
+    // No frame will ever arrive, behave like a presentation that timed out.
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+}
+
+void RendererNull::RefreshRasterizerSetting() {
+    const bool use_software_rasterizer = !g_hw_renderer_enabled;
+    if (rasterizer == nullptr || software_rasterizer_active != use_software_rasterizer) {
+        software_rasterizer_active = use_software_rasterizer;
+
+        if (use_software_rasterizer) {
+            rasterizer = std::make_unique<SWRasterizer>();
+        } else {
+            rasterizer = std::make_unique<NullRasterizer>();
+        }
+    }
+}
+
+} // namespace VideoCore
@@ -0,0 +1,48 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/renderer_base.h"
+
+namespace Frontend {
+class EmuWindow;
+}
+
+namespace VideoDumper {
+class Backend;
+}
+
+namespace VideoCore {
+
+/**
+ * Renderer that needs no graphics API and presents nothing. PICA command lists, memory fills and
+ * display transfers are still processed, so guest-visible state matches the other renderers.
+ * Triangles are discarded, unless the hardware renderer is disabled, in which case they are drawn
+ * into emulated memory by the software rasterizer.
+ *
+ * Video dumps are captured by reading the framebuffers back from emulated memory on the CPU, so
+ * they can be produced without a GPU as long as the software rasterizer is used.
+ */
+class RendererNull : public RendererBase {
+public:
+    explicit RendererNull(Frontend::EmuWindow& window);
+    ~RendererNull() override;
+
+    ResultStatus Init() override;
+    void ShutDown() override;
+    void SwapBuffers() override;
+    void TryPresent(int timeout_ms) override;
+    void PrepareVideoDumping() override {}
+    void CleanupVideoDumping() override {}
+    void RefreshRasterizerSetting() override;
+
+private:
+    /// Composes the displayed framebuffers into a frame of the dump layout and queues it
+    void DumpFrame(VideoDumper::Backend& video_dumper);
+
+    bool software_rasterizer_active = false;
+};
+
+} // namespace VideoCore
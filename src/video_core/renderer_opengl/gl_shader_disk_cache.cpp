@@ -196,11 +196,8 @@ ShaderDiskCache::LoadPrecompiled() {
 
 std::optional<std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>>
 ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file) {
-    // Read compressed file from disk and decompress to virtual precompiled cache file
-    std::vector<u8> compressed(file.GetSize());
-    file.ReadBytes(compressed.data(), compressed.size());
-    const std::vector<u8> decompressed = Common::Compression::DecompressDataZSTD(compressed);
-    SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
+    // Decompress the file to the virtual precompiled cache file while it is read from disk
+    decompressed_precompiled_cache = Common::Compression::DecompressDataZSTD(file);
     decompressed_precompiled_cache_offset = 0;
 
     ShaderCacheVersionHash file_hash{};
@@ -175,6 +175,10 @@ private:
 
     template <typename T>
     bool LoadArrayFromPrecompiled(T* data, std::size_t length) {
+        if (length * sizeof(T) >
+            decompressed_precompiled_cache.size() - decompressed_precompiled_cache_offset) {
+            return false;
+        }
         u8* data_view = reinterpret_cast<u8*>(data);
         std::copy_n(decompressed_precompiled_cache.data() + decompressed_precompiled_cache_offset,
                     length * sizeof(T), data_view);
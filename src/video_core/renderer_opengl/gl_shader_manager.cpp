@@ -3,11 +3,20 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/functional/hash.hpp>
 #include <boost/variant.hpp>
 #include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/frontend/scope_acquire_context.h"
+#include "core/settings.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 #include "video_core/video_core.h"
@@ -33,19 +42,22 @@ static OGLProgram GeneratePrecompiledProgram(const ShaderDiskCacheDump& dump,
         return {};
     }
 
-    auto shader = OGLProgram();
-    shader.handle = glCreateProgram();
-    glProgramParameteri(shader.handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
-    glProgramBinary(shader.handle, dump.binary_format, dump.binary.data(),
+    const GLuint handle = glCreateProgram();
+    glProgramParameteri(handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    glProgramBinary(handle, dump.binary_format, dump.binary.data(),
                     static_cast<GLsizei>(dump.binary.size()));
 
     GLint link_status{};
-    glGetProgramiv(shader.handle, GL_LINK_STATUS, &link_status);
+    glGetProgramiv(handle, GL_LINK_STATUS, &link_status);
     if (link_status == GL_FALSE) {
         LOG_INFO(Render_OpenGL, "Precompiled cache rejected by the driver - removing");
+        // Deleted directly, as the program was never bound, and this runs on loading threads
+        glDeleteProgram(handle);
         return {};
     }
 
+    OGLProgram shader;
+    shader.handle = handle;
     return shader;
 }
 
@@ -198,6 +210,138 @@ private:
     boost::variant<OGLShader, OGLProgram> shader_or_program;
 };
 
+using SharedContexts = std::vector<std::unique_ptr<Frontend::GraphicsContext>>;
+
+/**
+ * Creates contexts sharing objects with the render context, which must be done on the render
+ * thread. Fewer contexts, possibly none, are returned if the frontend cannot provide them.
+ */
+static SharedContexts CreateSharedContexts(Frontend::EmuWindow& emu_window, std::size_t count) {
+    SharedContexts contexts;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto context = emu_window.CreateSharedContext();
+        if (!context) {
+            break;
+        }
+        contexts.push_back(std::move(context));
+    }
+    return contexts;
+}
+
+/// Returns the number of threads loading the disk cache
+static std::size_t GetNumDiskCacheThreads() {
+    return std::clamp(std::thread::hardware_concurrency(), 1U, 8U);
+}
+
+/**
+ * Builds a separable program from GLSL code. Unlike OGLShaderStage, this does not go through
+ * OpenGLState, so it can be used on any thread with a current context.
+ */
+static OGLProgram BuildSeparableProgram(const std::string& code, GLenum type) {
+    OGLShader shader;
+    shader.Create(code.c_str(), type);
+    OGLProgram program;
+    program.Create(true, {shader.handle});
+    return program;
+}
+
+/**
+ * Builds separable programs on worker threads, each with its own context sharing objects with the
+ * render context. Built programs are handed back to the render thread by ProcessResults.
+ */
+class AsyncShaderCompiler {
+public:
+    using Callback = std::function<void(OGLProgram&& program)>;
+
+    explicit AsyncShaderCompiler(SharedContexts contexts_) : contexts(std::move(contexts_)) {
+        for (auto& context : contexts) {
+            workers.emplace_back(&AsyncShaderCompiler::WorkerLoop, this, std::ref(*context));
+        }
+    }
+
+    ~AsyncShaderCompiler() {
+        {
+            std::lock_guard lock{mutex};
+            stop_requested = true;
+        }
+        job_available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /// Queues a program to be built from GLSL code. The callback is called by ProcessResults.
+    void Compile(std::string code, GLenum type, Callback callback) {
+        {
+            std::lock_guard lock{mutex};
+            jobs.push_back({std::move(code), type, std::move(callback)});
+        }
+        job_available.notify_one();
+    }
+
+    /// Hands the programs built so far to their callbacks. Must be called on the render thread.
+    void ProcessResults() {
+        if (!results_ready.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::vector<Result> finished;
+        {
+            std::lock_guard lock{mutex};
+            finished.swap(results);
+            results_ready = false;
+        }
+        for (auto& result : finished) {
+            result.callback(std::move(result.program));
+        }
+    }
+
+private:
+    struct Job {
+        std::string code;
+        GLenum type;
+        Callback callback;
+    };
+
+    struct Result {
+        OGLProgram program;
+        Callback callback;
+    };
+
+    void WorkerLoop(Frontend::GraphicsContext& context) {
+        Frontend::ScopeAcquireContext scope{context};
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock{mutex};
+                job_available.wait(lock, [this] { return stop_requested || !jobs.empty(); });
+                if (stop_requested) {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            OGLProgram program = BuildSeparableProgram(job.code, job.type);
+            // The program must be complete before it is used by the render context
+            glFinish();
+
+            std::lock_guard lock{mutex};
+            results.push_back({std::move(program), std::move(job.callback)});
+            results_ready = true;
+        }
+    }
+
+    SharedContexts contexts;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable job_available;
+    std::deque<Job> jobs;
+    std::vector<Result> results;
+    std::atomic_bool results_ready = false;
+    bool stop_requested = false;
+};
+
 class TrivialVertexShader {
 public:
     explicit TrivialVertexShader(bool separable) : program(separable) {
@@ -229,15 +373,41 @@ public:
         return {cached_shader.GetHandle(), std::move(result)};
     }
 
-    void Inject(const KeyConfigType& key, OGLProgram&& program) {
-        OGLShaderStage stage{separable};
-        stage.Inject(std::move(program));
-        shaders.emplace(key, std::move(stage));
+    /**
+     * Like Get, but a new shader is built by the compiler, and no handle is returned until it is
+     * ready. The generated code is returned on the first request only.
+     */
+    std::tuple<std::optional<GLuint>, std::optional<ShaderDecompiler::ProgramResult>> GetAsync(
+        const KeyConfigType& config, AsyncShaderCompiler& compiler) {
+        if (auto iter = shaders.find(config); iter != shaders.end()) {
+            return {iter->second.GetHandle(), std::nullopt};
+        }
+        if (!pending.insert(config).second) {
+            return {std::nullopt, std::nullopt};
+        }
+
+        auto result = CodeGenerator(config, separable);
+        compiler.Compile(result.code, ShaderType, [this, config](OGLProgram&& program) {
+            pending.erase(config);
+            Inject(config, std::move(program));
+        });
+        return {std::nullopt, std::move(result)};
+    }
+
+    /// Returns false, dropping the program, if the key already had a shader
+    bool Inject(const KeyConfigType& key, OGLProgram&& program) {
+        auto [iter, new_shader] = shaders.try_emplace(key, separable);
+        if (new_shader) {
+            iter->second.Inject(std::move(program));
+        }
+        return new_shader;
     }
 
 private:
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage> shaders;
+    /// Configs whose shader is being built by the async compiler
+    std::unordered_set<KeyConfigType> pending;
 };
 
 // This is a cache designed for shaders translated from PICA shaders. The first cache matches the
@@ -282,18 +452,74 @@ public:
         return {map_it->second->GetHandle(), std::nullopt};
     }
 
-    void Inject(const KeyConfigType& key, std::string decomp, OGLProgram&& program) {
-        OGLShaderStage stage{separable};
-        stage.Inject(std::move(program));
-        const auto iter = shader_cache.emplace(std::move(decomp), std::move(stage)).first;
-        OGLShaderStage& cached_shader = iter->second;
-        shader_map.insert_or_assign(key, &cached_shader);
+    /**
+     * Like Get, but a new program is built by the compiler, and 0 is returned until it is ready.
+     * The generated code is returned on the first request only.
+     */
+    std::tuple<GLuint, std::optional<ShaderDecompiler::ProgramResult>> GetAsync(
+        const KeyConfigType& key, const Pica::Shader::ShaderSetup& setup,
+        AsyncShaderCompiler& compiler) {
+        if (auto map_it = shader_map.find(key); map_it != shader_map.end()) {
+            return {map_it->second ? map_it->second->GetHandle() : 0, std::nullopt};
+        }
+        if (pending_keys.count(key)) {
+            return {0, std::nullopt};
+        }
+
+        auto program_opt = CodeGenerator(setup, key, separable);
+        if (!program_opt) {
+            shader_map[key] = nullptr;
+            return {0, std::nullopt};
+        }
+
+        const std::string& program = program_opt->code;
+        if (auto cache_it = shader_cache.find(program); cache_it != shader_cache.end()) {
+            shader_map[key] = &cache_it->second;
+            return {cache_it->second.GetHandle(), std::nullopt};
+        }
+
+        // Keys generating the same code as a program being built wait for that program
+        pending_keys.insert(key);
+        auto [pending_it, new_program] = pending_programs.try_emplace(program);
+        pending_it->second.push_back(key);
+        if (!new_program) {
+            return {0, std::nullopt};
+        }
+
+        compiler.Compile(program, ShaderType, [this, program](OGLProgram&& built) {
+            const auto keys = pending_programs.extract(program);
+            OGLShaderStage stage{separable};
+            stage.Inject(std::move(built));
+            OGLShaderStage& cached_shader =
+                shader_cache.emplace(program, std::move(stage)).first->second;
+            for (const auto& key : keys.mapped()) {
+                pending_keys.erase(key);
+                shader_map.insert_or_assign(key, &cached_shader);
+            }
+        });
+        return {0, std::move(program_opt)};
+    }
+
+    /**
+     * Returns false, dropping the program, if the code already had a program. The key is mapped to
+     * the cached program in both cases.
+     */
+    bool Inject(const KeyConfigType& key, std::string decomp, OGLProgram&& program) {
+        auto [iter, new_shader] = shader_cache.try_emplace(std::move(decomp), separable);
+        if (new_shader) {
+            iter->second.Inject(std::move(program));
+        }
+        shader_map.insert_or_assign(key, &iter->second);
+        return new_shader;
     }
 
 private:
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage*> shader_map;
     std::unordered_map<std::string, OGLShaderStage> shader_cache;
+    /// Keys whose program is being built by the async compiler, grouped by program code
+    std::unordered_set<KeyConfigType> pending_keys;
+    std::unordered_map<std::string, std::vector<KeyConfigType>> pending_programs;
 };
 
 using ProgrammableVertexShaders =
@@ -306,12 +532,29 @@ using FragmentShaders = ShaderCache<PicaFSConfig, &GenerateFragmentShader, GL_FR
 
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(bool separable, bool is_amd)
-        : is_amd(is_amd), separable(separable), programmable_vertex_shaders(separable),
+    explicit Impl(Frontend::EmuWindow& emu_window, bool separable, bool is_amd)
+        : emu_window(emu_window), is_amd(is_amd), separable(separable),
+          programmable_vertex_shaders(separable),
           trivial_vertex_shader(separable), fixed_geometry_shaders(separable),
           fragment_shaders(separable), disk_cache(separable) {
         if (separable)
             pipeline.Create();
+
+        // Built programs are only shared between contexts as separable programs
+        if (separable && Settings::values.async_shader_compilation) {
+            const std::size_t num_workers =
+                std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U);
+            auto contexts = CreateSharedContexts(emu_window, num_workers);
+            if (!contexts.empty()) {
+                async_compiler = std::make_unique<AsyncShaderCompiler>(std::move(contexts));
+            }
+        }
+
+        // The disk cache is loaded on another thread, which cannot create contexts on all
+        // frontends, so they are created here
+        if (separable && Settings::values.use_disk_shader_cache) {
+            disk_cache_contexts = CreateSharedContexts(emu_window, GetNumDiskCacheThreads());
+        }
     }
 
     struct ShaderTuple {
@@ -338,6 +581,7 @@ public:
         };
     };
 
+    Frontend::EmuWindow& emu_window;
     bool is_amd;
     bool separable;
 
@@ -352,17 +596,33 @@ public:
     std::unordered_map<ShaderTuple, OGLProgram, ShaderTuple::Hash> program_cache;
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
+    /// Contexts of the threads loading the disk cache. They are kept until the manager is
+    /// destroyed, as the loading thread cannot destroy them on all frontends either.
+    SharedContexts disk_cache_contexts;
+
+    /// Declared last, so the workers are stopped before the caches their callbacks fill are gone
+    std::unique_ptr<AsyncShaderCompiler> async_compiler;
 };
 
-ShaderProgramManager::ShaderProgramManager(bool separable, bool is_amd)
-    : impl(std::make_unique<Impl>(separable, is_amd)) {}
+ShaderProgramManager::ShaderProgramManager(Frontend::EmuWindow& emu_window, bool separable,
+                                           bool is_amd)
+    : impl(std::make_unique<Impl>(emu_window, separable, is_amd)) {}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
 bool ShaderProgramManager::UseProgrammableVertexShader(const Pica::Regs& regs,
                                                        Pica::Shader::ShaderSetup& setup) {
     PicaVSConfig config{regs.vs, setup};
-    auto [handle, result] = impl->programmable_vertex_shaders.Get(config, setup);
+    GLuint handle;
+    std::optional<ShaderDecompiler::ProgramResult> result;
+    if (impl->async_compiler) {
+        // Vertices are processed in software until the program is built
+        impl->async_compiler->ProcessResults();
+        std::tie(handle, result) =
+            impl->programmable_vertex_shaders.GetAsync(config, setup, *impl->async_compiler);
+    } else {
+        std::tie(handle, result) = impl->programmable_vertex_shaders.Get(config, setup);
+    }
     if (handle == 0)
         return false;
     impl->current.vs = handle;
@@ -394,10 +654,16 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
     impl->current.gs = 0;
 }
 
-void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
+bool ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
     PicaFSConfig config = PicaFSConfig::BuildFromRegs(regs);
-    auto [handle, result] = impl->fragment_shaders.Get(config);
-    impl->current.fs = handle;
+    std::optional<GLuint> handle;
+    std::optional<ShaderDecompiler::ProgramResult> result;
+    if (impl->async_compiler) {
+        impl->async_compiler->ProcessResults();
+        std::tie(handle, result) = impl->fragment_shaders.GetAsync(config, *impl->async_compiler);
+    } else {
+        std::tie(handle, result) = impl->fragment_shaders.Get(config);
+    }
     // Save FS to the disk cache if its a new shader
     if (result) {
         auto& disk_cache = impl->disk_cache;
@@ -406,6 +672,11 @@ void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
         disk_cache.SaveRaw(raw);
         disk_cache.SaveDecompiled(unique_identifier, *result, false);
     }
+    if (!handle) {
+        return false;
+    }
+    impl->current.fs = *handle;
+    return true;
 }
 
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
@@ -435,6 +706,51 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     }
 }
 
+/**
+ * Calls func for each index in [0, count) on num_threads threads, or on the calling thread if it is
+ * 0. The first threads make the contexts given current, so func can create GL objects on them.
+ * Returns false if any call of func returned false, which stops the others early.
+ */
+static bool ParallelForEach(std::size_t count, std::size_t num_threads,
+                            const SharedContexts& contexts, const std::atomic_bool& stop_loading,
+                            const std::function<bool(std::size_t)>& func) {
+    std::atomic_size_t next_index = 0;
+    std::atomic_bool failed = false;
+    const auto worker = [&] {
+        while (!stop_loading && !failed) {
+            const std::size_t index = next_index++;
+            if (index >= count) {
+                break;
+            }
+            if (!func(index)) {
+                failed = true;
+            }
+        }
+    };
+
+    if (num_threads == 0) {
+        worker();
+        return !failed;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&worker, &contexts, i] {
+            if (i >= contexts.size()) {
+                worker();
+                return;
+            }
+            Frontend::ScopeAcquireContext scope{*contexts[i]};
+            worker();
+            // Programs created here must be complete before the calling thread uses them
+            glFinish();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return !failed;
+}
+
 void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     if (!impl->separable) {
@@ -449,174 +765,230 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     }
     const auto& raws = *transferable;
 
-    auto [decompiled, dumps] = disk_cache.LoadPrecompiled();
+    auto precompiled = disk_cache.LoadPrecompiled();
+    const auto& decompiled = precompiled.first;
+    auto& dumps = precompiled.second;
 
     if (stop_loading) {
         return;
     }
 
-    std::set<GLenum> supported_formats = GetSupportedFormats();
+    const std::set<GLenum> supported_formats = GetSupportedFormats();
+
+    // Programs are loaded and built on threads with contexts shared with this one, then inserted in
+    // the caches here, as setting their bindings goes through OpenGLState
+    const std::size_t num_threads = GetNumDiskCacheThreads();
+    const SharedContexts& contexts = impl->disk_cache_contexts;
+
+    std::mutex callback_mutex;
+    std::size_t progress = 0;
+    const auto report_progress = [&](VideoCore::LoadCallbackStage stage, std::size_t total) {
+        if (callback) {
+            std::scoped_lock lock{callback_mutex};
+            callback(stage, ++progress, total);
+        }
+    };
 
     // Track if precompiled cache was altered during loading to know if we have to serialize the
     // virtual precompiled cache file back to the hard drive
     bool precompiled_cache_altered = false;
 
-    std::mutex mutex;
-    std::atomic_bool compilation_failed = false;
     if (callback) {
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
-    std::vector<std::size_t> load_raws_index;
-    // Loads both decompiled and precompiled shaders from the cache. If either one is missing for
-    const auto LoadPrecompiledWorker =
-        [&](std::size_t begin, std::size_t end, const std::vector<ShaderDiskCacheRaw>& raw_cache,
-            const ShaderDecompiledMap& decompiled_map, const ShaderDumpsMap& dump_map) {
-            for (std::size_t i = 0; i < end; ++i) {
-                if (stop_loading || compilation_failed) {
-                    return;
-                }
-                const auto& raw{raw_cache[i]};
-                const u64 unique_identifier{raw.GetUniqueIdentifier()};
-
-                const u64 calculated_hash =
-                    GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode());
-                if (unique_identifier != calculated_hash) {
-                    LOG_ERROR(Render_OpenGL,
-                              "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
-                              "shader cache",
-                              raw.GetUniqueIdentifier(), calculated_hash);
-                    disk_cache.InvalidateAll();
-                    return;
-                }
 
-                const auto dump{dump_map.find(unique_identifier)};
-                const auto decomp{decompiled_map.find(unique_identifier)};
-
-                OGLProgram shader;
-
-                if (dump != dump_map.end() && decomp != decompiled_map.end()) {
-                    // Only load this shader if its sanitize_mul setting matches
-                    if (decomp->second.sanitize_mul == VideoCore::g_hw_shader_accurate_mul) {
-                        continue;
-                    }
-
-                    // If the shader is dumped, attempt to load it
-                    shader = GeneratePrecompiledProgram(dump->second, supported_formats);
-                    if (shader.handle == 0) {
-                        // If any shader failed, stop trying to compile, delete the cache, and start
-                        // loading from raws
-                        compilation_failed = true;
-                        return;
-                    }
-                    // we have both the binary shader and the decompiled, so inject it into the
-                    // cache
-                    if (raw.GetProgramType() == ProgramType::VS) {
-                        auto [conf, setup] = BuildVSConfigFromRaw(raw);
-                        std::scoped_lock lock(mutex);
-
-                        impl->programmable_vertex_shaders.Inject(conf, decomp->second.result.code,
-                                                                 std::move(shader));
-                    } else if (raw.GetProgramType() == ProgramType::FS) {
-                        PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
-                        std::scoped_lock lock(mutex);
-                        impl->fragment_shaders.Inject(conf, std::move(shader));
-                    } else {
-                        // Unsupported shader type got stored somehow so nuke the cache
-
-                        LOG_CRITICAL(Frontend, "failed to load raw programtype {}",
-                                     raw.GetProgramType());
-                        compilation_failed = true;
-                        return;
-                    }
-                } else {
-                    // Since precompiled didn't have the dump, we'll load them in the next phase
-                    std::scoped_lock lock(mutex);
-                    load_raws_index.push_back(i);
+    // Loads the programs that have both a decompiled entry and a dump. The others are built from
+    // the raw entries in the next phase.
+    std::atomic_bool invalid_hash = false;
+    std::vector<OGLProgram> programs(raws.size());
+    const bool precompiled_loaded =
+        ParallelForEach(raws.size(), contexts.size(), contexts, stop_loading, [&](std::size_t i) {
+            const auto& raw{raws[i]};
+            const u64 unique_identifier{raw.GetUniqueIdentifier()};
+
+            const u64 calculated_hash =
+                GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode());
+            if (unique_identifier != calculated_hash) {
+                LOG_ERROR(Render_OpenGL,
+                          "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
+                          "shader cache",
+                          raw.GetUniqueIdentifier(), calculated_hash);
+                invalid_hash = true;
+                return false;
+            }
+
+            const auto dump{dumps.find(unique_identifier)};
+            const auto decomp{decompiled.find(unique_identifier)};
+            // Only load this shader if its sanitize_mul setting matches
+            if (dump != dumps.end() && decomp != decompiled.end() &&
+                decomp->second.sanitize_mul != VideoCore::g_hw_shader_accurate_mul) {
+                if (raw.GetProgramType() != ProgramType::VS &&
+                    raw.GetProgramType() != ProgramType::FS) {
+                    // Unsupported shader type got stored somehow so nuke the cache
+                    LOG_CRITICAL(Frontend, "failed to load raw programtype {}",
+                                 raw.GetProgramType());
+                    return false;
                 }
-                if (callback) {
-                    callback(VideoCore::LoadCallbackStage::Decompile, i, raw_cache.size());
+
+                // If any shader failed, stop trying to compile, delete the cache, and start
+                // loading from raws
+                programs[i] = GeneratePrecompiledProgram(dump->second, supported_formats);
+                if (programs[i].handle == 0) {
+                    return false;
                 }
             }
-        };
 
-    LoadPrecompiledWorker(0, raws.size(), raws, decompiled, dumps);
+            report_progress(VideoCore::LoadCallbackStage::Decompile, raws.size());
+            return true;
+        });
+
+    if (invalid_hash) {
+        disk_cache.InvalidateAll();
+        return;
+    }
+    if (stop_loading) {
+        return;
+    }
 
-    if (compilation_failed) {
+    if (!precompiled_loaded) {
         // Invalidate the precompiled cache if a shader dumped shader was rejected
         disk_cache.InvalidatePrecompiled();
         dumps.clear();
         precompiled_cache_altered = true;
+        programs.clear();
+        programs.resize(raws.size());
     }
 
-    if (callback) {
-        callback(VideoCore::LoadCallbackStage::Build, 0, raws.size());
+    // We have both the binary shader and the decompiled, so inject it into the cache
+    std::vector<std::size_t> load_raws_index;
+    for (std::size_t i = 0; i < raws.size(); ++i) {
+        const auto& raw{raws[i]};
+        if (programs[i].handle == 0) {
+            load_raws_index.push_back(i);
+        } else if (raw.GetProgramType() == ProgramType::VS) {
+            auto [conf, setup] = BuildVSConfigFromRaw(raw);
+            const auto& decomp{decompiled.at(raw.GetUniqueIdentifier())};
+            impl->programmable_vertex_shaders.Inject(conf, decomp.result.code,
+                                                     std::move(programs[i]));
+        } else {
+            const PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
+            impl->fragment_shaders.Inject(conf, std::move(programs[i]));
+        }
     }
-
-    compilation_failed = false;
-
-    const auto LoadTransferable = [&](std::size_t begin, std::size_t end,
-                                      const std::vector<ShaderDiskCacheRaw>& raw_cache) {
-        for (std::size_t i = 0; i < end; ++i) {
-            if (stop_loading || compilation_failed) {
-                return;
-            }
-            const auto& raw{raw_cache[i]};
-            const u64 unique_identifier{raw.GetUniqueIdentifier()};
-
-            bool sanitize_mul = false;
-            GLuint handle{0};
-            std::optional<ShaderDecompiler::ProgramResult> result;
-            // Otherwise decompile and build the shader at boot and save the result to the
-            // precompiled file
+    programs.clear();
+
+    // Otherwise decompile and build the shader at boot and save the result to the precompiled file.
+    // The code of the shaders left is generated first, so programs shared by several entries are
+    // only built once.
+    struct BuildEntry {
+        std::optional<ShaderDecompiler::ProgramResult> result;
+        std::size_t program_index = 0;
+    };
+    std::vector<BuildEntry> entries(load_raws_index.size());
+    const bool generated =
+        ParallelForEach(entries.size(), num_threads, {}, stop_loading, [&](std::size_t i) {
+            const auto& raw{raws[load_raws_index[i]]};
+            auto& entry = entries[i];
             if (raw.GetProgramType() == ProgramType::VS) {
-                // TODO: This isn't the ideal place to lock, since we really only want to
-                // lock access to the shared cache
                 auto [conf, setup] = BuildVSConfigFromRaw(raw);
-                std::scoped_lock lock(mutex);
-                auto [h, r] = impl->programmable_vertex_shaders.Get(conf, setup);
-                handle = h;
-                result = std::move(r);
-                sanitize_mul = conf.state.sanitize_mul;
+                entry.result = GenerateVertexShader(setup, conf, impl->separable);
             } else if (raw.GetProgramType() == ProgramType::FS) {
-                PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
-                std::scoped_lock lock(mutex);
-                auto [h, r] = impl->fragment_shaders.Get(conf);
-                handle = h;
-                result = std::move(r);
+                const PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
+                entry.result = GenerateFragmentShader(conf, impl->separable);
             } else {
                 // Unsupported shader type got stored somehow so nuke the cache
                 LOG_ERROR(Frontend, "failed to load raw programtype {}", raw.GetProgramType());
-                compilation_failed = true;
-                return;
+                return false;
             }
-            if (handle == 0) {
+            if (!entry.result) {
                 LOG_ERROR(Frontend, "compilation from raw failed {:x} {:x}",
                           raw.GetProgramCode().at(0), raw.GetProgramCode().at(1));
-                compilation_failed = true;
-                return;
-            }
-            // If this is a new shader, add it the precompiled cache
-            if (result) {
-                disk_cache.SaveDecompiled(unique_identifier, *result, sanitize_mul);
-                disk_cache.SaveDump(unique_identifier, handle);
-                precompiled_cache_altered = true;
+                return false;
             }
+            return true;
+        });
+    if (stop_loading) {
+        return;
+    }
+    if (!generated) {
+        disk_cache.InvalidateAll();
+        return;
+    }
 
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Build, i, raw_cache.size());
-            }
-        }
+    struct BuildJob {
+        const std::string* code;
+        GLenum type;
     };
+    std::vector<BuildJob> jobs;
+    std::unordered_map<std::string_view, std::size_t> vertex_jobs;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        auto& entry = entries[i];
+        const std::string& code = entry.result->code;
+        if (raws[load_raws_index[i]].GetProgramType() == ProgramType::FS) {
+            entry.program_index = jobs.size();
+            jobs.push_back({&code, GL_FRAGMENT_SHADER});
+            continue;
+        }
+        const auto [iter, new_program] = vertex_jobs.emplace(code, jobs.size());
+        entry.program_index = iter->second;
+        if (new_program) {
+            jobs.push_back({&code, GL_VERTEX_SHADER});
+        }
+    }
 
-    LoadTransferable(0, raws.size(), raws);
+    if (callback) {
+        progress = 0;
+        callback(VideoCore::LoadCallbackStage::Build, 0, jobs.size());
+    }
 
-    if (compilation_failed) {
+    programs.resize(jobs.size());
+    const bool built =
+        ParallelForEach(jobs.size(), contexts.size(), contexts, stop_loading, [&](std::size_t i) {
+            programs[i] = BuildSeparableProgram(*jobs[i].code, jobs[i].type);
+            report_progress(VideoCore::LoadCallbackStage::Build, jobs.size());
+            return programs[i].handle != 0;
+        });
+    if (stop_loading) {
+        return;
+    }
+    if (!built) {
+        LOG_ERROR(Frontend, "compilation from raw failed");
         disk_cache.InvalidateAll();
+        return;
+    }
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        auto& entry = entries[i];
+        const auto& raw{raws[load_raws_index[i]]};
+        // Entries sharing a program with a previous one are given an empty program, which the
+        // caches drop as they already have that program
+        OGLProgram& program = programs[entry.program_index];
+        const GLuint handle = program.handle;
+
+        bool new_shader;
+        bool sanitize_mul = false;
+        if (raw.GetProgramType() == ProgramType::VS) {
+            auto [conf, setup] = BuildVSConfigFromRaw(raw);
+            new_shader = impl->programmable_vertex_shaders.Inject(conf, entry.result->code,
+                                                                  std::move(program));
+            sanitize_mul = conf.state.sanitize_mul;
+        } else {
+            const PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
+            new_shader = impl->fragment_shaders.Inject(conf, std::move(program));
+        }
+
+        // If this is a new shader, add it the precompiled cache
+        if (new_shader) {
+            const u64 unique_identifier{raw.GetUniqueIdentifier()};
+            disk_cache.SaveDecompiled(unique_identifier, *entry.result, sanitize_mul);
+            disk_cache.SaveDump(unique_identifier, handle);
+            precompiled_cache_altered = true;
+        }
     }
 
     if (precompiled_cache_altered) {
         disk_cache.SaveVirtualPrecompiledFile();
     }
-} // namespace OpenGL
+}
 
 } // namespace OpenGL
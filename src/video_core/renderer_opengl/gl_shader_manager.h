@@ -17,6 +17,10 @@ namespace Core {
 class System;
 }
 
+namespace Frontend {
+class EmuWindow;
+}
+
 namespace OpenGL {
 
 enum class UniformBindings : GLuint { Common, VS, GS };
@@ -99,7 +103,7 @@ static_assert(sizeof(VSUniformData) < 16384,
 /// A class that manage different shader stages and configures them with given config data.
 class ShaderProgramManager {
 public:
-    ShaderProgramManager(bool separable, bool is_amd);
+    ShaderProgramManager(Frontend::EmuWindow& emu_window, bool separable, bool is_amd);
     ~ShaderProgramManager();
 
     void LoadDiskCache(const std::atomic_bool& stop_loading,
@@ -113,7 +117,8 @@ public:
 
     void UseTrivialGeometryShader();
 
-    void UseFragmentShader(const Pica::Regs& config);
+    /// Returns false while the shader is being compiled in the background
+    bool UseFragmentShader(const Pica::Regs& config);
 
     void ApplyTo(OpenGLState& state);
 
@@ -4,13 +4,30 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include "common/common_types.h"
 #include "video_core/shader/debug_data.h"
 #include "video_core/shader/shader.h"
 
 namespace Pica::Shader {
 
+class CompiledShader;
+
+/**
+ * Runs a program by decoding each instruction as it is reached, without compiling it first. This
+ * is how programs used to be run, and is the reference that compiled programs are tested against.
+ * @param setup  Shader engine state
+ * @param state  Registers the program runs on
+ * @param offset Address of the first instruction to run
+ */
+void RunReferenceInterpreter(const ShaderSetup& setup, UnitState& state, unsigned offset);
+
 class InterpreterEngine final : public ShaderEngine {
 public:
+    InterpreterEngine();
+    ~InterpreterEngine() override;
+
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
 
@@ -23,6 +40,10 @@ public:
      */
     DebugData<true> ProduceDebugInfo(const ShaderSetup& setup, const AttributeBuffer& input,
                                      const ShaderRegs& config) const;
+
+private:
+    /// Decoded programs, indexed by the hashes of their code and swizzle data
+    std::unordered_map<u64, std::unique_ptr<CompiledShader>> cache;
 };
 
 } // namespace Pica::Shader
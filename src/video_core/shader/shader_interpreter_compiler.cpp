@@ -0,0 +1,741 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <boost/container/static_vector.hpp>
+#include <nihstro/shader_bytecode.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
+#include "video_core/shader/shader_interpreter_compiler.h"
+
+using nihstro::OpCode;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+
+namespace Pica::Shader {
+
+// Operations in the order of their dispatch labels
+#define INTERPRETER_OPERATIONS(X)                                                                  \
+    X(ADD)                                                                                         \
+    X(MUL)                                                                                         \
+    X(FLR)                                                                                         \
+    X(MAX)                                                                                         \
+    X(MIN)                                                                                         \
+    X(DP3)                                                                                         \
+    X(DP4)                                                                                         \
+    X(DPH)                                                                                         \
+    X(RCP)                                                                                         \
+    X(RSQ)                                                                                         \
+    X(MOVA)                                                                                        \
+    X(MOV)                                                                                         \
+    X(SGE)                                                                                         \
+    X(SLT)                                                                                         \
+    X(CMP)                                                                                         \
+    X(EX2)                                                                                         \
+    X(LG2)                                                                                         \
+    X(MAD)                                                                                         \
+    X(END)                                                                                         \
+    X(JMPC)                                                                                        \
+    X(JMPU)                                                                                        \
+    X(CALL)                                                                                        \
+    X(CALLU)                                                                                       \
+    X(CALLC)                                                                                       \
+    X(NOP)                                                                                         \
+    X(IFU)                                                                                         \
+    X(IFC)                                                                                         \
+    X(LOOP)                                                                                        \
+    X(EMIT)                                                                                        \
+    X(SETEMIT)                                                                                     \
+    X(UnknownArithmetic)                                                                           \
+    X(UnknownMultiplyAdd)                                                                          \
+    X(Unknown)
+
+#define OPERATION_ENUM(name) name,
+enum class CompiledShader::Operation : u8 { INTERPRETER_OPERATIONS(OPERATION_ENUM) };
+#undef OPERATION_ENUM
+
+namespace {
+
+struct CallStackElement {
+    u32 final_address;  // Address upon which we jump to return_address
+    u32 return_address; // Where to jump when leaving scope
+    u8 repeat_counter;  // How often to repeat until this call stack element is removed
+    u8 loop_increment;  // Which value to add to the loop counter after an iteration
+    u32 loop_address;   // The address where we'll return to after each loop iteration
+};
+
+/// Register value of the first register of a register file, as encoded in source operands
+u32 GetRegisterFileBase(CompiledShader::RegisterFile file) {
+    switch (file) {
+    case CompiledShader::RegisterFile::Temporary:
+        return 0x10;
+    case CompiledShader::RegisterFile::FloatUniform:
+        return 0x20;
+    default:
+        return 0;
+    }
+}
+
+/// Decodes source operand 1, 2 or 3 along with its swizzle and negation
+CompiledShader::DecodedSource DecodeSource(const SourceRegister& source_reg,
+                                           const SwizzlePattern& swizzle, int operand) {
+    CompiledShader::DecodedSource src;
+    switch (source_reg.GetRegisterType()) {
+    case RegisterType::Input:
+        src.file = CompiledShader::RegisterFile::Input;
+        src.index = static_cast<u8>(source_reg.GetIndex());
+        break;
+    case RegisterType::Temporary:
+        src.file = CompiledShader::RegisterFile::Temporary;
+        src.index = static_cast<u8>(source_reg.GetIndex());
+        break;
+    case RegisterType::FloatUniform:
+        src.file = CompiledShader::RegisterFile::FloatUniform;
+        src.index = static_cast<u8>(source_reg.GetIndex());
+        break;
+    default:
+        src.file = CompiledShader::RegisterFile::Dummy;
+        src.index = 0;
+        break;
+    }
+
+    switch (operand) {
+    case 1:
+        src.negate = swizzle.negate_src1 != 0;
+        src.selector = {static_cast<u8>(swizzle.src1_selector_0.Value()),
+                        static_cast<u8>(swizzle.src1_selector_1.Value()),
+                        static_cast<u8>(swizzle.src1_selector_2.Value()),
+                        static_cast<u8>(swizzle.src1_selector_3.Value())};
+        break;
+    case 2:
+        src.negate = swizzle.negate_src2 != 0;
+        src.selector = {static_cast<u8>(swizzle.src2_selector_0.Value()),
+                        static_cast<u8>(swizzle.src2_selector_1.Value()),
+                        static_cast<u8>(swizzle.src2_selector_2.Value()),
+                        static_cast<u8>(swizzle.src2_selector_3.Value())};
+        break;
+    default:
+        src.negate = swizzle.negate_src3 != 0;
+        src.selector = {static_cast<u8>(swizzle.src3_selector_0.Value()),
+                        static_cast<u8>(swizzle.src3_selector_1.Value()),
+                        static_cast<u8>(swizzle.src3_selector_2.Value()),
+                        static_cast<u8>(swizzle.src3_selector_3.Value())};
+        break;
+    }
+    return src;
+}
+
+template <typename DestField>
+void DecodeDest(CompiledShader::DecodedInstruction& decoded, const DestField& dest,
+                const SwizzlePattern& swizzle) {
+    if (dest.Value() < 0x10) {
+        decoded.dest_file = CompiledShader::RegisterFile::Output;
+        decoded.dest_index = static_cast<u8>(dest.Value().GetIndex());
+    } else if (dest.Value() < 0x20) {
+        decoded.dest_file = CompiledShader::RegisterFile::Temporary;
+        decoded.dest_index = static_cast<u8>(dest.Value().GetIndex());
+    } else {
+        decoded.dest_file = CompiledShader::RegisterFile::Dummy;
+        decoded.dest_index = 0;
+    }
+
+    decoded.dest_mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (swizzle.DestComponentEnabled(i)) {
+            decoded.dest_mask |= 1 << i;
+        }
+    }
+}
+
+CompiledShader::Operation GetArithmeticOperation(OpCode::Id opcode) {
+    using Operation = CompiledShader::Operation;
+    switch (opcode) {
+    case OpCode::Id::ADD:
+        return Operation::ADD;
+    case OpCode::Id::MUL:
+        return Operation::MUL;
+    case OpCode::Id::FLR:
+        return Operation::FLR;
+    case OpCode::Id::MAX:
+        return Operation::MAX;
+    case OpCode::Id::MIN:
+        return Operation::MIN;
+    case OpCode::Id::DP3:
+        return Operation::DP3;
+    case OpCode::Id::DP4:
+        return Operation::DP4;
+    case OpCode::Id::DPH:
+    case OpCode::Id::DPHI:
+        return Operation::DPH;
+    case OpCode::Id::RCP:
+        return Operation::RCP;
+    case OpCode::Id::RSQ:
+        return Operation::RSQ;
+    case OpCode::Id::MOVA:
+        return Operation::MOVA;
+    case OpCode::Id::MOV:
+        return Operation::MOV;
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+        return Operation::SGE;
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+        return Operation::SLT;
+    case OpCode::Id::CMP:
+        return Operation::CMP;
+    case OpCode::Id::EX2:
+        return Operation::EX2;
+    case OpCode::Id::LG2:
+        return Operation::LG2;
+    default:
+        return Operation::UnknownArithmetic;
+    }
+}
+
+CompiledShader::Operation GetFlowOperation(OpCode::Id opcode) {
+    using Operation = CompiledShader::Operation;
+    switch (opcode) {
+    case OpCode::Id::END:
+        return Operation::END;
+    case OpCode::Id::JMPC:
+        return Operation::JMPC;
+    case OpCode::Id::JMPU:
+        return Operation::JMPU;
+    case OpCode::Id::CALL:
+        return Operation::CALL;
+    case OpCode::Id::CALLU:
+        return Operation::CALLU;
+    case OpCode::Id::CALLC:
+        return Operation::CALLC;
+    case OpCode::Id::NOP:
+        return Operation::NOP;
+    case OpCode::Id::IFU:
+        return Operation::IFU;
+    case OpCode::Id::IFC:
+        return Operation::IFC;
+    case OpCode::Id::LOOP:
+        return Operation::LOOP;
+    case OpCode::Id::EMIT:
+        return Operation::EMIT;
+    case OpCode::Id::SETEMIT:
+        return Operation::SETEMIT;
+    default:
+        return Operation::Unknown;
+    }
+}
+
+CompiledShader::DecodedInstruction DecodeInstruction(
+    u32 hex, const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>& swizzle_data) {
+    using Operation = CompiledShader::Operation;
+
+    const nihstro::Instruction instr = {hex};
+    CompiledShader::DecodedInstruction decoded{};
+    decoded.hex = hex;
+
+    switch (instr.opcode.Value().GetInfo().type) {
+    case OpCode::Type::Arithmetic: {
+        const SwizzlePattern swizzle = {swizzle_data[instr.common.operand_desc_id]};
+        const bool is_inverted =
+            (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+
+        decoded.operation = GetArithmeticOperation(instr.opcode.Value().EffectiveOpCode());
+        decoded.address_register_index = static_cast<u8>(instr.common.address_register_index);
+        decoded.relative_source = decoded.address_register_index == 0 ? 0 : is_inverted ? 2 : 1;
+        decoded.src[0] = DecodeSource(instr.common.GetSrc1(is_inverted), swizzle, 1);
+        decoded.src[1] = DecodeSource(instr.common.GetSrc2(is_inverted), swizzle, 2);
+        DecodeDest(decoded, instr.common.dest, swizzle);
+        decoded.compare_op = {static_cast<u8>(instr.common.compare_op.x.Value()),
+                              static_cast<u8>(instr.common.compare_op.y.Value())};
+        break;
+    }
+
+    case OpCode::Type::MultiplyAdd: {
+        const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+        if (opcode != OpCode::Id::MAD && opcode != OpCode::Id::MADI) {
+            decoded.operation = Operation::UnknownMultiplyAdd;
+            break;
+        }
+
+        const SwizzlePattern swizzle = {swizzle_data[instr.mad.operand_desc_id]};
+        const bool is_inverted = opcode == OpCode::Id::MADI;
+
+        decoded.operation = Operation::MAD;
+        decoded.address_register_index = static_cast<u8>(instr.mad.address_register_index);
+        decoded.relative_source = decoded.address_register_index == 0 ? 0 : is_inverted ? 3 : 2;
+        decoded.src[0] = DecodeSource(instr.mad.GetSrc1(is_inverted), swizzle, 1);
+        decoded.src[1] = DecodeSource(instr.mad.GetSrc2(is_inverted), swizzle, 2);
+        decoded.src[2] = DecodeSource(instr.mad.GetSrc3(is_inverted), swizzle, 3);
+        DecodeDest(decoded, instr.mad.dest, swizzle);
+        break;
+    }
+
+    default:
+        decoded.operation = GetFlowOperation(instr.opcode.Value());
+        decoded.dest_offset = instr.flow_control.dest_offset;
+        decoded.num_instructions = instr.flow_control.num_instructions;
+        decoded.flow_op = static_cast<u8>(instr.flow_control.op.Value());
+        decoded.refx = instr.flow_control.refx.Value();
+        decoded.refy = instr.flow_control.refy.Value();
+        decoded.uniform_id = decoded.operation == Operation::LOOP
+                                 ? static_cast<u8>(instr.flow_control.int_uniform_id)
+                                 : static_cast<u8>(instr.flow_control.bool_uniform_id);
+        decoded.vertex_id = static_cast<u8>(instr.setemit.vertex_id);
+        decoded.prim_emit = instr.setemit.prim_emit != 0;
+        decoded.winding = instr.setemit.winding != 0;
+        break;
+    }
+
+    return decoded;
+}
+
+void LogUnknownInstruction(const char* kind, u32 hex) {
+    const nihstro::Instruction instr = {hex};
+    LOG_ERROR(HW_GPU, "Unhandled {}instruction: 0x{:02x} ({}): 0x{:08x}", kind,
+              static_cast<int>(instr.opcode.Value().EffectiveOpCode()),
+              instr.opcode.Value().GetInfo().name, hex);
+}
+
+} // Anonymous namespace
+
+CompiledShader::CompiledShader() = default;
+CompiledShader::~CompiledShader() = default;
+
+void CompiledShader::Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
+                             const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data) {
+    // Entry points and jump targets can be anywhere, so the whole program memory is decoded
+    instructions.clear();
+    instructions.reserve(MAX_PROGRAM_CODE_LENGTH + 1);
+    for (const u32 hex : *program_code) {
+        instructions.push_back(DecodeInstruction(hex, *swizzle_data));
+    }
+
+    DecodedInstruction end{};
+    end.operation = Operation::END;
+    instructions.push_back(end);
+}
+
+void CompiledShader::Run(const ShaderSetup& setup, UnitState& state, unsigned offset) const {
+    // TODO: Is there a maximal size for this?
+    boost::container::static_vector<CallStackElement, 16> call_stack;
+    u32 program_counter = offset;
+
+    state.conditional_code[0] = false;
+    state.conditional_code[1] = false;
+
+    const auto& uniforms = setup.uniforms;
+
+    // Placeholder for invalid inputs and outputs
+    Common::Vec4<float24> dummy = Common::Vec4<float24>::AssignToAll(float24::Zero());
+
+    // Indexed by RegisterFile
+    const std::array<const Common::Vec4<float24>*, 5> source_files = {
+        state.registers.input, state.registers.temporary, uniforms.f, state.registers.output,
+        &dummy};
+    const std::array<Common::Vec4<float24>*, 5> dest_files = {
+        nullptr, state.registers.temporary, nullptr, state.registers.output, &dummy};
+
+    const auto lookup_relative = [&](const DecodedSource& src,
+                                     int address_offset) -> const float24* {
+        // Same as adding the offset to the source register, except that registers past the
+        // uniforms read the placeholder instead of out of bounds
+        const s64 reg = s64{GetRegisterFileBase(src.file) + src.index} + address_offset;
+        if (reg >= 0 && reg < 0x10) {
+            return &state.registers.input[reg].x;
+        } else if (reg >= 0x10 && reg < 0x20) {
+            return &state.registers.temporary[reg - 0x10].x;
+        } else if (reg >= 0x20 && reg < 0x20 + static_cast<s64>(std::size(uniforms.f))) {
+            return &uniforms.f[reg - 0x20].x;
+        }
+        return &dummy.x;
+    };
+
+    const auto load = [&](const DecodedInstruction& instr, std::size_t i, float24(&value)[4]) {
+        const DecodedSource& src = instr.src[i];
+        const float24* reg;
+        if (instr.relative_source == i + 1) {
+            reg = lookup_relative(src, state.address_registers[instr.address_register_index - 1]);
+        } else {
+            reg = &source_files[static_cast<std::size_t>(src.file)][src.index].x;
+        }
+        for (std::size_t c = 0; c < 4; ++c) {
+            value[c] = reg[src.selector[c]];
+        }
+        if (src.negate) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                value[c] = -value[c];
+            }
+        }
+    };
+
+    const auto store = [&](const DecodedInstruction& instr, const float24(&value)[4]) {
+        float24* dest = &dest_files[static_cast<std::size_t>(instr.dest_file)][instr.dest_index].x;
+        for (std::size_t c = 0; c < 4; ++c) {
+            if (instr.dest_mask & (1 << c)) {
+                dest[c] = value[c];
+            }
+        }
+    };
+
+    const auto store_all = [&](const DecodedInstruction& instr, float24 value) {
+        const float24 values[4] = {value, value, value, value};
+        store(instr, values);
+    };
+
+    const auto call = [&program_counter, &call_stack](u32 offset, u32 num_instructions,
+                                                      u32 return_offset, u8 repeat_count,
+                                                      u8 loop_increment) {
+        // -1 to make sure when incrementing the PC we end up at the correct offset
+        program_counter = offset - 1;
+        ASSERT(call_stack.size() < call_stack.capacity());
+        call_stack.push_back(
+            {offset + num_instructions, return_offset, repeat_count, loop_increment, offset});
+    };
+
+    const auto evaluate_condition = [&state](const DecodedInstruction& instr) {
+        using Op = nihstro::Instruction::FlowControlType::Op;
+
+        const bool result_x = instr.refx == state.conditional_code[0];
+        const bool result_y = instr.refy == state.conditional_code[1];
+
+        switch (static_cast<Op>(instr.flow_op)) {
+        case Op::Or:
+            return result_x || result_y;
+        case Op::And:
+            return result_x && result_y;
+        case Op::JustX:
+            return result_x;
+        case Op::JustY:
+            return result_y;
+        default:
+            UNREACHABLE();
+            return false;
+        }
+    };
+
+    // Leaves the calls and loop iterations that end at the program counter
+    const auto leave_finished_blocks = [&program_counter, &call_stack, &state] {
+        while (!call_stack.empty() && program_counter == call_stack.back().final_address) {
+            auto& top = call_stack.back();
+            state.address_registers[2] += top.loop_increment;
+
+            if (top.repeat_counter-- == 0) {
+                program_counter = top.return_address;
+                call_stack.pop_back();
+            } else {
+                program_counter = top.loop_address;
+            }
+        }
+    };
+
+    const DecodedInstruction* instr;
+    float24 src1[4];
+    float24 src2[4];
+    float24 src3[4];
+    float24 result[4];
+
+#if defined __GNUC__ || defined __clang__
+#define OPERATION_LABEL(name) &&op_##name,
+    static const void* const operation_labels[] = {INTERPRETER_OPERATIONS(OPERATION_LABEL)};
+#undef OPERATION_LABEL
+#define GOTO_OPERATION(operation) goto* operation_labels[static_cast<std::size_t>(operation)]
+#else
+#define OPERATION_CASE(name)                                                                       \
+    case Operation::name:                                                                          \
+        goto op_##name;
+#define GOTO_OPERATION(operation)                                                                  \
+    switch (operation) { INTERPRETER_OPERATIONS(OPERATION_CASE) }
+#endif
+
+    // Program counters past the program memory, reachable by returning from the end of it, run
+    // the END placed after the program
+#define DISPATCH()                                                                                 \
+    leave_finished_blocks();                                                                       \
+    instr = &instructions[std::min<u32>(program_counter, MAX_PROGRAM_CODE_LENGTH)];                \
+    GOTO_OPERATION(instr->operation)
+
+#define NEXT()                                                                                     \
+    ++program_counter;                                                                             \
+    DISPATCH()
+
+    DISPATCH();
+
+op_ADD:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        result[i] = src1[i] + src2[i];
+    }
+    store(*instr, result);
+    NEXT();
+
+op_MUL:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        result[i] = src1[i] * src2[i];
+    }
+    store(*instr, result);
+    NEXT();
+
+op_FLR:
+    load(*instr, 0, src1);
+    for (int i = 0; i < 4; ++i) {
+        result[i] = float24::FromFloat32(std::floor(src1[i].ToFloat32()));
+    }
+    store(*instr, result);
+    NEXT();
+
+op_MAX:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        // NOTE: Exact form required to match NaN semantics to hardware:
+        //   max(0, NaN) -> NaN
+        //   max(NaN, 0) -> 0
+        result[i] = (src1[i] > src2[i]) ? src1[i] : src2[i];
+    }
+    store(*instr, result);
+    NEXT();
+
+op_MIN:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        // NOTE: Exact form required to match NaN semantics to hardware:
+        //   min(0, NaN) -> NaN
+        //   min(NaN, 0) -> 0
+        result[i] = (src1[i] < src2[i]) ? src1[i] : src2[i];
+    }
+    store(*instr, result);
+    NEXT();
+
+op_DP3:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    store_all(*instr, std::inner_product(src1, src1 + 3, src2, float24::FromFloat32(0.f)));
+    NEXT();
+
+op_DP4:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    store_all(*instr, std::inner_product(src1, src1 + 4, src2, float24::FromFloat32(0.f)));
+    NEXT();
+
+op_DPH:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    src1[3] = float24::FromFloat32(1.0f);
+    store_all(*instr, std::inner_product(src1, src1 + 4, src2, float24::FromFloat32(0.f)));
+    NEXT();
+
+op_RCP:
+    load(*instr, 0, src1);
+    store_all(*instr, float24::FromFloat32(1.0f / src1[0].ToFloat32()));
+    NEXT();
+
+op_RSQ:
+    load(*instr, 0, src1);
+    store_all(*instr, float24::FromFloat32(1.0f / std::sqrt(src1[0].ToFloat32())));
+    NEXT();
+
+op_MOVA:
+    load(*instr, 0, src1);
+    for (int i = 0; i < 2; ++i) {
+        if (instr->dest_mask & (1 << i)) {
+            // TODO: Figure out how the rounding is done on hardware
+            state.address_registers[i] = static_cast<s32>(src1[i].ToFloat32());
+        }
+    }
+    NEXT();
+
+op_MOV:
+    load(*instr, 0, src1);
+    store(*instr, src1);
+    NEXT();
+
+op_SGE:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        result[i] =
+            (src1[i] >= src2[i]) ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
+    }
+    store(*instr, result);
+    NEXT();
+
+op_SLT:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 4; ++i) {
+        result[i] = (src1[i] < src2[i]) ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
+    }
+    store(*instr, result);
+    NEXT();
+
+op_CMP:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    for (int i = 0; i < 2; ++i) {
+        using CompareOp = nihstro::Instruction::Common::CompareOpType::Op;
+        const auto op = static_cast<CompareOp>(instr->compare_op[i]);
+        switch (op) {
+        case CompareOp::Equal:
+            state.conditional_code[i] = (src1[i] == src2[i]);
+            break;
+
+        case CompareOp::NotEqual:
+            state.conditional_code[i] = (src1[i] != src2[i]);
+            break;
+
+        case CompareOp::LessThan:
+            state.conditional_code[i] = (src1[i] < src2[i]);
+            break;
+
+        case CompareOp::LessEqual:
+            state.conditional_code[i] = (src1[i] <= src2[i]);
+            break;
+
+        case CompareOp::GreaterThan:
+            state.conditional_code[i] = (src1[i] > src2[i]);
+            break;
+
+        case CompareOp::GreaterEqual:
+            state.conditional_code[i] = (src1[i] >= src2[i]);
+            break;
+
+        default:
+            LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", static_cast<int>(op));
+            break;
+        }
+    }
+    NEXT();
+
+op_EX2:
+    // EX2 only takes first component exp2 and writes it to all dest components
+    load(*instr, 0, src1);
+    store_all(*instr, float24::FromFloat32(std::exp2(src1[0].ToFloat32())));
+    NEXT();
+
+op_LG2:
+    // LG2 only takes the first component log2 and writes it to all dest components
+    load(*instr, 0, src1);
+    store_all(*instr, float24::FromFloat32(std::log2(src1[0].ToFloat32())));
+    NEXT();
+
+op_MAD:
+    load(*instr, 0, src1);
+    load(*instr, 1, src2);
+    load(*instr, 2, src3);
+    for (int i = 0; i < 4; ++i) {
+        result[i] = src1[i] * src2[i] + src3[i];
+    }
+    store(*instr, result);
+    NEXT();
+
+op_END:
+    return;
+
+op_JMPC:
+    if (evaluate_condition(*instr)) {
+        program_counter = instr->dest_offset - 1;
+    }
+    NEXT();
+
+op_JMPU:
+    if (uniforms.b[instr->uniform_id] == !(instr->num_instructions & 1)) {
+        program_counter = instr->dest_offset - 1;
+    }
+    NEXT();
+
+op_CALL:
+    call(instr->dest_offset, instr->num_instructions, program_counter + 1, 0, 0);
+    NEXT();
+
+op_CALLU:
+    if (uniforms.b[instr->uniform_id]) {
+        call(instr->dest_offset, instr->num_instructions, program_counter + 1, 0, 0);
+    }
+    NEXT();
+
+op_CALLC:
+    if (evaluate_condition(*instr)) {
+        call(instr->dest_offset, instr->num_instructions, program_counter + 1, 0, 0);
+    }
+    NEXT();
+
+op_NOP:
+    NEXT();
+
+op_IFU:
+    if (uniforms.b[instr->uniform_id]) {
+        call(program_counter + 1, instr->dest_offset - program_counter - 1,
+             instr->dest_offset + instr->num_instructions, 0, 0);
+    } else {
+        call(instr->dest_offset, instr->num_instructions,
+             instr->dest_offset + instr->num_instructions, 0, 0);
+    }
+    NEXT();
+
+op_IFC:
+    if (evaluate_condition(*instr)) {
+        call(program_counter + 1, instr->dest_offset - program_counter - 1,
+             instr->dest_offset + instr->num_instructions, 0, 0);
+    } else {
+        call(instr->dest_offset, instr->num_instructions,
+             instr->dest_offset + instr->num_instructions, 0, 0);
+    }
+    NEXT();
+
+op_LOOP: {
+    const auto& loop_param = uniforms.i[instr->uniform_id];
+    state.address_registers[2] = loop_param.y;
+    call(program_counter + 1, instr->dest_offset - program_counter, instr->dest_offset + 1,
+         loop_param.x, loop_param.z);
+    NEXT();
+}
+
+op_EMIT: {
+    GSEmitter* emitter = state.emitter_ptr;
+    ASSERT_MSG(emitter, "Execute EMIT on VS");
+    emitter->Emit(state.registers.output);
+    NEXT();
+}
+
+op_SETEMIT: {
+    GSEmitter* emitter = state.emitter_ptr;
+    ASSERT_MSG(emitter, "Execute SETEMIT on VS");
+    emitter->vertex_id = instr->vertex_id;
+    emitter->prim_emit = instr->prim_emit;
+    emitter->winding = instr->winding;
+    NEXT();
+}
+
+op_UnknownArithmetic:
+    LogUnknownInstruction("arithmetic ", instr->hex);
+    DEBUG_ASSERT(false);
+    NEXT();
+
+op_UnknownMultiplyAdd:
+    LogUnknownInstruction("multiply-add ", instr->hex);
+    NEXT();
+
+op_Unknown:
+    LogUnknownInstruction("", instr->hex);
+    NEXT();
+
+#undef NEXT
+#undef DISPATCH
+#undef GOTO_OPERATION
+#undef OPERATION_CASE
+}
+
+#undef INTERPRETER_OPERATIONS
+
+} // namespace Pica::Shader
@@ -0,0 +1,83 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica::Shader {
+
+/**
+ * Shader program decoded once for the interpreter. Operand locations, swizzles, negation and
+ * destination masks are resolved ahead of time, so running a vertex only dispatches on a small
+ * operation index, with computed gotos where the compiler supports them.
+ */
+class CompiledShader {
+public:
+    CompiledShader();
+    ~CompiledShader();
+
+    void Compile(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>* program_code,
+                 const std::array<u32, MAX_SWIZZLE_DATA_LENGTH>* swizzle_data);
+
+    void Run(const ShaderSetup& setup, UnitState& state, unsigned offset) const;
+
+    /// Operations of decoded instructions. Related opcodes (DPH and DPHI...) share one.
+    enum class Operation : u8;
+
+    /// Register file an operand is read from or written to
+    enum class RegisterFile : u8 {
+        Input,
+        Temporary,
+        FloatUniform,
+        Output,
+        Dummy,
+    };
+
+    struct DecodedSource {
+        RegisterFile file;
+        u8 index;
+        bool negate;
+        std::array<u8, 4> selector;
+    };
+
+    struct DecodedInstruction {
+        Operation operation;
+        /// Source read relative to an address register (1 to 3), or 0 if none is
+        u8 relative_source;
+        /// Address register added to the relative source, 3 being the loop counter
+        u8 address_register_index;
+        /// Components written to the destination, bit i for component i
+        u8 dest_mask;
+        RegisterFile dest_file;
+        u8 dest_index;
+        std::array<u8, 2> compare_op;
+        std::array<DecodedSource, 3> src;
+
+        // Flow control
+        u32 dest_offset;
+        u32 num_instructions;
+        u8 flow_op;
+        bool refx;
+        bool refy;
+        u8 uniform_id;
+
+        // SETEMIT
+        u8 vertex_id;
+        bool prim_emit;
+        bool winding;
+
+        /// Original instruction word, for relative sources and error messages
+        u32 hex;
+    };
+
+private:
+    /// One more than the program length, so running past its end reaches an END
+    std::vector<DecodedInstruction> instructions;
+};
+
+} // namespace Pica::Shader
@@ -9,6 +9,7 @@
 #include "video_core/pica.h"
 #include "video_core/pica_state.h"
 #include "video_core/renderer_base.h"
+#include "video_core/renderer_null/renderer_null.h"
 #include "video_core/renderer_opengl/gl_vars.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
 #include "video_core/video_core.h"
@@ -43,9 +44,17 @@ ResultStatus Init(Frontend::EmuWindow& emu_window, Memory::MemorySystem& memory)
     g_memory = &memory;
     Pica::Init();
 
-    OpenGL::GLES = Settings::values.use_gles;
+    switch (Settings::values.graphics_api) {
+    case Settings::GraphicsAPI::Null:
+        g_renderer = std::make_unique<RendererNull>(emu_window);
+        break;
+    case Settings::GraphicsAPI::OpenGL:
+    default:
+        OpenGL::GLES = Settings::values.use_gles;
+        g_renderer = std::make_unique<OpenGL::RendererOpenGL>(emu_window);
+        break;
+    }
 
-    g_renderer = std::make_unique<OpenGL::RendererOpenGL>(emu_window);
     ResultStatus result = g_renderer->Init();
 
     if (result != ResultStatus::Success) {